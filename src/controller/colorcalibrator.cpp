@@ -17,6 +17,7 @@
 #include "./image/image_gphoto.h"
 #include "./utils/log.h"
 #include "./utils/scope_guard.h"
+#include "./utils/thread_pool.h"
 #include "./utils/timer.h"
 
 #define MAX_SHUTTERSPEED_ITERATION_COUNT 10
@@ -45,6 +46,12 @@ ColorCalibrator::ColorCalibrator(RootObject* root)
     equalizeWhiteBalances = std::bind(&ColorCalibrator::equalizeWhiteBalancesMaximizeMinLum, this);
 }
 
+/*************/
+ColorCalibrator::~ColorCalibrator()
+{
+    ThreadPool::get().wait(_calibrationThread);
+}
+
 /*************/
 bool ColorCalibrator::linkIt(const std::shared_ptr<GraphObject>& obj)
 {
@@ -86,10 +93,9 @@ void ColorCalibrator::update()
         return;
     }
 
-    if (_calibrationThread.valid())
-        _calibrationThread.wait();
+    ThreadPool::get().wait(_calibrationThread);
 
-    _calibrationThread = std::async(std::launch::async, [&]() {
+    _calibrationThread = ThreadPool::get().submit([&]() {
 
         OnScopeExit
         {
@@ -274,10 +280,9 @@ void ColorCalibrator::updateCRF()
         return;
     }
 
-    if (_calibrationThread.valid())
-        _calibrationThread.wait();
+    ThreadPool::get().wait(_calibrationThread);
 
-    _calibrationThread = std::async(std::launch::async, [&]() {
+    _calibrationThread = ThreadPool::get().submit([&]() {
 
         OnScopeExit
         {
@@ -53,9 +53,9 @@ class ColorCalibrator final : public ControllerObject
     explicit ColorCalibrator(RootObject* root);
 
     /**
-     * Destructor
+     * Destructor, waiting for the calibration to finish
      */
-    ~ColorCalibrator() final = default;
+    ~ColorCalibrator() final;
 
     /**
      * Constructors/operators
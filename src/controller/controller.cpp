@@ -132,6 +132,19 @@ Values ControllerObject::getObjectAttribute(const std::string& name, const std::
 {
     auto tree = _root->getTree();
 
+    // Try the leaf found by a previous call first
+    {
+        std::lock_guard<std::mutex> lockHandles(_leafHandlesMutex);
+        auto objectIt = _objectAttributeLeafHandles.find(name);
+        if (objectIt != _objectAttributeLeafHandles.end())
+        {
+            auto handleIt = objectIt->second.find(attr);
+            Value value;
+            if (handleIt != objectIt->second.end() && tree->getValueForLeaf(handleIt->second, value))
+                return value.as<Values>();
+        }
+    }
+
     for (const auto& rootName : tree->getBranchList())
     {
         Value value;
@@ -139,6 +152,9 @@ Values ControllerObject::getObjectAttribute(const std::string& name, const std::
         if (!tree->hasLeafAt(attrPath))
             continue;
         tree->getValueForLeafAt(attrPath, value);
+
+        std::lock_guard<std::mutex> lockHandles(_leafHandlesMutex);
+        _objectAttributeLeafHandles[name][attr] = Tree::LeafHandle(attrPath);
         return value.as<Values>();
     }
 
@@ -357,11 +373,15 @@ void ControllerObject::setInScene(const std::string& name, const Values& values)
 Values ControllerObject::getWorldAttribute(const std::string& attr) const
 {
     auto tree = _root->getTree();
-    auto attrPath = "/world/attributes/" + attr;
-    if (!tree->hasLeafAt(attrPath))
-        return {};
+
+    std::lock_guard<std::mutex> lockHandles(_leafHandlesMutex);
+    auto handleIt = _worldAttributeLeafHandles.find(attr);
+    if (handleIt == _worldAttributeLeafHandles.end())
+        handleIt = _worldAttributeLeafHandles.emplace(attr, Tree::LeafHandle("/world/attributes/" + attr)).first;
+
     Value value;
-    tree->getValueForLeafAt(attrPath, value);
+    if (!tree->getValueForLeaf(handleIt->second, value))
+        return {};
     return value.as<Values>();
 }
 
@@ -26,7 +26,9 @@
 #define SPLASH_CONTROLLER_H
 
 #include <chrono>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "./core/constants.h"
@@ -245,6 +247,12 @@ class ControllerObject : public GraphObject
      * Register new functors to modify attributes
      */
     void registerAttributes() { GraphObject::registerAttributes(); }
+
+  private:
+    // Handles to the leaves read by getObjectAttribute and getWorldAttribute, so that their paths are resolved only once
+    mutable std::mutex _leafHandlesMutex{};
+    mutable std::unordered_map<std::string, std::unordered_map<std::string, Tree::LeafHandle>> _objectAttributeLeafHandles{};
+    mutable std::unordered_map<std::string, Tree::LeafHandle> _worldAttributeLeafHandles{};
 };
 
 /*************/
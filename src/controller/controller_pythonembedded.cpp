@@ -1084,6 +1084,12 @@ PyObject* PythonEmbedded::pythonInitSplash()
     Py_INCREF(&PythonSink::pythonSinkType);
     PyModule_AddObject(module, "Sink", (PyObject*)&PythonSink::pythonSinkType);
 
+    if (PyType_Ready(&PythonSink::pythonSinkFrameType) < 0)
+    {
+        Log::get() << Log::WARNING << "PythonEmbedded::" << __FUNCTION__ << " - Sink frame type is not ready" << Log::endl;
+        return nullptr;
+    }
+
     SplashError = PyErr_NewException((const char*)"splash.error", PyExc_Exception, nullptr);
     if (SplashError)
     {
@@ -12,6 +12,7 @@
 
 #include "./image/image.h"
 #include "./controller/texcoordgenerator.h"
+#include "./utils/thread_pool.h"
 
 using namespace std::chrono;
 
@@ -32,6 +33,7 @@ GeometricCalibrator::~GeometricCalibrator()
 {
     _abortCalibration = true;
     _finalizeCalibration = true;
+    ThreadPool::get().wait(_calibrationFuture);
 }
 
 /*************/
@@ -50,7 +52,7 @@ void GeometricCalibrator::calibrate()
     }
 
     _running = true;
-    _calibrationFuture = std::async(std::launch::async, [=]() {
+    _calibrationFuture = ThreadPool::get().submit([=]() {
         const auto state = saveCurrentState();
         setupCalibrationState(state);
         const auto params = calibrationFunc(state);
@@ -27,7 +27,6 @@ void PythonSink::pythonSinkDealloc(PythonSinkObject* self)
         that->setInScene("deleteObject", {*self->sinkName});
     }
 
-    Py_XDECREF(self->lastBuffer);
     Py_TYPE(self)->tp_free((PyObject*)self);
 }
 
@@ -70,7 +69,7 @@ int PythonSink::pythonSinkInit(PythonSinkObject* self, PyObject* args, PyObject*
     self->framerate = 30;
     self->linked = false;
     self->opened = false;
-    self->lastBuffer = nullptr;
+    self->lastTimestamp = 0;
     self->sixteenBpc = false;
 
     auto index = self->sinkIndex.fetch_add(1);
@@ -249,14 +248,80 @@ PyObject* PythonSink::pythonSinkUnlink(PythonSinkObject* self)
     return Py_True;
 }
 
+/*************/
+std::shared_ptr<const Sink::Frame> PythonSink::waitForFrame(PythonSinkObject* self, uint64_t timestamp, chrono::microseconds timeout)
+{
+    auto sink = self->sink;
+    std::shared_ptr<const Sink::Frame> frame{nullptr};
+    const auto deadline = chrono::steady_clock::now() + timeout;
+
+    Py_BEGIN_ALLOW_THREADS;
+    // Due to the asynchronicity of passing messages to Splash, the sink may not be opened yet, and
+    // frames may still be at a wrong resolution if set_size was called. These frames are skipped
+    while (true)
+    {
+        const auto now = chrono::steady_clock::now();
+        if (now >= deadline)
+            break;
+
+        frame = sink->waitForFrame(timestamp, chrono::duration_cast<chrono::microseconds>(deadline - now));
+        if (!frame || frame->spec.rawSize() == sink->getSpec().rawSize())
+            break;
+
+        timestamp = frame->timestamp;
+        frame.reset();
+    }
+    Py_END_ALLOW_THREADS;
+
+    return frame;
+}
+
+/*************/
+PyObject* PythonSink::frameToMemoryView(PythonSinkObject* self, const std::shared_ptr<const Sink::Frame>& frame)
+{
+    auto frameObject = PyObject_New(PythonSinkFrameObject, &pythonSinkFrameType);
+    if (!frameObject)
+        return nullptr;
+    new (&frameObject->frame) std::shared_ptr<const Sink::Frame>(frame);
+
+    // Channels are exposed as unsigned 8 or 16 bits integers, otherwise pixels are exposed as bytes
+    const auto& spec = frame->spec;
+    const auto pixelBytes = static_cast<Py_ssize_t>(spec.pixelBytes());
+    auto channels = static_cast<Py_ssize_t>(std::max<uint32_t>(spec.channels, 1));
+    if (pixelBytes % channels != 0 || (pixelBytes / channels != 1 && pixelBytes / channels != 2))
+        channels = pixelBytes;
+
+    frameObject->shape[0] = spec.height;
+    frameObject->shape[1] = spec.width;
+    frameObject->shape[2] = channels;
+    frameObject->strides[0] = spec.width * pixelBytes;
+    frameObject->strides[1] = pixelBytes;
+    frameObject->strides[2] = pixelBytes / channels;
+
+    if (self->keepRatio)
+    {
+        self->width = spec.width;
+        self->height = spec.height;
+    }
+    self->lastTimestamp = frame->timestamp;
+
+    // The memoryview holds the frame object, which holds the frame and keeps the sink from reusing its buffer
+    auto memoryView = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(frameObject));
+    Py_DECREF(frameObject);
+    return memoryView;
+}
+
 /*************/
 PyDoc_STRVAR(pythonSinkGrab_doc__,
     "Grab the latest image from the sink\n"
     "\n"
     "splash.grab()\n"
     "\n"
+    "The image is not copied: the sink does not reuse its buffer as long as the returned memoryview is alive,\n"
+    "and skips frames if too many images are held. Use memoryview.release() or copy the image to keep it longer.\n"
+    "\n"
     "Returns:\n"
-    "  The grabbed image as a bytes object\n"
+    "  The grabbed image as a read-only memoryview, shaped as (height, width, channels)\n"
     "\n"
     "Raises:\n"
     "  splash.error: if Splash instance is not available");
@@ -277,55 +342,47 @@ PyObject* PythonSink::pythonSinkGrab(PythonSinkObject* self)
     if (!self->opened)
         return Py_BuildValue("");
 
-    // The Sink wrapper can be opened although its Splash counterpart has not
-    // received the order yet. We wait for that
-    Values opened({Value(false)});
-    while (!opened[0].as<bool>())
-    {
-        self->sink->getAttribute("opened", opened);
-        std::this_thread::sleep_for(chrono::milliseconds(5));
-    }
+    auto frame = waitForFrame(self, 0, _grabTimeout);
+    if (!frame)
+        return Py_BuildValue("");
 
-    // Due to the asynchronicity of passing messages to Splash, the frame may still
-    // be at a wrong resolution if set_size was called. We test for this case.
-    PyObject* buffer = nullptr;
-    int triesLeft = _maxSinkCreationTries;
-    while (triesLeft)
-    {
-        auto frame = self->sink->getBuffer();
-        uint64_t size = self->sink->getSpec().rawSize();
-
-        if (frame.size() != size)
-        {
-            --triesLeft;
-            std::this_thread::sleep_for(chrono::milliseconds(5));
-            // Keeping the ratio may also have some effects
-            if (self->keepRatio)
-            {
-                auto realSize = that->getObjectAttribute(*self->sinkName, "captureSize");
-                self->width = realSize[0].as<int>();
-                self->height = realSize[1].as<int>();
-            }
-        }
-        else
-        {
-            buffer = PyByteArray_FromStringAndSize(reinterpret_cast<char*>(frame.data()), frame.size());
-            break;
-        }
-    }
+    return frameToMemoryView(self, frame);
+}
 
-    if (!buffer)
+/*************/
+PyDoc_STRVAR(pythonSinkGrabNext_doc__,
+    "Grab the next image from the sink, waiting for it if the latest one has already been grabbed\n"
+    "\n"
+    "splash.grab_next(timeout=1.0)\n"
+    "\n"
+    "Args:\n"
+    "  timeout (float): Maximum waiting time, in seconds\n"
+    "\n"
+    "Returns:\n"
+    "  The grabbed image as a read-only memoryview shaped as (height, width, channels), or None if no image came in time\n"
+    "\n"
+    "Raises:\n"
+    "  splash.error: if Splash instance is not available");
+
+PyObject* PythonSink::pythonSinkGrabNext(PythonSinkObject* self, PyObject* args, PyObject* kwds)
+{
+    auto that = PythonEmbedded::getInstance();
+    if (!that)
         return Py_BuildValue("");
 
-    PyObject* tmp = nullptr;
-    if (self->lastBuffer != nullptr)
-        tmp = self->lastBuffer;
-    self->lastBuffer = buffer;
-    if (tmp != nullptr)
-        Py_XDECREF(tmp);
+    double timeout = 1.0;
+    static char* kwlist[] = {(char*)"timeout", nullptr};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|d", kwlist, &timeout))
+        return nullptr;
 
-    Py_INCREF(self->lastBuffer);
-    return self->lastBuffer;
+    if (!self->sink || !self->opened)
+        return Py_BuildValue("");
+
+    auto frame = waitForFrame(self, self->lastTimestamp, chrono::microseconds(static_cast<int64_t>(std::max(timeout, 0.0) * 1e6)));
+    if (!frame)
+        return Py_BuildValue("");
+
+    return frameToMemoryView(self, frame);
 }
 
 /*************/
@@ -545,13 +602,6 @@ PyObject* PythonSink::pythonSinkClose(PythonSinkObject* self)
     that->setObjectAttribute(*self->sinkName, "opened", {false});
     self->opened = false;
 
-    PyObject* tmp = nullptr;
-    if (self->lastBuffer != nullptr)
-        tmp = self->lastBuffer;
-    self->lastBuffer = nullptr;
-    if (tmp != nullptr)
-        Py_XDECREF(tmp);
-
     Py_INCREF(Py_True);
     return Py_True;
 }
@@ -653,10 +703,50 @@ PyObject* PythonSink::pythonSinkGetSixteenBpc(PythonSinkObject* self)
     return Py_BuildValue("b", sixteenBpc[0].as<int>());
 }
 
+/****************************/
+// Sink frame Python wrapper //
+/****************************/
+void PythonSink::pythonSinkFrameDealloc(PythonSinkFrameObject* self)
+{
+    using FramePtr = std::shared_ptr<const Sink::Frame>;
+    self->frame.~FramePtr();
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+/*************/
+int PythonSink::pythonSinkFrameGetBuffer(PythonSinkFrameObject* self, Py_buffer* view, int flags)
+{
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+    {
+        PyErr_SetString(PyExc_BufferError, "Sink frames are read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+
+    // Without PyBUF_ND the consumer expects a simple buffer, which is seen as a 1-D array of bytes.
+    // Otherwise the frame is exposed as height, width and channels, with 16-bit channels for 16bpc frames
+    const bool isSimple = (flags & PyBUF_ND) != PyBUF_ND;
+    const auto itemSize = isSimple ? 1 : self->strides[2];
+    view->obj = reinterpret_cast<PyObject*>(self);
+    Py_INCREF(view->obj);
+    view->buf = const_cast<uint8_t*>(self->frame->pixels);
+    view->len = self->shape[0] * self->strides[0];
+    view->readonly = 1;
+    view->itemsize = itemSize;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(itemSize == 2 ? "H" : "B") : nullptr;
+    view->ndim = isSimple ? 1 : 3;
+    view->shape = isSimple ? nullptr : self->shape;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
 // clang-format off
 /*************/
 PyMethodDef PythonSink::SinkMethods[] = {
     {(const char*)"grab", (PyCFunction)PythonSink::pythonSinkGrab, METH_NOARGS, pythonSinkGrab_doc__},
+    {(const char*)"grab_next", (PyCFunction)PythonSink::pythonSinkGrabNext, METH_VARARGS | METH_KEYWORDS, pythonSinkGrabNext_doc__},
     {(const char*)"set_size", (PyCFunction)PythonSink::pythonSinkSetSize, METH_VARARGS | METH_KEYWORDS, pythonSinkSetSize_doc__},
     {(const char*)"get_size", (PyCFunction)PythonSink::pythonSinkGetSize, METH_VARARGS | METH_KEYWORDS, pythonSinkGetSize_doc__},
     {(const char*)"set_framerate", (PyCFunction)PythonSink::pythonSinkSetFramerate, METH_VARARGS | METH_KEYWORDS, pythonSinkSetFramerate_doc__},
@@ -725,6 +815,37 @@ PyTypeObject PythonSink::pythonSinkType = {
     0                                                    /* tp_vectorcall */
     #endif
 };
+
+/*************/
+PyBufferProcs PythonSink::pythonSinkFrameBufferProcs = {
+    (getbufferproc)PythonSink::pythonSinkFrameGetBuffer, /* bf_getbuffer */
+    0                                                    /* bf_releasebuffer */
+};
+
+/*************/
+PyTypeObject PythonSink::pythonSinkFrameType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    (const char*) "splash.SinkFrame",                    /* tp_name */
+    sizeof(PythonSinkFrameObject),                       /* tp_basicsize */
+    0,                                                   /* tp_itemsize */
+    (destructor)PythonSink::pythonSinkFrameDealloc,      /* tp_dealloc */
+    0,                                                   /* tp_print */
+    0,                                                   /* tp_getattr */
+    0,                                                   /* tp_setattr */
+    0,                                                   /* tp_reserved */
+    0,                                                   /* tp_repr */
+    0,                                                   /* tp_as_number */
+    0,                                                   /* tp_as_sequence */
+    0,                                                   /* tp_as_mapping */
+    0,                                                   /* tp_hash  */
+    0,                                                   /* tp_call */
+    0,                                                   /* tp_str */
+    0,                                                   /* tp_getattro */
+    0,                                                   /* tp_setattro */
+    &PythonSink::pythonSinkFrameBufferProcs,             /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                                  /* tp_flags */
+    (const char*)"Splash Sink frame, exposed through the buffer protocol", /* tp_doc */
+};
 // clang-format on
 
 } // namespace Splash
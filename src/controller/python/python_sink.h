@@ -26,6 +26,7 @@
 #define SPLASH_PYTHON_SINK_H
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 
 #include <Python.h>
@@ -54,7 +55,16 @@ class PythonSink
         bool linked;
         bool opened;
         bool sixteenBpc;
-        PyObject* lastBuffer;
+        uint64_t lastTimestamp; // Timestamp of the last grabbed frame
+    };
+
+    // Grabbed frame, exposing its pixels through the buffer protocol without copying them
+    struct PythonSinkFrameObject
+    {
+        PyObject_HEAD
+        std::shared_ptr<const Splash::Sink::Frame> frame;
+        Py_ssize_t shape[3];
+        Py_ssize_t strides[3];
     };
     // clang-format on
     PythonSinkObject pythonSinkObject;
@@ -66,6 +76,7 @@ class PythonSink
     static PyObject* pythonSinkLink(PythonSinkObject* self, PyObject* args, PyObject* kwds);
     static PyObject* pythonSinkUnlink(PythonSinkObject* self);
     static PyObject* pythonSinkGrab(PythonSinkObject* self);
+    static PyObject* pythonSinkGrabNext(PythonSinkObject* self, PyObject* args, PyObject* kwds);
     static PyObject* pythonSinkSetSize(PythonSinkObject* self, PyObject* args, PyObject* kwds);
     static PyObject* pythonSinkGetSize(PythonSinkObject* self);
     static PyObject* pythonSinkKeepRatio(PythonSinkObject* self, PyObject* args, PyObject* kwds);
@@ -76,11 +87,35 @@ class PythonSink
     static PyObject* pythonSinkSetSixteenBpc(PythonSinkObject* self, PyObject* args, PyObject* kwds);
     static PyObject* pythonSinkGetSixteenBpc(PythonSinkObject* self);
 
+    // Frame wrapper methods
+    static void pythonSinkFrameDealloc(PythonSinkFrameObject* self);
+    static int pythonSinkFrameGetBuffer(PythonSinkFrameObject* self, Py_buffer* view, int flags);
+
     static PyMethodDef SinkMethods[];
     static PyTypeObject pythonSinkType;
+    static PyBufferProcs pythonSinkFrameBufferProcs;
+    static PyTypeObject pythonSinkFrameType;
 
   private:
     static const uint32_t _maxSinkCreationTries = 200;
+    static constexpr std::chrono::milliseconds _grabTimeout{1000};
+
+    /**
+     * Wait for a frame newer than the given timestamp, at the current size of the sink. The GIL is released meanwhile
+     * \param self Sink wrapper
+     * \param timestamp Timestamp of the last frame received, in us
+     * \param timeout Maximum waiting time
+     * \return Return the frame, or nullptr if none came in time
+     */
+    static std::shared_ptr<const Sink::Frame> waitForFrame(PythonSinkObject* self, uint64_t timestamp, std::chrono::microseconds timeout);
+
+    /**
+     * Wrap a frame into a read-only memoryview, shaped as height, width and channels
+     * \param self Sink wrapper
+     * \param frame Frame to wrap
+     * \return Return a new reference to the memoryview, or nullptr
+     */
+    static PyObject* frameToMemoryView(PythonSinkObject* self, const std::shared_ptr<const Sink::Frame>& frame);
 };
 
 } // namespace Splash
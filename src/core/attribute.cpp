@@ -7,6 +7,7 @@ namespace Splash
 {
 
 std::atomic_uint CallbackHandle::_nextCallbackId{1};
+std::atomic_uint64_t Attribute::_nextVersion{1};
 
 /*************/
 CallbackHandle::~CallbackHandle()
@@ -58,6 +59,8 @@ Attribute& Attribute::operator=(Attribute&& a) noexcept
         _syncMethod = a._syncMethod;
         _callbacks = std::move(a._callbacks);
         _isLocked = a._isLocked;
+        _isVolatile = a._isVolatile;
+        _version = a._version;
     }
 
     return *this;
@@ -94,6 +97,7 @@ bool Attribute::operator()(const Values& args)
     }
 
     const auto returnValue =  _setFunc(args);
+    _version = _nextVersion.fetch_add(1);
 
     // Run all set callbacks
     if (!_callbacks.empty())
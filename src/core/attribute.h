@@ -215,7 +215,35 @@ class Attribute
      */
     void setSyncMethod(const Sync& method) { _syncMethod = method; }
 
+    /**
+     * Get the version of the attribute, which is updated each time the setter is called.
+     * Versions are taken from a process-wide counter, so they can be compared between attributes
+     * \return Return the attribute version
+     */
+    uint64_t getVersion() const { return _version; }
+
+    /**
+     * Get the latest version given to any attribute
+     * \return Return the latest attribute version
+     */
+    static uint64_t getLatestVersion() { return _nextVersion.load() - 1; }
+
+    /**
+     * Get whether the value returned by the getter can change without the setter being called.
+     * Attributes with a getter but no setter are always considered volatile
+     * \return Return true if the attribute is volatile
+     */
+    bool isVolatile() const { return _isVolatile || !_setFunc; }
+
+    /**
+     * Set whether the value returned by the getter can change without the setter being called
+     * \param isVolatile If true, the attribute is considered volatile
+     */
+    void setVolatile(bool isVolatile) { _isVolatile = isVolatile; }
+
   private:
+    static std::atomic_uint64_t _nextVersion;
+
     std::mutex _callbackMutex{};
 
     std::string _name{"noname"};        // Name of the attribute
@@ -226,9 +254,11 @@ class Attribute
     std::function<bool(const Values&)> _setFunc{}; // Setter function
     std::function<const Values()> _getFunc{};      // Getter function
 
-    Sync _syncMethod{Sync::auto_sync};         // Synchronization to consider while setting this attribute
-    std::map<uint32_t, Callback> _callbacks{}; // Callbacks invoked when attribute is modified
-    bool _isLocked{false};                     // If true, the setter can not be invoked
+    Sync _syncMethod{Sync::auto_sync};            // Synchronization to consider while setting this attribute
+    std::map<uint32_t, Callback> _callbacks{};    // Callbacks invoked when attribute is modified
+    bool _isLocked{false};                        // If true, the setter can not be invoked
+    bool _isVolatile{false};                      // If true, the getter value can change without the setter being called
+    uint64_t _version{_nextVersion.fetch_add(1)}; // Version of the attribute, updated each time the setter is called
 };
 
 } // namespace Splash
@@ -3,10 +3,25 @@
 #include <algorithm>
 
 #include "./utils/log.h"
+#include "./utils/thread_pool.h"
 
 namespace Splash
 {
 
+/*************/
+BaseObject::~BaseObject()
+{
+    // Contrary to the ones from std::async, the futures from the thread pool do not wait for their task when destroyed
+    std::map<uint32_t, std::future<void>> asyncTasks;
+    {
+        std::lock_guard<std::mutex> lockTasks(_asyncTaskMutex);
+        std::swap(asyncTasks, _asyncTasks);
+    }
+
+    for (auto& task : asyncTasks)
+        ThreadPool::get().wait(task.second);
+}
+
 /*************/
 void BaseObject::addTask(const std::function<void()>& task)
 {
@@ -130,12 +145,37 @@ Attribute::Sync BaseObject::getAttributeSyncMethod(const std::string& name)
         return Attribute::Sync::auto_sync;
 }
 
+/*************/
+std::vector<std::pair<std::string, std::optional<Values>>> BaseObject::getModifiedAttributes(bool all)
+{
+    std::unique_lock<std::recursive_mutex> lock(_attribMutex);
+    std::vector<std::pair<std::string, std::optional<Values>>> attributes;
+
+    // Attributes set after this point will be returned during the next call
+    const auto latestVersion = Attribute::getLatestVersion();
+    for (const auto& [name, attribute] : _attribFunctions)
+    {
+        if (!attribute.hasGetter())
+            continue;
+        if (all || attribute.isVolatile() || attribute.getVersion() > _attribSyncVersion)
+            attributes.emplace_back(name, attribute());
+    }
+    _attribSyncVersion = latestVersion;
+
+    for (const auto& name : _removedAttributes)
+        if (_attribFunctions.find(name) == _attribFunctions.end())
+            attributes.emplace_back(name, std::nullopt);
+    _removedAttributes.clear();
+
+    return attributes;
+}
+
 /*************/
 void BaseObject::runAsyncTask(const std::function<void(void)>& func)
 {
     std::lock_guard<std::mutex> lockTasks(_asyncTaskMutex);
     auto taskId = _nextAsyncTaskId++;
-    _asyncTasks[taskId] = std::async(std::launch::async, [this, func, taskId]() -> void {
+    _asyncTasks[taskId] = ThreadPool::get().submit([this, func, taskId]() -> void {
         func();
         addTask([this, taskId]() -> void {
             std::lock_guard<std::mutex> lockTasks(_asyncTaskMutex);
@@ -201,13 +241,25 @@ void BaseObject::setAttributeSyncMethod(const std::string& name, const Attribute
         attr->second.setSyncMethod(method);
 }
 
+/*************/
+void BaseObject::setAttributeVolatile(const std::string& name, bool isVolatile)
+{
+    std::unique_lock<std::recursive_mutex> lock(_attribMutex);
+    auto attr = _attribFunctions.find(name);
+    if (attr != _attribFunctions.end())
+        attr->second.setVolatile(isVolatile);
+}
+
 /*************/
 void BaseObject::removeAttribute(const std::string& name)
 {
     std::unique_lock<std::recursive_mutex> lock(_attribMutex);
     auto attr = _attribFunctions.find(name);
     if (attr != _attribFunctions.end())
+    {
         _attribFunctions.erase(attr);
+        _removedAttributes.push_back(name);
+    }
 }
 
 /*************/
@@ -60,9 +60,9 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
     BaseObject() { registerAttributes(); }
 
     /**
-     * Destructor.
+     * Destructor, waiting for the asynchronous tasks to finish
      */
-    virtual ~BaseObject() = default;
+    virtual ~BaseObject();
 
     /**
      * Set the name of the object.
@@ -127,6 +127,16 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     Attribute::Sync getAttributeSyncMethod(const std::string& name);
 
+    /**
+     * Get the values of the attributes which have been set since the last call to this method,
+     * as well as the values of the volatile attributes. Attributes removed since the last call
+     * are returned with no value. The first call returns all the attributes.
+     * Only attributes with a getter are considered.
+     * \param all If true, return all the attributes regardless of their version
+     * \return Return a list of attribute names and values
+     */
+    std::vector<std::pair<std::string, std::optional<Values>>> getModifiedAttributes(bool all = false);
+
     /**
      * Register a callback to any call to the setter
      * \param attr Attribute to add a callback to
@@ -151,7 +161,9 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
     std::string _name{""};                               //!< Object name
     DenseMap<std::string, Attribute> _attribFunctions{}; //!< Map of all attributes
     mutable std::recursive_mutex _attribMutex;
-    bool _updatedParams{true}; //!< True if the parameters have been updated and the object needs to reflect these changes
+    bool _updatedParams{true};                     //!< True if the parameters have been updated and the object needs to reflect these changes
+    uint64_t _attribSyncVersion{0};                //!< Latest attribute version returned by getModifiedAttributes
+    std::vector<std::string> _removedAttributes{}; //!< Attributes removed since the last call to getModifiedAttributes
 
     uint32_t _nextAsyncTaskId{0};
     std::map<uint32_t, std::future<void>> _asyncTasks{};
@@ -221,6 +233,14 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     void setAttributeSyncMethod(const std::string& name, const Attribute::Sync& method);
 
+    /**
+     * Set whether the attribute value can change without its setter being called.
+     * Volatile attributes are always returned by getModifiedAttributes
+     * \param name Attribute name
+     * \param isVolatile If true, the attribute is considered volatile
+     */
+    void setAttributeVolatile(const std::string& name, bool isVolatile);
+
     /**
      * Remove the specified attribute
      * \param name Attribute name
@@ -1,10 +1,17 @@
 #include "./core/buffer_object.h"
 
 #include "./core/root_object.h"
+#include "./utils/thread_pool.h"
 
 namespace Splash
 {
 
+/*************/
+BufferObject::~BufferObject()
+{
+    ThreadPool::get().wait(_deserializeFuture);
+}
+
 /**************/
 void BufferObject::setNotUpdated()
 {
@@ -35,12 +42,14 @@ bool BufferObject::setSerializedObject(SerializedObject&& obj)
         _serializedObject = std::move(obj);
         _newSerializedObject = true;
 
-        // Deserialize it right away, in a separate thread
-        _deserializeFuture = std::async(std::launch::async, [this]() {
-            std::lock_guard<Spinlock> updateLock(_updateMutex);
-            deserialize();
-            _serializedObjectWaitingMutex.unlock();
-        });
+        // Deserialize it right away, in the thread pool. This is on the path of every buffer received
+        _deserializeFuture = ThreadPool::get().submit(
+            [this]() {
+                std::lock_guard<Spinlock> updateLock(_updateMutex);
+                deserialize();
+                _serializedObjectWaitingMutex.unlock();
+            },
+            ThreadPool::Priority::High);
 
         return true;
     }
@@ -58,7 +67,7 @@ void BufferObject::updateTimestamp(int64_t timestamp)
         _timestamp = Timer::getTime();
     _updatedBuffer = true;
     if (_root)
-        _root->signalBufferObjectUpdated();
+        _root->signalBufferObjectReady(_name);
 }
 
 /*************/
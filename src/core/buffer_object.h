@@ -82,6 +82,11 @@ class BufferObject : public GraphObject
         registerAttributes();
     }
 
+    /**
+     * Destructor, waiting for the deserialization to finish
+     */
+    ~BufferObject() override;
+
     /**
      * Get a shared read lock over this object,
      * which unlocks it upon destruction
@@ -182,7 +187,7 @@ class BufferObject : public GraphObject
     mutable std::shared_mutex _readMutex;
 
     std::mutex _serializedObjectWaitingMutex{}; //!< Mutex is locked if a serialized object has been set and waits for processing
-    std::future<void> _deserializeFuture{};     //!< Holds the deserialization thread
+    std::future<void> _deserializeFuture{};     //!< Holds the deserialization task
     mutable Spinlock _timestampMutex;
     int64_t _timestamp{0};      //!< Timestamp
     bool _updatedBuffer{false}; //!< True if the BufferObject has been updated
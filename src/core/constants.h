@@ -56,6 +56,7 @@ namespace Splash::Constants
     static const char GL_TIMING_SWAP[] = "swap";
 
     static const uint32_t CONNECTION_TIMEOUT = 5;
+    static const uint32_t TREE_FULL_SYNC_PERIOD = 1000; // Period between full synchronizations of the tree with the attributes, in ms
 }
 
 #define PRINT_FUNCTION_LINE std::cout << "------> " << __PRETTY_FUNCTION__ << "::" << __LINE__ << std::endl;
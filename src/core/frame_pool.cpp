@@ -0,0 +1,255 @@
+#include "./core/frame_pool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./utils/log.h"
+
+namespace Splash
+{
+
+/*************/
+FramePool::Segment::~Segment()
+{
+    if (mapping)
+        munmap(mapping, mappedSize);
+    if (fd >= 0)
+        close(fd);
+    if (owner)
+        shm_unlink(name.c_str());
+}
+
+/*************/
+bool FramePool::Segment::mapTo(size_t capacity)
+{
+    size_t segmentSize = HEADER_SIZE + capacity;
+    if (owner)
+    {
+        if (ftruncate(fd, segmentSize) != 0)
+            return false;
+    }
+    else
+    {
+        // The segment may have been grown by its owner since the last mapping
+        struct stat segmentStat;
+        if (fstat(fd, &segmentStat) != 0 || static_cast<size_t>(segmentStat.st_size) < segmentSize)
+            return false;
+        segmentSize = segmentStat.st_size;
+    }
+
+    // The previous mapping is kept if the new one fails, so that the header stays reachable
+    auto newMapping = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (newMapping == MAP_FAILED)
+        return false;
+
+    if (mapping)
+        munmap(mapping, mappedSize);
+    mapping = static_cast<uint8_t*>(newMapping);
+    mappedSize = segmentSize;
+    return true;
+}
+
+/*************/
+FramePool::Frame::Frame(const std::shared_ptr<Segment>& segment, uint32_t generation, size_t size, int readerIndex)
+    : _segment(segment)
+    , _generation(generation)
+    , _size(size)
+    , _readerIndex(readerIndex)
+{
+}
+
+/*************/
+FramePool::Frame::~Frame()
+{
+    if (_readerIndex >= 0)
+        _segment->header()->readers[_readerIndex].refCount.fetch_sub(1, std::memory_order_relaxed);
+    _segment->header()->refCount.fetch_sub(1, std::memory_order_release);
+}
+
+/*************/
+uint8_t* FramePool::Frame::data()
+{
+    return _segment->payload();
+}
+
+/*************/
+FramePool::Handle FramePool::Frame::getHandle() const
+{
+    return {_segment->name, _generation, static_cast<uint64_t>(_size)};
+}
+
+/*************/
+FramePool::FramePool(const std::string& name, uint32_t maxSlotCount)
+    : _name(name)
+    , _maxSlotCount(maxSlotCount)
+{
+}
+
+/*************/
+std::shared_ptr<FramePool::Frame> FramePool::acquire(size_t size)
+{
+    if (_name.empty())
+        return {};
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Slots are reused in a round robin fashion, to leave as much time as possible
+    // for the other processes to map a frame before its slot is claimed again
+    for (size_t i = 0; i < _slots.size(); ++i)
+    {
+        const auto index = (_nextSlot + i) % _slots.size();
+        auto& segment = _slots[index];
+
+        uint32_t expected = 0;
+        if (!segment->header()->refCount.compare_exchange_strong(expected, WRITE_FLAG | 1, std::memory_order_acq_rel))
+        {
+            // The slot may only be held by readers which died before releasing it
+            reclaimDeadReaders(*segment);
+            expected = 0;
+            if (!segment->header()->refCount.compare_exchange_strong(expected, WRITE_FLAG | 1, std::memory_order_acq_rel))
+                continue;
+        }
+
+        if (segment->capacity() < size && !segment->mapTo(size))
+        {
+            segment->header()->refCount.store(0, std::memory_order_release);
+            continue;
+        }
+
+        const auto generation = segment->header()->generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+        segment->header()->refCount.fetch_and(~WRITE_FLAG, std::memory_order_release);
+        _nextSlot = index + 1;
+        return std::shared_ptr<Frame>(new Frame(segment, generation, size));
+    }
+
+    if (_slots.size() >= _maxSlotCount)
+        return {};
+
+    auto segment = createSegment(size);
+    if (!segment)
+        return {};
+
+    _slots.push_back(segment);
+    _nextSlot = 0;
+    return std::shared_ptr<Frame>(new Frame(segment, segment->header()->generation.load(std::memory_order_acquire), size));
+}
+
+/*************/
+std::shared_ptr<FramePool::Segment> FramePool::createSegment(size_t size)
+{
+    auto segmentName = "/" + _name + "_" + std::to_string(_slots.size());
+    std::replace(segmentName.begin() + 1, segmentName.end(), '/', '_');
+
+    auto segment = std::make_shared<Segment>();
+    segment->name = segmentName;
+    segment->owner = true;
+    segment->fd = shm_open(segmentName.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (segment->fd < 0)
+    {
+        segment->owner = false;
+        Log::get() << Log::WARNING << "FramePool::" << __FUNCTION__ << " - Unable to create shared memory segment " << segmentName << Log::endl;
+        return {};
+    }
+
+    if (!segment->mapTo(size))
+    {
+        Log::get() << Log::WARNING << "FramePool::" << __FUNCTION__ << " - Unable to map shared memory segment " << segmentName << Log::endl;
+        return {};
+    }
+
+    // The segment has just been truncated, so its header is zeroed
+    segment->header()->generation.store(1, std::memory_order_relaxed);
+    segment->header()->refCount.store(1, std::memory_order_release);
+    return segment;
+}
+
+/*************/
+std::shared_ptr<FramePool::Frame> FramePool::map(const Handle& handle)
+{
+    const auto& [segmentName, generation, size] = handle;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto segmentIt = _mappedSegments.find(segmentName);
+    if (segmentIt == _mappedSegments.end())
+    {
+        auto segment = std::make_shared<Segment>();
+        segment->name = segmentName;
+        segment->fd = shm_open(segmentName.c_str(), O_RDWR, 0);
+        if (segment->fd < 0 || !segment->mapTo(0))
+            return {};
+        segmentIt = _mappedSegments.emplace(segmentName, segment).first;
+    }
+    auto segment = segmentIt->second;
+
+    const auto readerIndex = getReaderIndex(*segment);
+    if (readerIndex < 0)
+    {
+        Log::get() << Log::WARNING << "FramePool::" << __FUNCTION__ << " - Too many processes are mapping segment " << segmentName << Log::endl;
+        return {};
+    }
+    auto& reader = segment->header()->readers[readerIndex];
+
+    // Reference the slot before checking it, so that it can not be claimed in-between. The reader count never
+    // exceeds the references this process holds, so that reclaiming them after its death can not underflow
+    const auto previousRefCount = segment->header()->refCount.fetch_add(1, std::memory_order_acq_rel);
+    reader.refCount.fetch_add(1, std::memory_order_relaxed);
+    if ((previousRefCount & WRITE_FLAG) || segment->header()->generation.load(std::memory_order_acquire) != generation ||
+        (segment->capacity() < size && !segment->mapTo(size)))
+    {
+        reader.refCount.fetch_sub(1, std::memory_order_relaxed);
+        segment->header()->refCount.fetch_sub(1, std::memory_order_release);
+        return {};
+    }
+
+    return std::shared_ptr<Frame>(new Frame(segment, generation, size, readerIndex));
+}
+
+/*************/
+int FramePool::getReaderIndex(Segment& segment)
+{
+    const auto pid = static_cast<int32_t>(getpid());
+    auto& readers = segment.header()->readers;
+
+    for (size_t i = 0; i < MAX_READER_COUNT; ++i)
+        if (readers[i].pid.load(std::memory_order_acquire) == pid)
+            return static_cast<int>(i);
+
+    // Entries are kept once registered, and only freed by the owner of the pool when their process is gone
+    for (size_t i = 0; i < MAX_READER_COUNT; ++i)
+    {
+        int32_t expected = 0;
+        if (readers[i].pid.compare_exchange_strong(expected, pid, std::memory_order_acq_rel))
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+/*************/
+void FramePool::reclaimDeadReaders(Segment& segment)
+{
+    auto& readers = segment.header()->readers;
+    for (auto& reader : readers)
+    {
+        const auto pid = reader.pid.load(std::memory_order_acquire);
+        if (pid == 0 || kill(pid, 0) == 0 || errno != ESRCH)
+            continue;
+
+        const auto refCount = reader.refCount.exchange(0, std::memory_order_acq_rel);
+        if (refCount != 0)
+        {
+            segment.header()->refCount.fetch_sub(refCount, std::memory_order_release);
+            Log::get() << Log::WARNING << "FramePool::" << __FUNCTION__ << " - Reclaimed " << refCount << " references held by dead process " << pid << " on " << segment.name
+                       << Log::endl;
+        }
+        reader.pid.store(0, std::memory_order_release);
+    }
+}
+
+} // namespace Splash
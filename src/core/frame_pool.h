@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @frame_pool.h
+ * Pool of frames stored in shared memory, to send images between processes without copying them
+ */
+
+#ifndef SPLASH_FRAME_POOL_H
+#define SPLASH_FRAME_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Splash
+{
+
+/*************/
+class FramePool
+{
+  private:
+    struct Segment;
+
+  public:
+    /**
+     * Handle to a frame, as sent to other processes: segment name, generation, size
+     */
+    using Handle = std::tuple<std::string, uint32_t, uint64_t>;
+
+    /**
+     * Frame stored in a pool slot. The slot is referenced for as long as the frame lives
+     */
+    class Frame
+    {
+        friend FramePool;
+
+      public:
+        ~Frame();
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+
+        /**
+         * Get a pointer to the frame data
+         * \return Return a pointer to the data
+         */
+        uint8_t* data();
+
+        /**
+         * Get the frame size
+         * \return Return the size in bytes
+         */
+        size_t size() const { return _size; }
+
+        /**
+         * Get the handle to this frame, to be sent to other processes
+         * \return Return the handle
+         */
+        Handle getHandle() const;
+
+      private:
+        Frame(const std::shared_ptr<Segment>& segment, uint32_t generation, size_t size, int readerIndex = -1);
+
+        std::shared_ptr<Segment> _segment;
+        uint32_t _generation;
+        size_t _size;
+        int _readerIndex; //!< Entry of the mapping process in the slot reader table, -1 for frames acquired from the pool
+    };
+
+  public:
+    /**
+     * Constructor
+     * \param name Pool name, used to name the shared memory segments. Leave empty for a pool used only to map frames from other processes
+     * \param maxSlotCount Maximum number of slots in the pool
+     */
+    explicit FramePool(const std::string& name = "", uint32_t maxSlotCount = 32);
+
+    /**
+     * Destructor. Segments are unlinked once their last local frame is released
+     */
+    ~FramePool() = default;
+
+    /**
+     * Other constructors and operators
+     */
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    /**
+     * Acquire a frame from a free slot, to be written to
+     * \param size Frame size in bytes
+     * \return Return the frame, or nullptr if all slots are in use
+     */
+    std::shared_ptr<Frame> acquire(size_t size);
+
+    /**
+     * Map a frame from another pool, possibly from another process
+     * \param handle Frame handle
+     * \return Return the frame, or nullptr if it is not valid anymore
+     */
+    std::shared_ptr<Frame> map(const Handle& handle);
+
+    /**
+     * Get the pool name
+     * \return Return the name
+     */
+    std::string getName() const { return _name; }
+
+  private:
+    static constexpr uint32_t WRITE_FLAG = 1u << 31;
+    static constexpr size_t HEADER_SIZE = 128;
+    static constexpr size_t MAX_READER_COUNT = 8; //!< Maximum number of processes mapping a slot
+
+    /**
+     * Process mapping frames from a slot, along with the number of references it holds
+     */
+    struct SlotReader
+    {
+        std::atomic_int32_t pid;
+        std::atomic_uint32_t refCount;
+    };
+
+    /**
+     * Header stored at the beginning of each slot segment
+     */
+    struct SlotHeader
+    {
+        std::atomic_uint32_t refCount;   //!< Number of frames referencing the slot, across processes. WRITE_FLAG is set while it is being claimed
+        std::atomic_uint32_t generation; //!< Incremented each time the slot is claimed, to detect outdated handles
+        SlotReader readers[MAX_READER_COUNT]; //!< Processes which mapped the slot, so that the references of the dead ones can be reclaimed
+    };
+    static_assert(sizeof(SlotHeader) <= HEADER_SIZE, "FramePool slot header does not fit in HEADER_SIZE");
+
+    /**
+     * Shared memory segment holding one slot
+     */
+    struct Segment
+    {
+        ~Segment();
+        bool mapTo(size_t capacity);
+        SlotHeader* header() { return reinterpret_cast<SlotHeader*>(mapping); }
+        uint8_t* payload() { return mapping + HEADER_SIZE; }
+        size_t capacity() const { return mappedSize > HEADER_SIZE ? mappedSize - HEADER_SIZE : 0; }
+
+        std::string name{};
+        int fd{-1};
+        uint8_t* mapping{nullptr};
+        size_t mappedSize{0};
+        bool owner{false};
+    };
+
+    const std::string _name;
+    const uint32_t _maxSlotCount;
+
+    std::mutex _mutex{};
+    std::vector<std::shared_ptr<Segment>> _slots{};
+    size_t _nextSlot{0};
+    std::unordered_map<std::string, std::shared_ptr<Segment>> _mappedSegments{};
+
+    /**
+     * Create a new slot segment
+     * \param size Initial payload capacity
+     * \return Return the segment, or nullptr if it could not be created
+     */
+    std::shared_ptr<Segment> createSegment(size_t size);
+
+    /**
+     * Get the entry of the current process in the reader table of a slot, registering it if needed
+     * \param segment Slot segment
+     * \return Return the entry index, or -1 if the table is full
+     */
+    static int getReaderIndex(Segment& segment);
+
+    /**
+     * Drop the references held on a slot by processes which exited without releasing them
+     * \param segment Slot segment
+     */
+    static void reclaimDeadReaders(Segment& segment);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_FRAME_POOL_H
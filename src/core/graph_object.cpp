@@ -295,6 +295,7 @@ void GraphObject::registerAttributes()
     addAttribute(
         "timestamp", [](const Values&) { return true; }, [&]() -> Values { return {getTimestamp()}; }, {'i'});
     setAttributeDescription("timestamp", "Timestamp (in µs) for the current buffer, based on the latest image data created/received");
+    setAttributeVolatile("timestamp", true);
 }
 
 /*************/
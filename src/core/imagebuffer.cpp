@@ -97,11 +97,43 @@ ImageBuffer::ImageBuffer(const ImageBufferSpec& spec, uint8_t* data, bool map)
     }
 }
 
+/*************/
+ImageBuffer::ImageBuffer(const ImageBufferSpec& spec, const std::shared_ptr<FramePool::Frame>& frame)
+    : _spec(spec)
+    , _frame(frame)
+{
+    assert(!_frame || _frame->size() >= static_cast<size_t>(spec.rawSize()));
+}
+
+/*************/
+ImageBuffer::ImageBuffer(const ImageBuffer& i)
+    : _name(i._name)
+    , _spec(i._spec)
+    , _buffer(i._buffer)
+    , _mappedBuffer(i._mappedBuffer)
+{
+    if (i._frame)
+        _buffer = ResizableArray<uint8_t>(i._frame->data(), i._frame->data() + i._frame->size());
+}
+
+/*************/
+ImageBuffer& ImageBuffer::operator=(const ImageBuffer& i)
+{
+    if (this != &i)
+        *this = ImageBuffer(i);
+    return *this;
+}
+
 /*************/
 void ImageBuffer::zero()
 {
     if (_mappedBuffer)
         return;
+    if (_frame)
+    {
+        memset(_frame->data(), 0, _frame->size());
+        return;
+    }
     if (_buffer.size())
         memset(_buffer.data(), 0, _buffer.size());
 }
@@ -31,6 +31,7 @@
 #include <string>
 
 #include "./core/constants.h"
+#include "./core/frame_pool.h"
 
 #include "./utils/resizable_array.h"
 
@@ -151,7 +152,7 @@ class ImageBufferSpec
      * Get image size in bytes
      * \return Return image size
      */
-    int rawSize() const { return pixelBytes() * width * height; }
+    int rawSize() const { return static_cast<int>(static_cast<int64_t>(bpp) * width * height / 8); }
 };
 
 /*************/
@@ -164,29 +165,47 @@ class ImageBuffer
     ImageBuffer() = default;
 
     /**
-     * Constructor
+     * Constructor. If no data is given, the buffer content is left uninitialized
      * \param spec Image spec
      * \param data Pointer to initial data
      * \param map Use the data pointer as the buffer for this ImageBuffer
      */
     ImageBuffer(const ImageBufferSpec& spec, uint8_t* data = nullptr, bool map = false);
 
+    /**
+     * Constructor
+     * \param spec Image spec
+     * \param frame Frame from a FramePool, used as the buffer for this ImageBuffer. It is moved along with the ImageBuffer, but not shared by its copies
+     */
+    ImageBuffer(const ImageBufferSpec& spec, const std::shared_ptr<FramePool::Frame>& frame);
+
     /**
      * Destructor
      */
     ~ImageBuffer() = default;
 
-    ImageBuffer(const ImageBuffer& i) = default;
+    /**
+     * Copy constructor and operator. The data held by a FramePool frame is copied to a regular buffer,
+     * as the frame can be written to or claimed again by its pool
+     */
+    ImageBuffer(const ImageBuffer& i);
+    ImageBuffer& operator=(const ImageBuffer& i);
+
     ImageBuffer(ImageBuffer&& i) = default;
-    ImageBuffer& operator=(const ImageBuffer& i) = default;
     ImageBuffer& operator=(ImageBuffer&& i) = default;
 
     /**
      * Return a pointer to the image data
      * \return Return a pointer to the data
      */
-    uint8_t* data() { return _mappedBuffer ? _mappedBuffer : _buffer.data(); }
-    const uint8_t* data() const { return _mappedBuffer ? _mappedBuffer : _buffer.data(); }
+    uint8_t* data() { return _frame ? _frame->data() : _mappedBuffer ? _mappedBuffer : _buffer.data(); }
+    const uint8_t* data() const { return _frame ? _frame->data() : _mappedBuffer ? _mappedBuffer : _buffer.data(); }
+
+    /**
+     * Get the FramePool frame holding the image data, if any
+     * \return Return the frame, or nullptr if the data is not held by a FramePool
+     */
+    std::shared_ptr<FramePool::Frame> getFrame() const { return _frame; }
 
     /**
      * Get a const reference to the inner buffer
@@ -217,7 +236,7 @@ class ImageBuffer
      * Get the image buffer size
      * \return Return the size
      */
-    size_t getSize() const { return _mappedBuffer ? _spec.width * _spec.height * _spec.pixelBytes() : _buffer.size(); }
+    size_t getSize() const { return _frame ? _frame->size() : _mappedBuffer ? _spec.rawSize() : _buffer.size(); }
 
     /**
      * Set the name of the image buffer
@@ -237,8 +256,10 @@ class ImageBuffer
      */
     void setRawBuffer(ResizableArray<uint8_t>&& buffer)
     {
-        if (!_mappedBuffer)
-            _buffer = buffer;
+        if (_mappedBuffer)
+            return;
+        _frame.reset();
+        _buffer = std::move(buffer);
     }
 
   private:
@@ -246,6 +267,7 @@ class ImageBuffer
     ImageBufferSpec _spec{};
     ResizableArray<uint8_t> _buffer;
     uint8_t* _mappedBuffer{nullptr};
+    std::shared_ptr<FramePool::Frame> _frame{nullptr};
 };
 
 } // namespace Splash
@@ -7,6 +7,7 @@
 #include "./core/serialize/serialize_uuid.h"
 #include "./core/serialize/serialize_value.h"
 #include "./core/serializer.h"
+#include "./utils/thread_pool.h"
 
 namespace chrono = std::chrono;
 
@@ -76,6 +77,7 @@ std::weak_ptr<GraphObject> RootObject::createObject(const std::string& type, con
         object->setName(name);
         object->setSavable(false);
         _objects[name] = object;
+        ++_objectsVersion;
         return object;
     }
 }
@@ -87,7 +89,10 @@ void RootObject::disposeObject(const std::string& name)
         std::lock_guard<std::recursive_mutex> registerLock(_objectsMutex);
         auto objectIt = _objects.find(name);
         if (objectIt != _objects.end() && objectIt->second.use_count() == 1)
+        {
             _objects.erase(objectIt);
+            ++_objectsVersion;
+        }
     });
 }
 
@@ -275,55 +280,87 @@ void RootObject::updateTreeFromObjects()
     auto& durationMap = Timer::get().getDurationMap();
     for (auto& d : durationMap)
     {
-        std::string path = "/" + _name + "/durations/" + d.first;
-        if (!_tree.hasLeafAt(path))
-            if (!_tree.createLeafAt(path))
+        auto handleIt = _durationLeafHandles.find(d.first);
+        if (handleIt == _durationLeafHandles.end())
+            handleIt = _durationLeafHandles.emplace(d.first, Tree::LeafHandle("/" + _name + "/durations/" + d.first)).first;
+        const auto& handle = handleIt->second;
+
+        if (!_tree.hasLeaf(handle))
+            if (!_tree.createLeafAt(handle.getPath()))
                 continue;
-        _tree.setValueForLeafAt(path, Values({Value(static_cast<int>(d.second))}));
+        _tree.setValueForLeaf(handle, Values({Value(static_cast<int>(d.second))}));
     }
 
+    // Only the attributes which have been set since the last update, or which are volatile,
+    // are synchronized. A full synchronization is done periodically to catch attributes
+    // modified internally by their object.
+    const auto currentTime = Timer::getTime();
+    const bool fullSync = currentTime - _lastFullTreeSync > static_cast<int64_t>(Constants::TREE_FULL_SYNC_PERIOD) * 1000;
+    if (fullSync)
+        _lastFullTreeSync = currentTime;
+
     // Update the Root object attributes
-    auto attributePath = std::string("/" + _name + "/attributes");
+    const auto attributePath = std::string("/" + _name + "/attributes");
     assert(_tree.hasBranchAt(attributePath));
 
-    std::unique_lock<std::recursive_mutex> lock(_attribMutex);
-    for (const auto& leafName : _tree.getLeafListAt(attributePath))
+    for (const auto& [attribName, attribValue] : getModifiedAttributes(fullSync))
     {
-        auto attribIt = _attribFunctions.find(leafName);
-        if (attribIt == _attribFunctions.end())
+        if (!attribValue)
             continue;
-        Values attribValue = attribIt->second();
-        _tree.setValueForLeafAt(attributePath + "/" + leafName, attribValue);
+
+        auto handleIt = _attributeLeafHandles.find(attribName);
+        if (handleIt == _attributeLeafHandles.end())
+            handleIt = _attributeLeafHandles.emplace(attribName, Tree::LeafHandle(attributePath + "/" + attribName)).first;
+        _tree.setValueForLeaf(handleIt->second, attribValue.value());
     }
 
     // Update the GraphObjects attributes
-    auto objectsPath = std::string("/" + _name + "/objects");
+    const auto objectsPath = std::string("/" + _name + "/objects");
     assert(_tree.hasBranchAt(objectsPath));
 
-    for (const auto& objectName : _tree.getBranchListAt(objectsPath))
+    // Handles for objects which do not exist anymore are dropped from time to time
+    if (fullSync)
     {
-        auto objectIt = _objects.find(objectName);
-        if (objectIt == _objects.end())
-            continue;
-        auto object = objectIt->second;
-
-        attributePath = std::string("/" + _name + "/objects/" + objectName + "/attributes");
-        assert(_tree.hasBranchAt(attributePath));
-        for (const auto& leafName : _tree.getLeafListAt(attributePath))
+        for (auto handlesIt = _objectLeafHandles.begin(); handlesIt != _objectLeafHandles.end();)
         {
-            auto attribValue = object->getAttribute(leafName);
-            if (attribValue)
-                _tree.setValueForLeafAt(attributePath + "/" + leafName, attribValue.value());
+            if (_objects.find(handlesIt->first) == _objects.end())
+                handlesIt = _objectLeafHandles.erase(handlesIt);
             else
-                _tree.removeLeafAt(attributePath + "/" + leafName);
+                ++handlesIt;
         }
+    }
+
+    for (const auto& [objectName, object] : _objects)
+    {
+        auto handlesIt = _objectLeafHandles.find(objectName);
+        if (handlesIt == _objectLeafHandles.end())
+            handlesIt = _objectLeafHandles.emplace(objectName, ObjectLeafHandles{Tree::LeafHandle(objectsPath + "/" + objectName + "/type"), {}}).first;
+        auto& leafHandles = handlesIt->second;
 
-        auto docPath = std::string("/" + _name + "/objects/" + objectName + "/documentation");
-        assert(_tree.hasBranchAt(docPath));
-        for (const auto& docBranchName : _tree.getBranchListAt(docPath))
+        if (!_tree.hasLeaf(leafHandles.type))
+            continue;
+
+        for (const auto& [attribName, attribValue] : object->getModifiedAttributes(fullSync))
         {
-            if (!object->hasAttribute(docBranchName))
-                _tree.removeBranchAt(docPath + "/" + docBranchName);
+            if (attribValue)
+            {
+                auto handleIt = leafHandles.attributes.find(attribName);
+                if (handleIt == leafHandles.attributes.end())
+                    handleIt = leafHandles.attributes.emplace(attribName, Tree::LeafHandle(objectsPath + "/" + objectName + "/attributes/" + attribName)).first;
+                _tree.setValueForLeaf(handleIt->second, attribValue.value());
+            }
+            else
+            {
+                leafHandles.attributes.erase(attribName);
+
+                const auto objectPath = objectsPath + "/" + objectName;
+                const auto leafPath = objectPath + "/attributes/" + attribName;
+                if (_tree.hasLeafAt(leafPath))
+                    _tree.removeLeafAt(leafPath);
+                const auto docPath = objectPath + "/documentation/" + attribName;
+                if (_tree.hasBranchAt(docPath))
+                    _tree.removeBranchAt(docPath);
+            }
         }
     }
 }
@@ -337,10 +374,12 @@ void RootObject::propagateTree()
     auto treeSeeds = _tree.getUpdateSeedList();
     if (treeSeeds.empty())
         return;
-    std::vector<uint8_t> serializedSeeds;
-    Serial::serialize(std::string("_tree"), serializedSeeds);
-    Serial::serialize(treeSeeds, serializedSeeds);
-    _link->sendBuffer(SerializedObject(ResizableArray(std::move(serializedSeeds))));
+    const std::string treeName("_tree");
+    SerializedObject serializedSeeds(Serial::getSize(treeName) + Serial::getSize(treeSeeds));
+    Span<uint8_t> output(serializedSeeds);
+    Serial::serializeTo(treeName, output);
+    Serial::serializeTo(treeSeeds, output);
+    _link->sendBuffer(std::move(serializedSeeds));
 }
 
 /*************/
@@ -353,10 +392,12 @@ void RootObject::propagatePath(const std::string& path)
     if (seeds.empty())
         return;
 
-    std::vector<uint8_t> serializedSeeds;
-    Serial::serialize(std::string("_tree"), serializedSeeds);
-    Serial::serialize(seeds, serializedSeeds);
-    _link->sendBuffer(SerializedObject(ResizableArray(std::move(serializedSeeds))));
+    const std::string treeName("_tree");
+    SerializedObject serializedSeeds(Serial::getSize(treeName) + Serial::getSize(seeds));
+    Span<uint8_t> output(serializedSeeds);
+    Serial::serializeTo(treeName, output);
+    Serial::serializeTo(seeds, output);
+    _link->sendBuffer(std::move(serializedSeeds));
 }
 
 /*************/
@@ -380,6 +421,22 @@ void RootObject::registerAttributes()
             return true;
         },
         {});
+
+    // Statistics of the thread pool of this process, updated once per loop
+    addAttribute("threadPoolUsage", [&]() -> Values {
+        const auto stats = ThreadPool::get().getLastStats();
+        const auto availableTime = stats.elapsedTime * stats.workerCount;
+        return {static_cast<int64_t>(availableTime != 0 ? stats.busyTime * 100 / availableTime : 0)};
+    });
+    setAttributeDescription("threadPoolUsage", "Percentage of the thread pool workers time spent running tasks during the last loop");
+    setAttributeVolatile("threadPoolUsage", true);
+
+    addAttribute("threadPoolTasks", [&]() -> Values {
+        const auto stats = ThreadPool::get().getLastStats();
+        return {static_cast<int64_t>(stats.executedTasks), static_cast<int64_t>(stats.stolenTasks), static_cast<int64_t>(stats.pendingTasks)};
+    });
+    setAttributeDescription("threadPoolTasks", "Tasks run and stolen by the thread pool workers during the last loop, and tasks pending at its end");
+    setAttributeVolatile("threadPoolTasks", true);
 }
 
 /*************/
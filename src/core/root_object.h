@@ -228,12 +228,29 @@ class RootObject : public BaseObject
      */
     void signalBufferObjectUpdated();
 
+    /**
+     * Signals that a BufferObject has a new buffer ready to be sent
+     * \param name Name of the updated object
+     */
+    virtual void signalBufferObjectReady(const std::string& /*name*/) { signalBufferObjectUpdated(); }
+
   protected:
     Context _context{};
 
     Tree::Root _tree{}; //!< Configuration / status tree, shared between all root objects
     std::unordered_map<std::string, int> _treeCallbackIds{};
     std::unordered_map<std::string, CallbackHandle> _attributeCallbackHandles{};
+    int64_t _lastFullTreeSync{0}; //!< Timestamp of the last full synchronization of the tree with the attributes
+
+    // Handles to the leaves written by updateTreeFromObjects, so that their paths are resolved only once
+    struct ObjectLeafHandles
+    {
+        Tree::LeafHandle type{};                                          //!< Type leaf, used to check that the object exists in the tree
+        std::unordered_map<std::string, Tree::LeafHandle> attributes{}; //!< Attribute leaves
+    };
+    std::unordered_map<std::string, Tree::LeafHandle> _durationLeafHandles{};
+    std::unordered_map<std::string, Tree::LeafHandle> _attributeLeafHandles{};
+    std::unordered_map<std::string, ObjectLeafHandles> _objectLeafHandles{};
 
     std::unique_ptr<Factory> _factory{}; //!< Object factory
 
@@ -251,6 +268,7 @@ class RootObject : public BaseObject
     mutable std::recursive_mutex _objectsMutex{};                   //!< Used in registration and unregistration of objects
     std::atomic_bool _objectsCurrentlyUpdated{false};               //!< Prevents modification of objects from multiple places at the same time
     DenseMap<std::string, std::shared_ptr<GraphObject>> _objects{}; //!< Map of all the objects
+    uint64_t _objectsVersion{1};                                    //!< Incremented whenever objects are added or removed
 
     std::unique_ptr<Link> _link{};       //!< Link object for communicatin between World and Scene
 
@@ -292,6 +310,9 @@ class RootObject : public BaseObject
 
     /**
      * Update the tree from the root Objects
+     * Only the attributes which have been modified since the last update, as well
+     * as the volatile ones, are pushed into the tree. All attributes are pushed every
+     * Constants::TREE_FULL_SYNC_PERIOD milliseconds.
      */
     void updateTreeFromObjects();
 
@@ -29,6 +29,7 @@
 #include "./utils/log.h"
 #include "./utils/osutils.h"
 #include "./utils/scope_guard.h"
+#include "./utils/thread_pool.h"
 #include "./utils/timer.h"
 
 #if HAVE_GPHOTO and HAVE_OPENCV
@@ -143,6 +144,7 @@ std::shared_ptr<GraphObject> Scene::addObject(const std::string& type, const std
 
         obj->setName(name);
         _objects[name] = obj;
+        ++_objectsVersion;
 
         // Some objects have to be connected to the gui (if the Scene is master)
         if (_gui != nullptr)
@@ -169,12 +171,15 @@ void Scene::addGhost(const std::string& type, const std::string& name)
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Scene::" << __FUNCTION__ << " - Creating ghost object of type " << type << Log::endl;
 #endif
+    // The objects are locked until the ghost leaf is set, as the render lists depend on it
+    std::lock_guard<std::recursive_mutex> lockObjects(_objectsMutex);
     auto obj = addObject(type, name);
     if (obj)
     {
         auto ghostPath = "/" + _name + "/objects/" + name + "/ghost";
         _tree.createLeafAt(ghostPath);
         _tree.setValueForLeafAt(ghostPath, true);
+        ++_objectsVersion;
     }
 }
 
@@ -220,12 +225,16 @@ void Scene::setEnableJoystickInput(bool enable)
         _joystick = std::make_shared<Joystick>(this);
         _joystick->setName(joystickName);
         _objects[_joystick->getName()] = _joystick;
+        ++_objectsVersion;
     }
     else if (_joystick && !enable)
     {
         _joystick.reset();
         if (auto objectsIt = _objects.find(joystickName); objectsIt != _objects.end())
+        {
             _objects.erase(objectsIt);
+            ++_objectsVersion;
+        }
     }
 }
 
@@ -243,7 +252,44 @@ void Scene::remove(const std::string& name)
     std::lock_guard<std::recursive_mutex> lockObjects(_objectsMutex);
 
     if (_objects.find(name) != _objects.end())
+    {
         _objects.erase(name);
+        ++_objectsVersion;
+    }
+}
+
+/*************/
+void Scene::updateRenderLists()
+{
+    _activeObjects.clear();
+    _renderList.clear();
+    _textureList.clear();
+    _windowList.clear();
+
+    for (const auto& [name, object] : _objects)
+    {
+        if (auto texture = std::dynamic_pointer_cast<Texture>(object))
+            _textureList.push_back(texture);
+        if (object->getType() == "window")
+            _windowList.push_back(std::dynamic_pointer_cast<Window>(object));
+
+        if (_isMaster)
+        {
+            // If the object is a ghost from another scene, it should
+            // not be rendered in the main rendering loop. For example ghost
+            // Cameras are rendered by the GUI whenever they are shown
+            Value isGhost;
+            if (_tree.getValueForLeafAt("/" + _name + "/objects/" + name + "/ghost", isGhost) && isGhost.as<bool>())
+                continue;
+        }
+
+        const auto priority = object->getRenderingPriority();
+        _activeObjects.emplace_back(object, priority);
+        if (priority != GraphObject::Priority::NO_RENDER)
+            _renderList[priority].push_back(object);
+    }
+
+    _renderListsVersion = _objectsVersion;
 }
 
 /*************/
@@ -260,17 +306,20 @@ void Scene::render()
 
         Timer::get() << "textureUpload";
         std::lock_guard<std::recursive_mutex> lockObjects(_objectsMutex);
-        for (auto& obj : _objects)
+        if (_renderListsVersion != _objectsVersion)
+            updateRenderLists();
+
+        for (const auto& weakTexture : _textureList)
         {
-            auto texture = std::dynamic_pointer_cast<Texture>(obj.second);
-            if (texture)
-            {
-                TracyGpuZone("Uploading a texture");
-                ZoneScopedN("Uploading a texture");
-                ZoneName(obj.first.c_str(), obj.first.size());
+            auto texture = weakTexture.lock();
+            if (!texture)
+                continue;
 
-                texture->update();
-            }
+            TracyGpuZone("Uploading a texture");
+            ZoneScopedN("Uploading a texture");
+            ZoneName(texture->getName().c_str(), texture->getName().size());
+
+            texture->update();
         }
         Timer::get() >> "textureUpload";
     }
@@ -279,64 +328,51 @@ void Scene::render()
         TracyGpuZone("Scene rendering");
         ZoneScopedN("Scene rendering");
 
-        // Create lists of objects to update and to render
-        std::map<GraphObject::Priority, std::vector<std::shared_ptr<GraphObject>>> objectList{};
         {
             ZoneScopedN("Preprocessing");
 
             std::lock_guard<std::recursive_mutex> lockObjects(_objectsMutex);
-            for (auto obj = _objects.cbegin(); obj != _objects.cend(); ++obj)
-            {
-                if (_isMaster)
-                {
-                    // If the object is a ghost from another scene, it should
-                    // not be rendered in the main rendering loop. For example ghost
-                    // Cameras are rendered by the GUI whenever they are shown
-                    Value isGhost;
-                    if (_tree.getValueForLeafAt("/" + _name + "/objects/" + obj->second->getName() + "/ghost", isGhost))
-                    {
-                        if (isGhost.as<bool>())
-                            continue;
-                    }
-                }
-
-                // We also run all pending tasks for every object
-                obj->second->runTasks();
+            if (_renderListsVersion != _objectsVersion)
+                updateRenderLists();
 
-                auto priority = obj->second->getRenderingPriority();
-                if (priority == GraphObject::Priority::NO_RENDER)
+            // We run all pending tasks for every object. As they can change the rendering priorities,
+            // these are checked against the ones the render list has been built with
+            bool priorityChanged = false;
+            for (const auto& [weakObject, priority] : _activeObjects)
+            {
+                auto object = weakObject.lock();
+                if (!object)
                     continue;
 
-                auto listIt = objectList.find(priority);
-                if (listIt == objectList.end())
-                {
-                    auto entry = objectList.emplace(std::make_pair(priority, std::vector<std::shared_ptr<GraphObject>>()));
-                    if (entry.second == true)
-                        listIt = entry.first;
-                    else
-                        continue;
-                }
-
-                listIt->second.push_back(obj->second);
+                object->runTasks();
+                priorityChanged = priorityChanged || (object->getRenderingPriority() != priority);
             }
+
+            if (priorityChanged || _renderListsVersion != _objectsVersion)
+                updateRenderLists();
         }
 
         // Update and render the objects
         // See GraphObject::getRenderingPriority() for precision about priorities
-        for (const auto& objPriority : objectList)
+        for (const auto& objPriority : _renderList)
         {
             TracyGpuZone("Render bin");
             ZoneScopedN("Render bin");
 
-            if (objPriority.second.size() != 0)
+            std::string type;
+            if (auto firstObject = objPriority.second.empty() ? nullptr : objPriority.second[0].lock(); firstObject)
             {
-                const auto type = objPriority.second[0]->getType();
+                type = firstObject->getType();
                 Timer::get() << type;
                 ZoneName(type.c_str(), type.size());
             }
 
-            for (auto& obj : objPriority.second)
+            for (const auto& weakObject : objPriority.second)
             {
+                auto obj = weakObject.lock();
+                if (!obj)
+                    continue;
+
                 TracyGpuZone("Rendering an object");
                 ZoneScopedN("Rendering an object");
                 ZoneName(obj->getName().c_str(), obj->getName().size());
@@ -358,8 +394,8 @@ void Scene::render()
                 obj->render();
             }
 
-            if (objPriority.second.size() != 0)
-                Timer::get() >> objPriority.second[0]->getType();
+            if (!type.empty())
+                Timer::get() >> type;
         }
     }
 
@@ -369,9 +405,9 @@ void Scene::render()
 
         // Swap all buffers at once
         Timer::get() << "swap";
-        for (auto& obj : _objects)
-            if (obj.second->getType() == "window")
-                std::dynamic_pointer_cast<Window>(obj.second)->swapBuffers();
+        for (const auto& weakWindow : _windowList)
+            if (auto window = weakWindow.lock(); window)
+                window->swapBuffers();
         Timer::get() >> "swap";
     }
 
@@ -430,6 +466,7 @@ void Scene::run()
 
         Timer::get() >> "loop_scene";
         Timer::get() << "loop_scene";
+        ThreadPool::get().updateStats();
 
         if (_started)
         {
@@ -517,6 +554,7 @@ void Scene::setAsMaster(const std::string& configFilePath)
         _gui->setName("gui");
         _gui->setConfigFilePath(configFilePath);
         _objects["gui"] = _gui;
+        ++_objectsVersion;
     }
 
     _keyboard = std::make_shared<Keyboard>(this);
@@ -527,16 +565,19 @@ void Scene::setAsMaster(const std::string& configFilePath)
     {
         _keyboard->setName("keyboard");
         _objects[_keyboard->getName()] = _keyboard;
+        ++_objectsVersion;
     }
     if (_mouse)
     {
         _mouse->setName("mouse");
         _objects["mouse"] = _mouse;
+        ++_objectsVersion;
     }
     if (_dragndrop)
     {
         _dragndrop->setName("dragndrop");
         _objects[_dragndrop->getName()] = _dragndrop;
+        ++_objectsVersion;
     }
 
 #if HAVE_GPHOTO and HAVE_OPENCV
@@ -544,16 +585,19 @@ void Scene::setAsMaster(const std::string& configFilePath)
     _colorCalibrator = std::make_shared<ColorCalibrator>(this);
     _colorCalibrator->setName("colorCalibrator");
     _objects["colorCalibrator"] = _colorCalibrator;
+    ++_objectsVersion;
 #endif
 
 #if HAVE_CALIMIRO
     _geometricCalibrator = std::make_shared<GeometricCalibrator>(this);
     _geometricCalibrator->setName("geometricCalibrator");
     _objects["geometricCalibrator"] = _geometricCalibrator;
+    ++_objectsVersion;
 
     _texCoordGenerator = std::make_shared<TexCoordGenerator>(this);
     _texCoordGenerator->setName("texCoordGenerator");
     _objects["texCoordGenerator"] = _texCoordGenerator;
+    ++_objectsVersion;
 #endif
 }
 
@@ -861,6 +905,7 @@ void Scene::registerAttributes()
                 for (auto& localObject : _objects)
                     unlink(object, localObject.second);
                 _objects.erase(objectName);
+                ++_objectsVersion;
             });
 
             return true;
@@ -29,6 +29,7 @@
 #include <cstddef>
 #include <future>
 #include <list>
+#include <map>
 #include <vector>
 
 #include "./core/constants.h"
@@ -46,6 +47,8 @@ namespace Splash
 class ControllerObject;
 class Gui;
 class Scene;
+class Texture;
+class Window;
 
 /*************/
 //! Scene class, which does the rendering on a given GPU
@@ -272,6 +275,14 @@ class Scene : public RootObject
 
     static std::vector<std::string> _ghostableTypes;
 
+    // Lists of objects used by the render loop, rebuilt only when objects are added or removed, or when a priority changes.
+    // They do not own the objects, otherwise RootObject::disposeObject would never find them unused
+    uint64_t _renderListsVersion{0};                                                            //!< Value of _objectsVersion when the lists were built
+    std::vector<std::pair<std::weak_ptr<GraphObject>, GraphObject::Priority>> _activeObjects{}; //!< Objects which are not ghosts, with their priority
+    std::map<GraphObject::Priority, std::vector<std::weak_ptr<GraphObject>>> _renderList{};     //!< Objects to render, sorted by priority
+    std::vector<std::weak_ptr<Texture>> _textureList{};                                         //!< Textures to upload
+    std::vector<std::weak_ptr<Window>> _windowList{};                                           //!< Windows to swap
+
     /**
      *  Find which OpenGL version is available (from a predefined list)
      * \return Return MAJOR and MINOR
@@ -284,6 +295,11 @@ class Scene : public RootObject
      */
     void init(const std::string& name);
 
+    /**
+     * Rebuild the lists of objects used by the render loop. Must be called with _objectsMutex locked
+     */
+    void updateRenderLists();
+
     /**
      *  Computes and store the duration of a frame at the refresh rate of the primary monitor
      * \return The duration of a frame at the refresh rate of the primary monitor in microseconds
@@ -50,7 +50,7 @@ struct getSizeHelper<T, typename std::enable_if<std::is_same<ImageBuffer, T>::va
 template <class T>
 struct serializeHelper<T, typename std::enable_if<std::is_same<ImageBuffer, T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         const auto name = obj.getName();
         serializer(name, it);
@@ -66,7 +66,7 @@ struct serializeHelper<T, typename std::enable_if<std::is_same<ImageBuffer, T>::
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<std::is_same<ImageBuffer, T>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         const auto name = deserializer<std::string>(it);
         const auto specString = deserializer<std::string>(it);
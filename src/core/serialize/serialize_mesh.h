@@ -35,6 +35,15 @@
 namespace Splash::Serial::detail
 {
 
+/*************/
+// glm vectors are serialized as their raw memory representation,
+// so that vectors of glm vectors are copied in one go
+template <class T>
+struct isRawSerializable<T, typename std::enable_if<std::is_same<glm::vec2, T>::value || std::is_same<glm::vec4, T>::value>::type> : std::true_type
+{
+    static_assert(sizeof(T) == T::length() * sizeof(float), "glm vectors are expected to be tightly packed");
+};
+
 /*************/
 template <class T>
 struct getSizeHelper<T, typename std::enable_if<std::is_same<glm::vec2, T>::value>::type>
@@ -48,7 +57,7 @@ struct getSizeHelper<T, typename std::enable_if<std::is_same<glm::vec2, T>::valu
 template <class T>
 struct serializeHelper<T, typename std::enable_if<std::is_same<glm::vec2, T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         const auto data = reinterpret_cast<const uint8_t*>(&obj);
         const auto size = 2 * sizeof(float);
@@ -60,7 +69,7 @@ struct serializeHelper<T, typename std::enable_if<std::is_same<glm::vec2, T>::va
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<std::is_same<glm::vec2, T>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         T vector;
         auto data = reinterpret_cast<uint8_t*>(&vector);
@@ -84,7 +93,7 @@ struct getSizeHelper<T, typename std::enable_if<std::is_same<glm::vec4, T>::valu
 template <class T>
 struct serializeHelper<T, typename std::enable_if<std::is_same<glm::vec4, T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         const auto data = reinterpret_cast<const uint8_t*>(&obj);
         const auto size = 4 * sizeof(float);
@@ -96,7 +105,7 @@ struct serializeHelper<T, typename std::enable_if<std::is_same<glm::vec4, T>::va
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<std::is_same<glm::vec4, T>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         T vector;
         auto data = reinterpret_cast<uint8_t*>(&vector);
@@ -118,6 +127,7 @@ struct getSizeHelper<T, typename std::enable_if<std::is_base_of<Mesh::MeshContai
         acc += getSize(obj.uvs);
         acc += getSize(obj.normals);
         acc += getSize(obj.annexe);
+        acc += getSize(obj.indices);
         return acc;
     }
 };
@@ -125,20 +135,21 @@ struct getSizeHelper<T, typename std::enable_if<std::is_base_of<Mesh::MeshContai
 template <class T>
 struct serializeHelper<T, typename std::enable_if<std::is_base_of<Mesh::MeshContainer, T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         serializer(obj.name, it);
         serializer(obj.vertices, it);
         serializer(obj.uvs, it);
         serializer(obj.normals, it);
         serializer(obj.annexe, it);
+        serializer(obj.indices, it);
     }
 };
 
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<std::is_base_of<Mesh::MeshContainer, T>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         Mesh::MeshContainer meshContainer;
         meshContainer.name = deserializer<std::string>(it);
@@ -146,6 +157,7 @@ struct deserializeHelper<T, typename std::enable_if<std::is_base_of<Mesh::MeshCo
         meshContainer.uvs = deserializer<std::vector<glm::vec2>>(it);
         meshContainer.normals = deserializer<std::vector<glm::vec4>>(it);
         meshContainer.annexe = deserializer<std::vector<glm::vec4>>(it);
+        meshContainer.indices = deserializer<std::vector<uint32_t>>(it);
         return meshContainer;
     }
 };
@@ -48,7 +48,7 @@ struct getSizeHelper<T, typename std::enable_if<std::is_same<T, UUID>::value>::t
 template <class T>
 struct serializeHelper<T, typename std::enable_if<std::is_same<T, UUID>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         constexpr uint32_t size = sizeof(T);
         const uint8_t* ptr = reinterpret_cast<const uint8_t*>(&obj);
@@ -60,7 +60,7 @@ struct serializeHelper<T, typename std::enable_if<std::is_same<T, UUID>::value>:
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<std::is_same<T, UUID>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         constexpr size_t size = sizeof(T);
         UUID obj(false);
@@ -31,40 +31,8 @@
 namespace Splash::Serial::detail
 {
 
-// Specialisation of serialization for Splash::ResizableArray<uint8_t>, here known as Value::Buffer
-template <class T>
-struct getSizeHelper<T, typename std::enable_if<std::is_same<T, Value::Buffer>::value>::type>
-{
-    static uint32_t value(const T& obj) { return sizeof(uint32_t) + obj.size(); }
-};
-
-template <class T>
-struct serializeHelper<T, typename std::enable_if<std::is_same<T, Value::Buffer>::value>::type>
-{
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
-    {
-        auto size = static_cast<uint32_t>(obj.size());
-        serializer(size, it);
-        auto data = reinterpret_cast<const uint8_t*>(obj.data());
-        std::copy(data, data + size, it);
-        it += size;
-    }
-};
-
-template <class T>
-struct deserializeHelper<T, typename std::enable_if<std::is_same<T, Value::Buffer>::value>::type>
-{
-    static T apply(std::vector<uint8_t>::const_iterator& it)
-    {
-        auto size = deserializer<uint32_t>(it);
-        T obj(static_cast<size_t>(size));
-        auto data = reinterpret_cast<uint8_t*>(obj.data());
-        std::copy(it, it + size, data);
-        it += size;
-
-        return obj;
-    }
-};
+// Splash::ResizableArray<uint8_t>, here known as Value::Buffer, is serialized by the generic
+// path for contiguous containers
 
 // Specialisation of serialization for Splash::Value
 template <class T>
@@ -89,7 +57,7 @@ struct getSizeHelper<T, typename std::enable_if<std::is_same<T, Value>::value>::
 template <class T>
 struct serializeHelper<T, typename std::enable_if<std::is_same<T, Value>::value>::type>
 {
-    static void apply(const Value& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const Value& obj, uint8_t*& it)
     {
         auto objType = obj.getType();
         serializer(static_cast<typename std::underlying_type<Value::Type>::type>(objType), it);
@@ -118,7 +86,7 @@ struct serializeHelper<T, typename std::enable_if<std::is_same<T, Value>::value>
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<std::is_same<T, Value>::value>::type>
 {
-    static Value apply(std::vector<uint8_t>::const_iterator& it)
+    static Value apply(const uint8_t*& it)
     {
         T obj;
         Value::Type type;
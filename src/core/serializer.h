@@ -28,6 +28,7 @@
 #define SPLASH_SERIALIZER_H
 
 #include <chrono>
+#include <cstring>
 #include <iterator>
 #include <numeric>
 #include <string>
@@ -36,6 +37,8 @@
 #include <utility>
 #include <vector>
 
+#include "./utils/span.h"
+
 namespace Splash
 {
 
@@ -88,6 +91,50 @@ struct is_specialisation_of<Template, Template<Args...>> : std::true_type
 {
 };
 
+/**
+ * Helper tool to check whether the given template type stores its elements contiguously, accessible through data()
+ */
+namespace detail
+{
+
+template <typename T>
+auto isContiguousImpl(int) -> decltype(std::declval<T&>().size(),
+    std::enable_if_t<std::is_same<std::remove_const_t<std::remove_pointer_t<decltype(std::declval<T&>().data())>>, typename T::value_type>::value>(),
+    std::true_type{});
+
+template <typename T>
+std::false_type isContiguousImpl(...);
+
+} // namespace detail
+
+template <typename T>
+using isContiguous = decltype(detail::isContiguousImpl<T>(0));
+
+namespace detail
+{
+
+/**
+ * Types which are serialized as their raw memory representation. Contiguous containers of such types
+ * are serialized and deserialized with a single copy. Specialize it for other types serialized this way.
+ */
+template <class T, class Enable = void>
+struct isRawSerializable : std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value>
+{
+};
+
+template <class T, class Enable = void>
+struct isBulkSerializable : std::false_type
+{
+};
+
+template <class T>
+struct isBulkSerializable<T, typename std::enable_if<isContiguous<T>::value && !std::is_same<T, std::string>::value>::type>
+    : std::integral_constant<bool, isRawSerializable<typename T::value_type>::value && std::is_trivially_copyable<typename T::value_type>::value>
+{
+};
+
+} // namespace detail
+
 /*************/
 template <class T>
 uint32_t getSize(const T& obj);
@@ -117,7 +164,13 @@ struct getSizeHelper<T, typename std::enable_if<is_specialisation_of<std::chrono
 };
 
 template <class T>
-struct getSizeHelper<T, typename std::enable_if<isIterable<T>::value && !std::is_same<T, std::string>::value>::type>
+struct getSizeHelper<T, typename std::enable_if<isBulkSerializable<T>::value>::type>
+{
+    static uint32_t value(const T& obj) { return sizeof(uint32_t) + obj.size() * sizeof(typename T::value_type); }
+};
+
+template <class T>
+struct getSizeHelper<T, typename std::enable_if<isIterable<T>::value && !std::is_same<T, std::string>::value && !isBulkSerializable<T>::value>::type>
 {
     static uint32_t value(const T& obj)
     {
@@ -171,12 +224,12 @@ template <class T, class Enable = void>
 struct serializeHelper;
 
 template <class T>
-void serializer(const T& obj, std::vector<uint8_t>::iterator& it);
+void serializer(const T& obj, uint8_t*& it);
 
 template <class T>
 struct serializeHelper<T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         const uint8_t* ptr = reinterpret_cast<const uint8_t*>(&obj);
         std::copy(ptr, ptr + sizeof(T), it);
@@ -187,7 +240,7 @@ struct serializeHelper<T, typename std::enable_if<std::is_arithmetic<T>::value |
 template <class T>
 struct serializeHelper<T, typename std::enable_if<std::is_same<std::string, T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         const auto size = static_cast<uint32_t>(obj.size());
         serializer(size, it);
@@ -200,7 +253,7 @@ struct serializeHelper<T, typename std::enable_if<std::is_same<std::string, T>::
 template <class T>
 struct serializeHelper<T, typename std::enable_if<is_specialisation_of<std::chrono::time_point, T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         using namespace std::chrono;
         int64_t value = duration_cast<milliseconds>(obj.time_since_epoch()).count();
@@ -211,9 +264,23 @@ struct serializeHelper<T, typename std::enable_if<is_specialisation_of<std::chro
 };
 
 template <class T>
-struct serializeHelper<T, typename std::enable_if<isIterable<T>::value && !std::is_same<std::string, T>::value>::type>
+struct serializeHelper<T, typename std::enable_if<isBulkSerializable<T>::value>::type>
+{
+    static void apply(const T& obj, uint8_t*& it)
+    {
+        const auto size = static_cast<uint32_t>(obj.size());
+        serializer(size, it);
+        const auto byteSize = size * sizeof(typename T::value_type);
+        if (byteSize != 0)
+            memcpy(it, obj.data(), byteSize);
+        it += byteSize;
+    }
+};
+
+template <class T>
+struct serializeHelper<T, typename std::enable_if<isIterable<T>::value && !std::is_same<std::string, T>::value && !isBulkSerializable<T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         serializer(static_cast<uint32_t>(obj.size()), it);
         for (const auto& cur : obj)
@@ -222,14 +289,14 @@ struct serializeHelper<T, typename std::enable_if<isIterable<T>::value && !std::
 };
 
 template <class T>
-inline void serializeTuple(const T& obj, std::vector<uint8_t>::iterator& it, int_<0>)
+inline void serializeTuple(const T& obj, uint8_t*& it, int_<0>)
 {
     constexpr size_t idx = std::tuple_size<T>::value - 1;
     serializer(std::get<idx>(obj), it);
 }
 
 template <class T, size_t pos>
-inline void serializeTuple(const T& obj, std::vector<uint8_t>::iterator& it, int_<pos>)
+inline void serializeTuple(const T& obj, uint8_t*& it, int_<pos>)
 {
     constexpr size_t idx = std::tuple_size<T>::value - pos - 1;
     serializer(std::get<idx>(obj), it);
@@ -239,7 +306,7 @@ inline void serializeTuple(const T& obj, std::vector<uint8_t>::iterator& it, int
 template <class T>
 struct serializeHelper<T, typename std::enable_if<is_specialisation_of<std::tuple, T>::value>::type>
 {
-    static void apply(const T& obj, std::vector<uint8_t>::iterator& it)
+    static void apply(const T& obj, uint8_t*& it)
     {
         constexpr size_t tupleSize = std::tuple_size<T>::value - 1;
         return serializeTuple(obj, it, int_<tupleSize>());
@@ -247,7 +314,7 @@ struct serializeHelper<T, typename std::enable_if<is_specialisation_of<std::tupl
 };
 
 template <class T>
-inline void serializer(const T& obj, std::vector<uint8_t>::iterator& it)
+inline void serializer(const T& obj, uint8_t*& it)
 {
     serializeHelper<T>::apply(obj, it);
 }
@@ -257,19 +324,39 @@ inline void serializer(const T& obj, std::vector<uint8_t>::iterator& it)
 /**
  * Serialize the given object
  * \param obj Object to serialize
- * \param buffer Buffer holding the serialized object
+ * \param buffer Buffer holding the serialized object, either a std::vector<uint8_t> or a ResizableArray<uint8_t>
  */
-template <class T>
-inline void serialize(const T& obj, std::vector<uint8_t>& buffer)
+template <class T, class Buffer>
+inline void serialize(const T& obj, Buffer& buffer)
 {
     uint32_t offset = buffer.size();
     uint32_t size = getSize(obj);
     buffer.resize(offset + size);
 
-    auto it = buffer.begin() + offset;
+    auto it = buffer.data() + offset;
     detail::serializer(obj, it);
 }
 
+/**
+ * Serialize the given object into a pre-sized output span, without any intermediate buffer.
+ * Headers and payloads can be written in place this way, for example in a SerializedObject or a shared memory slot
+ * \param obj Object to serialize
+ * \param output Output span, advanced past the serialized object
+ * \return Return false if the span is too small to hold the object, in which case nothing is written
+ */
+template <class T>
+inline bool serializeTo(const T& obj, Span<uint8_t>& output)
+{
+    const auto size = getSize(obj);
+    if (output.size() < size)
+        return false;
+
+    auto it = output.data();
+    detail::serializer(obj, it);
+    output = output.subspan(size);
+    return true;
+}
+
 /*************/
 namespace detail
 {
@@ -278,12 +365,12 @@ template <class T, class Enable = void>
 struct deserializeHelper;
 
 template <class T>
-T deserializer(std::vector<uint8_t>::const_iterator& it);
+T deserializer(const uint8_t*& it);
 
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         T obj;
         std::copy(it, it + sizeof(T), reinterpret_cast<uint8_t*>(&obj));
@@ -295,7 +382,7 @@ struct deserializeHelper<T, typename std::enable_if<std::is_arithmetic<T>::value
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<std::is_same<T, std::string>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         const auto size = deserializer<uint32_t>(it);
         auto obj = T(static_cast<size_t>(size), ' ');
@@ -309,7 +396,7 @@ struct deserializeHelper<T, typename std::enable_if<std::is_same<T, std::string>
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<is_specialisation_of<std::chrono::time_point, T>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         int64_t value;
         std::copy(it, it + sizeof(value), reinterpret_cast<uint8_t*>(&value));
@@ -319,9 +406,24 @@ struct deserializeHelper<T, typename std::enable_if<is_specialisation_of<std::ch
 };
 
 template <class T>
-struct deserializeHelper<T, typename std::enable_if<isIterable<T>::value && !std::is_same<T, std::string>::value>::type>
+struct deserializeHelper<T, typename std::enable_if<isBulkSerializable<T>::value>::type>
+{
+    static T apply(const uint8_t*& it)
+    {
+        const auto size = deserializer<uint32_t>(it);
+        auto obj = T(static_cast<size_t>(size));
+        const auto byteSize = size * sizeof(typename T::value_type);
+        if (byteSize != 0)
+            memcpy(obj.data(), it, byteSize);
+        it += byteSize;
+        return obj;
+    }
+};
+
+template <class T>
+struct deserializeHelper<T, typename std::enable_if<isIterable<T>::value && !std::is_same<T, std::string>::value && !isBulkSerializable<T>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         auto size = deserializer<uint32_t>(it);
         auto obj = T(static_cast<size_t>(size));
@@ -336,7 +438,7 @@ struct deserializeHelper<T, typename std::enable_if<isIterable<T>::value && !std
 };
 
 template <class T>
-inline void deserializeTuple(T& obj, std::vector<uint8_t>::const_iterator& it, int_<0>)
+inline void deserializeTuple(T& obj, const uint8_t*& it, int_<0>)
 {
     constexpr size_t idx = std::tuple_size<T>::value - 1;
     typedef typename std::tuple_element<idx, T>::type U;
@@ -344,7 +446,7 @@ inline void deserializeTuple(T& obj, std::vector<uint8_t>::const_iterator& it, i
 }
 
 template <class T, size_t pos>
-inline void deserializeTuple(T& obj, std::vector<uint8_t>::const_iterator& it, int_<pos>)
+inline void deserializeTuple(T& obj, const uint8_t*& it, int_<pos>)
 {
     constexpr size_t idx = std::tuple_size<T>::value - pos - 1;
     typedef typename std::tuple_element<idx, T>::type U;
@@ -355,7 +457,7 @@ inline void deserializeTuple(T& obj, std::vector<uint8_t>::const_iterator& it, i
 template <class T>
 struct deserializeHelper<T, typename std::enable_if<is_specialisation_of<std::tuple, T>::value>::type>
 {
-    static T apply(std::vector<uint8_t>::const_iterator& it)
+    static T apply(const uint8_t*& it)
     {
         T obj;
         constexpr size_t tupleSize = std::tuple_size<T>::value - 1;
@@ -365,7 +467,7 @@ struct deserializeHelper<T, typename std::enable_if<is_specialisation_of<std::tu
 };
 
 template <class T>
-T deserializer(std::vector<uint8_t>::const_iterator& it)
+T deserializer(const uint8_t*& it)
 {
     return deserializeHelper<T>::apply(it);
 }
@@ -374,16 +476,31 @@ T deserializer(std::vector<uint8_t>::const_iterator& it)
 
 /**
  * Deserialize the given buffer
- * \param buffer Buffer to deserialize
+ * \param buffer Buffer to deserialize, either a std::vector<uint8_t> or a ResizableArray<uint8_t>
+ * \param offset Offset to the start of the object in the buffer
  * \return Return the deserialized object
  */
-template <class T>
-inline T deserialize(const std::vector<uint8_t>& buffer, size_t offset = 0)
+template <class T, class Buffer>
+inline T deserialize(const Buffer& buffer, size_t offset = 0)
 {
-    auto it = buffer.cbegin() + offset;
+    auto it = buffer.data() + offset;
     return detail::deserializer<T>(it);
 }
 
+/**
+ * Deserialize an object from a byte span
+ * \param input Input span, which must hold the whole object. It is advanced past the deserialized object
+ * \return Return the deserialized object
+ */
+template <class T>
+inline T deserializeFrom(Span<const uint8_t>& input)
+{
+    auto it = input.data();
+    auto obj = detail::deserializer<T>(it);
+    input = input.subspan(static_cast<size_t>(it - input.data()));
+    return obj;
+}
+
 } // namespace Serial
 
 } // namespace Splash
@@ -42,6 +42,7 @@ bool Root::addBranchAt(const std::string& path, std::unique_ptr<Branch>&& branch
     auto branchPath = holdingBranch->getPath() + branch->getName();
     if (!holdingBranch->addBranch(std::move(branch)))
         return false;
+    ++_structureGeneration;
 
     if (!silent)
     {
@@ -64,6 +65,7 @@ bool Root::addLeafAt(const std::string& path, std::unique_ptr<Leaf>&& leaf, bool
     auto leafPath = holdingBranch->getPath() + leaf->getName();
     if (!holdingBranch->addLeaf(std::move(leaf)))
         return false;
+    ++_structureGeneration;
 
     if (!silent)
     {
@@ -148,7 +150,9 @@ void Root::clearSeedList()
 /*************/
 void Root::cutdown()
 {
+    std::lock_guard<std::recursive_mutex> lockTree(_treeMutex);
     _rootBranch = std::make_unique<Tree::Branch>("");
+    ++_structureGeneration;
     _seedQueue.clear();
     _updates.clear();
     _branchCallbacksToRegister.clear();
@@ -193,6 +197,7 @@ bool Root::createBranchAt(const std::string& path, bool silent)
 #endif
         return false;
     }
+    ++_structureGeneration;
 
     if (!silent)
     {
@@ -242,6 +247,7 @@ bool Root::createLeafAt(const std::string& path, Values value, bool silent)
 #endif
         return false;
     }
+    ++_structureGeneration;
 
     if (!silent)
     {
@@ -279,7 +285,10 @@ std::unique_ptr<Branch> Root::cutBranchAt(const std::string& path, bool silent)
         _updates.emplace_back(std::make_tuple(Task::RemoveBranch, Values({path}), chrono::system_clock::now(), _uuid));
     }
 
-    return holdingBranch->cutBranch(branchName);
+    auto branch = holdingBranch->cutBranch(branchName);
+    if (branch)
+        ++_structureGeneration;
+    return branch;
 }
 
 /*************/
@@ -308,7 +317,10 @@ std::unique_ptr<Leaf> Root::cutLeafAt(const std::string& path, bool silent)
         _updates.emplace_back(std::make_tuple(Task::RemoveLeaf, Values({path}), chrono::system_clock::now(), _uuid));
     }
 
-    return holdingBranch->cutLeaf(leafName);
+    auto leaf = holdingBranch->cutLeaf(leafName);
+    if (leaf)
+        ++_structureGeneration;
+    return leaf;
 }
 
 /*************/
@@ -444,6 +456,47 @@ bool Root::hasLeafAt(const std::string& path) const
         return false;
 }
 
+/*************/
+bool Root::hasLeaf(const LeafHandle& handle) const
+{
+    std::lock_guard<std::recursive_mutex> lockTree(_treeMutex);
+    return getLeaf(handle) != nullptr;
+}
+
+/*************/
+bool Root::getValueForLeaf(const LeafHandle& handle, Value& value) const
+{
+    std::lock_guard<std::recursive_mutex> lockTree(_treeMutex);
+    auto leaf = getLeaf(handle);
+    if (!leaf)
+        return false;
+
+    value = leaf->get();
+    return true;
+}
+
+/*************/
+bool Root::setValueForLeaf(const LeafHandle& handle, const Value& value, bool force)
+{
+    std::lock_guard<std::recursive_mutex> lockTree(_treeMutex);
+    auto leaf = getLeaf(handle);
+    if (!leaf)
+        return false;
+
+    if (!force && value == leaf->get())
+        return true;
+
+    const auto timestamp = chrono::system_clock::now();
+    if (!leaf->set(value, timestamp))
+        return false;
+
+    std::lock_guard<std::recursive_mutex> lock(_updatesMutex);
+    auto seed = std::make_tuple(Task::SetLeaf, Values({handle.getPath(), value}), timestamp, _uuid);
+    _updates.emplace_back(std::move(seed));
+
+    return true;
+}
+
 /*************/
 bool Root::setValueForLeafAt(const std::string& path, const Value& value, int64_t timestamp, bool force)
 {
@@ -707,6 +760,7 @@ bool Root::removeBranchAt(const std::string& path, bool silent)
 #endif
         return false;
     }
+    ++_structureGeneration;
 
     if (!silent)
     {
@@ -750,6 +804,7 @@ bool Root::removeLeafAt(const std::string& path, bool silent)
 #endif
         return false;
     }
+    ++_structureGeneration;
 
     if (!silent)
     {
@@ -793,6 +848,7 @@ bool Root::renameBranchAt(const std::string& path, const std::string& name, bool
 #endif
         return false;
     }
+    ++_structureGeneration;
 
     if (!silent)
     {
@@ -836,6 +892,7 @@ bool Root::renameLeafAt(const std::string& path, const std::string& name, bool s
 #endif
         return false;
     }
+    ++_structureGeneration;
 
     if (!silent)
     {
@@ -976,6 +1033,19 @@ Leaf* Root::getLeafAt(const std::vector<std::string>& path) const
     return leaf;
 }
 
+/*************/
+Leaf* Root::getLeaf(const LeafHandle& handle) const
+{
+    if (handle._root != this || handle._generation != _structureGeneration)
+    {
+        handle._leaf = handle._path.empty() ? nullptr : getLeafAt(handle._path);
+        handle._root = this;
+        handle._generation = _structureGeneration;
+    }
+
+    return handle._leaf;
+}
+
 /*************/
 std::vector<std::string> Root::processPath(const std::string& path)
 {
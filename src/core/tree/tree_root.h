@@ -76,6 +76,35 @@ using Seed = std::tuple<Task, Value, std::chrono::system_clock::time_point, UUID
 
 class Root;
 
+/**
+ * Handle to a leaf, given by its path. The leaf is looked up once and the result is
+ * kept until the structure of the tree changes, which saves parsing the path and
+ * walking the branches on every access.
+ */
+class LeafHandle
+{
+    friend Root;
+
+  public:
+    LeafHandle() = default;
+    explicit LeafHandle(const std::string& path)
+        : _path(path)
+    {
+    }
+
+    /**
+     * Get the path to the leaf
+     * \return Return the path
+     */
+    const std::string& getPath() const { return _path; }
+
+  private:
+    std::string _path{};
+    mutable const Root* _root{nullptr}; //!< Tree the leaf has been resolved from
+    mutable Leaf* _leaf{nullptr};       //!< Resolved leaf, may be nullptr if it does not exist
+    mutable uint64_t _generation{0};    //!< Structure generation of the tree at resolution time
+};
+
 /**
  * Tree Handle. The tree is locked as long as it exists
  */
@@ -236,6 +265,13 @@ class Root
      */
     bool hasLeafAt(const std::string& path) const;
 
+    /**
+     * Return whether the leaf targeted by the given handle exists
+     * \param handle Leaf handle
+     * \return Return true if the leaf exists
+     */
+    bool hasLeaf(const LeafHandle& handle) const;
+
     /**
      * Get the oldest error, and resets the error flag
      * \param error Error string
@@ -279,6 +315,14 @@ class Root
      */
     bool getValueForLeafAt(const std::string& path, Value& value) const;
 
+    /**
+     * Get the value held by the leaf targeted by the given handle
+     * \param handle Leaf handle
+     * \param value The value of the leaf, or an empty value
+     * \return Return true if the leaf was found
+     */
+    bool getValueForLeaf(const LeafHandle& handle, Value& value) const;
+
     /**
      * Set the value for the leaf at the given path
      * This method calls writeValueToLeafAt, and triggers the synchronisation
@@ -302,6 +346,16 @@ class Root
         return setValueForLeafAt(path, Value(value), timestamp, force);
     }
 
+    /**
+     * Set the value for the leaf targeted by the given handle
+     * This has the same effect as setValueForLeafAt, including the synchronization to other trees
+     * \param handle Leaf handle
+     * \param value Leaf value
+     * \param force Force setting the value, even though it did not change from the stored value
+     * \return Return true if all went well
+     */
+    bool setValueForLeaf(const LeafHandle& handle, const Value& value, bool force = false);
+
     /**
      * Get the seeds generated while modifying the tree
      * This clears the updates queue.
@@ -385,6 +439,7 @@ class Root
     UUID _uuid{true};
     std::string _name{"root"};
     std::unique_ptr<Branch> _rootBranch{nullptr};
+    uint64_t _structureGeneration{1}; //!< Incremented whenever branches or leaves are added, removed or renamed, to invalidate the LeafHandles
     mutable std::mutex _taskMutex{};
     mutable std::recursive_mutex _updatesMutex{};
     std::list<Seed> _seedQueue{}; //!< Queue of seeds to be applied to the tree by
@@ -439,6 +494,13 @@ class Root
      */
     Leaf* getLeafAt(const std::vector<std::string>& path) const;
 
+    /**
+     * Get a pointer to the leaf targeted by the given handle, resolving it if needed. The tree must be locked
+     * \param handle Leaf handle
+     * \return Return the leaf, or nullptr
+     */
+    Leaf* getLeaf(const LeafHandle& handle) const;
+
     /**
      * Extract the multiple parts of the given path
      * \param path Path
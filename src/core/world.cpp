@@ -1,5 +1,6 @@
 #include "./core/world.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <regex>
@@ -25,6 +26,7 @@
 #include "./utils/jsonutils.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
+#include "./utils/thread_pool.h"
 #include "./utils/timer.h"
 
 using namespace glm;
@@ -110,6 +112,7 @@ bool World::applyContext()
 void World::run()
 {
     tracy::SetThreadName("World");
+    _loopThreadId = std::this_thread::get_id();
 
     if (!applyContext())
         return;
@@ -126,7 +129,8 @@ void World::run()
 
         Timer::get() << "loop_world";
         Timer::get() << "loop_world_inner";
-        std::lock_guard<std::mutex> lockConfiguration(_configurationMutex);
+        std::unique_lock<std::mutex> lockConfiguration(_configurationMutex);
+        std::vector<std::shared_ptr<BufferObject>> updatedObjects;
 
         {
             // Process tree updates
@@ -143,48 +147,21 @@ void World::run()
         {
             ZoneScopedN("Send buffers");
             std::lock_guard<std::recursive_mutex> lockObjects(_objectsMutex);
+            updateBufferObjects();
 
-            // Read and serialize new buffers
-            Timer::get() << "serialize";
-            std::vector<SerializedObject> serializedObjects;
-
+            for (auto& [name, object] : _objects)
             {
-                ZoneScopedN("Serialize buffers");
-                for (auto& [name, object] : _objects)
-                {
-                    ZoneScopedN("Serialize one buffer");
-                    ZoneName(name.c_str(), name.size());
+                ZoneScopedN("Update object");
+                ZoneName(name.c_str(), name.size());
 
-                    object->runTasks();
-                    object->update();
-                    if (auto bufferObject = std::dynamic_pointer_cast<BufferObject>(object); bufferObject)
-                    {
-                        if (bufferObject->wasUpdated())
-                        {
-                            auto serializedObject = bufferObject->serialize();
-                            bufferObject->setNotUpdated();
-                            serializedObjects.push_back(std::move(serializedObject));
-                        }
-                    }
-                }
-                Timer::get() >> "serialize";
+                object->runTasks();
+                object->update();
             }
 
-            // Wait for previous buffers to be uploaded
-            {
-                ZoneScopedN("Wait for buffers to be sent");
-                _link->waitForBufferSending(std::chrono::milliseconds(50)); // Maximum time to wait for frames to arrive
-                sendMessage(Constants::ALL_PEERS, "syncScenes", {});
-                Timer::get() >> "upload";
-            }
-
-            // Ask for the upload of the new buffers, during the next world loop
-            {
-                ZoneScopedN("Prepare sending next buffers");
-                Timer::get() << "upload";
-                for (auto& serializedObject : serializedObjects)
-                    _link->sendBuffer(std::move(serializedObject));
-            }
+            // Buffers ready in-between loops were already sent, this catches the remaining updates (attributes, ...)
+            for (const auto& [name, bufferObject] : _bufferObjects)
+                if (bufferObject->wasUpdated())
+                    updatedObjects.push_back(bufferObject);
         }
 
         if (_quit)
@@ -202,18 +179,123 @@ void World::run()
             Timer::get() >> "tree_propagate";
         }
 
-        // Sync with buffer object update
+        lockConfiguration.unlock();
+
+        // Buffers are sent without holding the locks, as this waits for them to be received
+        sendBufferObjects(updatedObjects);
         Timer::get() >> "loop_world_inner";
-        auto elapsed = Timer::get().getDuration("loop_world_inner");
-        waitSignalBufferObjectUpdated(std::max<uint64_t>(1, 1e6 / (float)_worldFramerate - elapsed));
 
-        // Sync to world framerate
+        // Until the next loop, buffers are sent as soon as their object signals them as ready,
+        // so that the latency does not depend on the World framerate
+        const auto loopDuration = static_cast<int64_t>(1e6 / static_cast<float>(_worldFramerate));
+        const auto loopEnd = Timer::getTime() + loopDuration - static_cast<int64_t>(Timer::get().getDuration("loop_world_inner"));
+        for (auto now = Timer::getTime(); now < loopEnd; now = Timer::getTime())
+        {
+            const auto readyObjectNames = waitForReadyBufferObjects(loopEnd - now);
+            if (!readyObjectNames.empty())
+                sendReadyBufferObjects(readyObjectNames);
+        }
+
         Timer::get() >> "loop_world";
+        ThreadPool::get().updateStats();
 
         FrameMarkEnd("World")
     }
 }
 
+/*************/
+void World::updateBufferObjects()
+{
+    if (_bufferObjectsVersion == _objectsVersion)
+        return;
+
+    _bufferObjects.clear();
+    for (const auto& [name, object] : _objects)
+        if (auto bufferObject = std::dynamic_pointer_cast<BufferObject>(object); bufferObject)
+            _bufferObjects[name] = bufferObject;
+    _bufferObjectsVersion = _objectsVersion;
+}
+
+/*************/
+std::vector<std::string> World::waitForReadyBufferObjects(uint64_t timeout)
+{
+    std::unique_lock<std::mutex> lockCondition(_bufferObjectUpdatedMutex);
+    _bufferObjectUpdatedCondition.wait_for(lockCondition, std::chrono::microseconds(timeout), [&]() { return !_readyBufferObjects.empty(); });
+    _bufferObjectUpdated = false;
+
+    std::vector<std::string> readyObjects;
+    std::swap(readyObjects, _readyBufferObjects);
+    return readyObjects;
+}
+
+/*************/
+void World::signalBufferObjectReady(const std::string& name)
+{
+    // Objects updated from the loop itself are sent by the loop as part of the update
+    if (std::this_thread::get_id() == _loopThreadId)
+        return;
+
+    std::lock_guard<std::mutex> lockCondition(_bufferObjectUpdatedMutex);
+    if (std::find(_readyBufferObjects.begin(), _readyBufferObjects.end(), name) == _readyBufferObjects.end())
+        _readyBufferObjects.push_back(name);
+    _bufferObjectUpdated = true;
+    _bufferObjectUpdatedCondition.notify_all();
+}
+
+/*************/
+void World::sendReadyBufferObjects(const std::vector<std::string>& names)
+{
+    ZoneScopedN("Send ready buffers");
+
+    // The ready objects are gathered under the locks, which are released before sending as this waits for the buffers to be received
+    std::vector<std::shared_ptr<BufferObject>> readyObjects;
+    {
+        std::lock_guard<std::mutex> lockConfiguration(_configurationMutex);
+        std::lock_guard<std::recursive_mutex> lockObjects(_objectsMutex);
+        updateBufferObjects();
+
+        for (const auto& name : names)
+        {
+            auto objectIt = _bufferObjects.find(name);
+            if (objectIt == _bufferObjects.end())
+                continue;
+
+            // The object may have been sent by the main loop since it signaled itself
+            auto& object = objectIt->second;
+            object->update();
+            if (object->wasUpdated())
+                readyObjects.push_back(object);
+        }
+    }
+
+    if (!readyObjects.empty())
+        sendBufferObjects(readyObjects);
+}
+
+/*************/
+void World::sendBufferObjects(const std::vector<std::shared_ptr<BufferObject>>& objects)
+{
+    // Each buffer is sent as soon as it is serialized, without waiting for the other ones
+    Timer::get() << "serialize";
+    ThreadPool::get().parallelFor(objects.size(), [&](size_t index) {
+        ZoneScopedN("Serialize and send one buffer");
+        auto serializedObject = objects[index]->serialize();
+        objects[index]->setNotUpdated();
+        _link->sendBuffer(std::move(serializedObject));
+    });
+    Timer::get() >> "serialize";
+
+    // The Scenes upload the new buffers once they are all received. This is also
+    // sent when there is no new buffer, as a sign of life
+    {
+        ZoneScopedN("Wait for buffers to be sent");
+        Timer::get() << "upload";
+        _link->waitForBufferSending(std::chrono::milliseconds(50)); // Maximum time to wait for frames to arrive
+        sendMessage(Constants::ALL_PEERS, "syncScenes", {});
+        Timer::get() >> "upload";
+    }
+}
+
 /*************/
 void World::addToWorld(const std::string& type, const std::string& name)
 {
@@ -227,6 +309,7 @@ void World::addToWorld(const std::string& type, const std::string& name)
     {
         object->setName(name);
         _objects[name] = object;
+        ++_objectsVersion;
     }
 }
 
@@ -238,6 +321,7 @@ bool World::applyConfig()
     // We first destroy all scene and objects
     _scenes.clear();
     _objects.clear();
+    ++_objectsVersion;
     _masterSceneName = "";
 
     try
@@ -975,7 +1059,10 @@ void World::registerAttributes()
                 _nameRegistry.unregisterName(objectName);
                 auto objectIt = _objects.find(objectName);
                 if (objectIt != _objects.end())
+                {
                     _objects.erase(objectIt);
+                    ++_objectsVersion;
+                }
 
                 // Ask for Scenes to delete the object
                 sendMessage(Constants::ALL_PEERS, "deleteObject", args);
@@ -1271,6 +1358,37 @@ void World::registerAttributes()
         [&]() -> Values { return {_enforceRealtime}; },
         {'b'});
     setAttributeDescription("forceRealtime", "Ask the scheduler to run Splash with realtime priority.");
+
+    addAttribute("forceCoreAffinity",
+        [&](const Values& args) {
+            _enforceCoreAffinity = args[0].as<bool>();
+
+            addTask([=]() {
+                // The World loop gets the first core to itself, the thread pool running on the other ones
+                std::vector<int> loopCores;
+                std::vector<int> poolCores;
+                if (_enforceCoreAffinity && Utils::getCoreCount() > 1)
+                {
+                    loopCores.push_back(0);
+                    for (int core = 1; core < Utils::getCoreCount(); ++core)
+                        poolCores.push_back(core);
+                }
+                else
+                {
+                    for (int core = 0; core < Utils::getCoreCount(); ++core)
+                        loopCores.push_back(core);
+                }
+
+                if (!Utils::setAffinity(loopCores))
+                    Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - Unable to set the World loop core affinity" << Log::endl;
+                ThreadPool::get().setAffinity(poolCores);
+            });
+
+            return true;
+        },
+        [&]() -> Values { return {_enforceCoreAffinity}; },
+        {'b'});
+    setAttributeDescription("forceCoreAffinity", "Pin the World loop to the first core, and its worker threads to the other ones.");
 #endif
 
     addAttribute("framerate",
@@ -1326,6 +1444,7 @@ void World::registerAttributes()
 
     addAttribute("clock", [&](const Values& /*args*/) { return true; }, [&]() -> Values { return {Timer::getTime()}; }, {});
     setAttributeDescription("clock", "Current World clock (not settable)");
+    setAttributeVolatile("clock", true);
 
     addAttribute("masterClock",
         [&](const Values& /*args*/) { return true; },
@@ -1338,6 +1457,7 @@ void World::registerAttributes()
         },
         {});
     setAttributeDescription("masterClock", "Current World master clock (not settable)");
+    setAttributeVolatile("masterClock", true);
 
     RootObject::registerAttributes();
 }
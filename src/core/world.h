@@ -31,11 +31,13 @@
 #include <signal.h>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "./core/constants.h"
 
 #include "./core/attribute.h"
+#include "./core/buffer_object.h"
 #include "./core/factory.h"
 #if HAVE_PORTAUDIO
 #include "./sound/ltcclock.h"
@@ -95,7 +97,7 @@ class World : public RootObject
     static World* _that;       //!< Pointer to the World
     struct sigaction _signals; //!< System signals
     std::mutex _configurationMutex;
-    bool _enforceCoreAffinity{false}; //!< If true, World and Scenes have their affinity fixed in specific, separate cores
+    bool _enforceCoreAffinity{false}; //!< If true, the World loop and the thread pool have their affinity fixed in separate cores
     bool _enforceRealtime{false};     //!< If true, realtime scheduling is asked to the system, if possible
 
     // World parameters
@@ -116,6 +118,13 @@ class World : public RootObject
     std::string _projectFilename;       //!< Project configuration file path
     Json::Value _config;                //!< Configuration as JSon
 
+    // BufferObjects, cached to avoid casting all objects at each loop
+    std::unordered_map<std::string, std::shared_ptr<BufferObject>> _bufferObjects{};
+    uint64_t _bufferObjectsVersion{0}; //!< Value of _objectsVersion when _bufferObjects was built
+
+    std::vector<std::string> _readyBufferObjects{}; //!< BufferObjects with a new buffer to send, protected by _bufferObjectUpdatedMutex
+    std::thread::id _loopThreadId{};                //!< Thread running the World loop
+
     NameRegistry _nameRegistry{}; //!< Object name registry
     bool _sceneLaunched{false};
     std::mutex _childProcessMutex;
@@ -124,6 +133,30 @@ class World : public RootObject
     // Synchronization testings
     int _swapSynchronizationTesting{0}; //!< If not 0, number of frames to keep the same color
 
+    /**
+     * Update the BufferObjects cache if objects were added or removed
+     */
+    void updateBufferObjects();
+
+    /**
+     * Wait for BufferObjects to signal that they have a new buffer
+     * \param timeout Timeout in us
+     * \return Return the names of the ready objects, which is empty if the timeout has been reached
+     */
+    std::vector<std::string> waitForReadyBufferObjects(uint64_t timeout);
+
+    /**
+     * Update and send the given BufferObjects, if they have a new buffer
+     * \param names Object names
+     */
+    void sendReadyBufferObjects(const std::vector<std::string>& names);
+
+    /**
+     * Serialize and send the given BufferObjects in parallel, then signal the Scenes. Must not be called with _configurationMutex or _objectsMutex held
+     * \param objects Objects to send
+     */
+    void sendBufferObjects(const std::vector<std::shared_ptr<BufferObject>>& objects);
+
     /**
      * Add an object to the world (used for Images and Meshes currently)
      * \param type Object type
@@ -198,6 +231,12 @@ class World : public RootObject
      */
     bool handleSerializedObject(const std::string& name, SerializedObject& obj) override;
 
+    /**
+     * Redefinition of a method from RootObject. Queue the object for its buffer to be sent right away
+     * \param name Name of the updated object
+     */
+    void signalBufferObjectReady(const std::string& name) override;
+
     /**
      * Handle the exit signal messages
      */
@@ -1,7 +1,9 @@
 #include "./graphics/camera.h"
 
+#include <cstddef>
 #include <fstream>
 #include <limits>
+#include <random>
 
 #include <glm/ext.hpp>
 #include <glm/glm.hpp>
@@ -20,6 +22,7 @@
 #include "./utils/cgutils.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
+#include "./utils/thread_pool.h"
 #include "./utils/timer.h"
 
 #define SCISSOR_WIDTH 8
@@ -92,6 +95,9 @@ Camera::~Camera()
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Camera::~Camera - Destructor" << Log::endl;
 #endif
+
+    if (_uniformBuffer != 0)
+        glDeleteBuffers(1, &_uniformBuffer);
 }
 
 /*************/
@@ -129,14 +135,14 @@ void Camera::computeVertexVisibility()
 {
     // We want to render the object with a specific texture, containing the primitive IDs
     std::vector<Values> shaderFill;
-    int primitiveIdShift = 0; // The primitive ID is shifted by the number of vertices already drawn
+    int primitiveIdShift = 0; // The primitive ID is shifted by the number of primitives already drawn
     for (auto& o : _objects)
     {
         if (o.expired())
             continue;
         auto obj = o.lock();
         obj->resetVisibility(primitiveIdShift);
-        primitiveIdShift += obj->getVerticesNumber() / 3;
+        primitiveIdShift += obj->getPrimitivesNumber();
 
         Values fill;
         obj->getAttribute("fill", fill);
@@ -181,7 +187,7 @@ void Camera::computeVertexVisibility()
         auto obj = o.lock();
 
         obj->transferVisibilityFromTexToAttr(_width, _height, primitiveIdShift);
-        primitiveIdShift += obj->getVerticesNumber() / 3;
+        primitiveIdShift += obj->getPrimitivesNumber();
     }
     _outFbo->getColorTexture()->unbind();
 }
@@ -219,119 +225,101 @@ bool Camera::doCalibration()
 
     _calibrationCalledOnce = true;
 
-    gsl_multimin_function calibrationFunc;
-    calibrationFunc.n = 9;
-    calibrationFunc.f = &Camera::calibrationCostFunc;
-    calibrationFunc.params = (void*)this;
-
     Log::get() << "Camera::" << __FUNCTION__ << " - Starting calibration..." << Log::endl;
 
-    const gsl_multimin_fminimizer_type* minimizerType = gsl_multimin_fminimizer_nmsimplex2rand;
-    // Variables we do not want to keep between tries
-    dvec3 eyeOriginal = _eye;
+    CalibrationParameters parameters;
+    for (const auto& point : _calibrationPoints)
+    {
+        if (!point.isSet)
+            continue;
 
-    double minValue = std::numeric_limits<double>::max();
-    std::vector<double> selectedValues(9);
+        parameters.objectPoints.push_back(point.world);
+        parameters.imagePoints.emplace_back((point.screen.x + 1.0) / 2.0 * _width, (point.screen.y + 1.0) / 2.0 * _height);
+        parameters.weights.push_back(point.weight);
+    }
+    parameters.width = _width;
+    parameters.height = _height;
+    parameters.near = _near;
+    parameters.far = _far;
+    parameters.weighted = _weightedCalibrationPoints;
+    parameters.fovLocked = operator[]("fov").isLocked();
+    parameters.fov = _fov;
+    parameters.principalPointLocked = operator[]("principalPoint").isLocked();
+    parameters.cx = _cx;
+    parameters.cy = _cy;
 
-    gsl_multimin_fminimizer* minimizer;
-    minimizer = gsl_multimin_fminimizer_alloc(minimizerType, 9);
-    gsl_vector* x = gsl_vector_alloc(9);
-    gsl_vector* step = gsl_vector_alloc(9);
-    gsl_vector_set(step, 0, 10.0);
-    gsl_vector_set(step, 1, 0.1);
-    gsl_vector_set(step, 2, 0.1);
-    for (int i = 3; i < 6; ++i)
-        gsl_vector_set(step, i, 1.0);
-    for (int i = 3; i < 9; ++i)
-        gsl_vector_set(step, i, M_PI / 4.0);
+    // Variables we do not want to keep between tries
+    dvec3 eyeOriginal = _eye;
 
-    // First step: find a rough estimate, quickly
+    // First step: find a rough estimate, quickly, from a grid of start points minimized in parallel.
+    // Each start point draws from its own generator, so that the result does not depend on scheduling
+    std::vector<std::array<double, 9>> startPoints;
+    std::uniform_real_distribution<double> unitDistribution(0.0, 1.0);
     for (double s = 0.0; s <= 1.3; s += 0.3)
     {
         for (double t = 0.0; t <= 1.3; t += 0.3)
         {
-            gsl_vector_set(x, 0, 50.0 + (static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0 - 1.0) * 25.0);
-            gsl_vector_set(x, 1, s);
-            gsl_vector_set(x, 2, t);
+            std::mt19937 randomGenerator(_calibrationSeed + startPoints.size());
+            std::array<double, 9> start;
+            start[0] = 50.0 + (unitDistribution(randomGenerator) * 2.0 - 1.0) * 25.0;
+            start[1] = s;
+            start[2] = t;
             for (int i = 0; i < 3; ++i)
             {
-                gsl_vector_set(x, i + 3, eyeOriginal[i]);
-                gsl_vector_set(x, i + 6, static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * M_PI * 2.0);
-            }
-
-            gsl_multimin_fminimizer_set(minimizer, &calibrationFunc, x, step);
-
-            size_t iter = 0;
-            int status = GSL_CONTINUE;
-            double localMinimum = std::numeric_limits<double>::max();
-            while (status == GSL_CONTINUE && iter < 1000 && localMinimum > 64.0)
-            {
-                iter++;
-                status = gsl_multimin_fminimizer_iterate(minimizer);
-                if (status)
-                {
-                    Log::get() << Log::WARNING << "Camera::" << __FUNCTION__ << " - An error has occured during minimization" << Log::endl;
-                    break;
-                }
-
-                status = gsl_multimin_test_size(minimizer->size, 1e-2);
-                localMinimum = gsl_multimin_fminimizer_minimum(minimizer);
-            }
-
-            if (localMinimum < minValue)
-            {
-                minValue = localMinimum;
-                for (int i = 0; i < 9; ++i)
-                    selectedValues[i] = gsl_vector_get(minimizer->x, i);
+                start[i + 3] = eyeOriginal[i];
+                start[i + 6] = unitDistribution(randomGenerator) * M_PI * 2.0;
             }
+            startPoints.push_back(start);
         }
     }
 
+    std::array<double, 9> step;
+    step[0] = 10.0;
+    step[1] = 0.1;
+    step[2] = 0.1;
+    for (int i = 3; i < 6; ++i)
+        step[i] = 1.0;
+    for (int i = 3; i < 9; ++i)
+        step[i] = M_PI / 4.0;
+
+    std::vector<CalibrationResult> results(startPoints.size());
+    ThreadPool::get().parallelFor(
+        startPoints.size(),
+        [&](size_t index) {
+            // The randomized simplex keeps some state between runs, so each start point gets its own minimizer
+            auto minimizer = gsl_multimin_fminimizer_alloc(gsl_multimin_fminimizer_nmsimplex2rand, 9);
+            results[index] = minimizeCalibration(minimizer, parameters, startPoints[index], step, 1000, 1e-2, 64.0);
+            gsl_multimin_fminimizer_free(minimizer);
+        },
+        ThreadPool::Priority::Normal);
+
+    // Results are compared in start point order, for the selection to be deterministic
+    CalibrationResult bestResult;
+    for (const auto& result : results)
+        if (result.minimum < bestResult.minimum)
+            bestResult = result;
+
     // Second step: we improve on the best result from the previous step
+    step[0] = 1.0;
+    step[1] = 0.05;
+    step[2] = 0.05;
+    for (int i = 3; i < 6; ++i)
+        step[i] = 0.1;
+    for (int i = 3; i < 9; ++i)
+        step[i] = M_PI / 10.0;
+
+    auto minimizer = gsl_multimin_fminimizer_alloc(gsl_multimin_fminimizer_nmsimplex2rand, 9);
     for (int index = 0; index < 8; ++index)
     {
-        gsl_vector_set(step, 0, 1.0);
-        gsl_vector_set(step, 1, 0.05);
-        gsl_vector_set(step, 2, 0.05);
-        for (int i = 3; i < 6; ++i)
-            gsl_vector_set(step, i, 0.1);
-        for (int i = 3; i < 9; ++i)
-            gsl_vector_set(step, i, M_PI / 10.0);
-
-        for (int i = 0; i < 9; ++i)
-            gsl_vector_set(x, i, selectedValues[i]);
-
-        gsl_multimin_fminimizer_set(minimizer, &calibrationFunc, x, step);
-
-        size_t iter = 0;
-        int status = GSL_CONTINUE;
-        double localMinimum = std::numeric_limits<double>::max();
-        while (status == GSL_CONTINUE && iter < 10000 && localMinimum > 0.5)
-        {
-            iter++;
-            status = gsl_multimin_fminimizer_iterate(minimizer);
-            if (status)
-            {
-                Log::get() << Log::WARNING << "Camera::" << __FUNCTION__ << " - An error has occured during minimization" << Log::endl;
-                break;
-            }
-
-            status = gsl_multimin_test_size(minimizer->size, 1e-7);
-            localMinimum = gsl_multimin_fminimizer_minimum(minimizer);
-        }
-
-        if (localMinimum < minValue)
-        {
-            minValue = localMinimum;
-            for (int i = 0; i < 9; ++i)
-                selectedValues[i] = gsl_vector_get(minimizer->x, i);
-        }
+        const auto result = minimizeCalibration(minimizer, parameters, bestResult.values, step, 10000, 1e-7, 0.5);
+        if (result.minimum < bestResult.minimum)
+            bestResult = result;
     }
-
-    gsl_vector_free(x);
-    gsl_vector_free(step);
     gsl_multimin_fminimizer_free(minimizer);
 
+    const auto minValue = bestResult.minimum;
+    const auto& selectedValues = bestResult.values;
+
     // If the result is good enough, apply it. Otherwise, drop!
     if (minValue > 1000.0)
     {
@@ -614,6 +602,9 @@ void Camera::render()
         const auto viewMatrix = computeViewMatrix();
         const auto projectionMatrix = computeProjectionMatrix();
 
+        // The parameters common to all objects are set once, in the uniform block read by their shaders
+        updateUniformBuffer();
+
         // Draw the objects
         for (auto& o : _objects)
         {
@@ -628,29 +619,6 @@ void Camera::render()
             if (!objShader)
                 continue;
 
-            vec2 colorBalance = colorBalanceFromTemperature(_colorTemperature);
-            objShader->setAttribute("uniform", {"_wireframeColor", _wireframeColor.x, _wireframeColor.y, _wireframeColor.z, _wireframeColor.w});
-            objShader->setAttribute("uniform", {"_cameraAttributes", _blendWidth, _brightness, _saturation, _contrast});
-            objShader->setAttribute("uniform", {"_fovAndColorBalance", _fov * _width / _height * M_PI / 180.0, _fov * M_PI / 180.0, colorBalance.x, colorBalance.y});
-            objShader->setAttribute("uniform", {"_showCameraCount", (int)_showCameraCount});
-            if (_colorLUT.size() == _colorLUTSize * 3 && _isColorLUTActivated)
-            {
-                objShader->setAttribute("uniform", {"_colorLUT", _colorLUT});
-                objShader->setAttribute("uniform", {"_isColorLUT", 1});
-                objShader->setAttribute("uniform", {"_colorLUTSize", _colorLUTSize});
-
-                Values m(10);
-                m[0] = "_colorMixMatrix";
-                for (int u = 0; u < 3; ++u)
-                    for (int v = 0; v < 3; ++v)
-                        m[u * 3 + v + 1] = _colorMixMatrix[u][v];
-                objShader->setAttribute("uniform", m);
-            }
-            else
-            {
-                objShader->setAttribute("uniform", {"_isColorLUT", 0});
-            }
-
             obj->setViewProjectionMatrix(viewMatrix, projectionMatrix);
             obj->draw();
             obj->deactivate();
@@ -933,23 +901,23 @@ double Camera::calibrationCostFunc(const gsl_vector* v, void* params)
     if (params == NULL)
         return 0.0;
 
-    Camera& camera = *(Camera*)params;
+    const auto& parameters = *static_cast<const CalibrationParameters*>(params);
 
     double fov = gsl_vector_get(v, 0);
     double cx = gsl_vector_get(v, 1);
     double cy = gsl_vector_get(v, 2);
 
     // Check whether the camera parameters are locked
-    if (camera["fov"].isLocked())
-        fov = camera["fov"]()[0].as<float>();
-    if (camera["principalPoint"].isLocked())
+    if (parameters.fovLocked)
+        fov = parameters.fov;
+    if (parameters.principalPointLocked)
     {
-        cx = camera["principalPoint"]()[0].as<float>();
-        cy = camera["principalPoint"]()[1].as<float>();
+        cx = parameters.cx;
+        cy = parameters.cy;
     }
 
     // Some limits for the calibration parameters
-    if (fov < 4.0 || fov > 120.0 || abs(cx - 0.5) > 1.0 || abs(cy - 0.5) > 1.0)
+    if (fov < 4.0 || fov > 120.0 || std::abs(cx - 0.5) > 1.0 || std::abs(cy - 0.5) > 1.0)
         return std::numeric_limits<double>::max();
 
     dvec3 eye;
@@ -971,42 +939,32 @@ double Camera::calibrationCostFunc(const gsl_vector* v, void* params)
     }
     target += eye;
 
-    std::vector<dvec3> objectPoints;
-    std::vector<dvec3> imagePoints;
-    std::vector<float> pointsWeight;
-    for (auto& point : camera._calibrationPoints)
-    {
-        if (!point.isSet)
-            continue;
-
-        objectPoints.emplace_back(dvec3(point.world.x, point.world.y, point.world.z));
-        imagePoints.emplace_back(dvec3((point.screen.x + 1.0) / 2.0 * camera._width, (point.screen.y + 1.0) / 2.0 * camera._height, 0.0));
-        pointsWeight.push_back(point.weight);
-    }
-
 #ifdef DEBUG
-    Log::get() << Log::DEBUGGING << "Camera::" << __FUNCTION__ << " - Values for the current iteration (fov, cx, cy): " << fov << " " << camera._width - cx << " "
-               << camera._height - cy << Log::endl;
+    Log::get() << Log::DEBUGGING << "Camera::" << __FUNCTION__ << " - Values for the current iteration (fov, cx, cy): " << fov << " " << parameters.width - cx << " "
+               << parameters.height - cy << Log::endl;
 #endif
 
     dmat4 lookM = lookAt(eye, target, up);
-    dmat4 projM = dmat4(getProjectionMatrix(fov, camera._near, camera._far, camera._width, camera._height, cx, cy));
-    dvec4 viewport(0, 0, camera._width, camera._height);
+    dmat4 projM = dmat4(getProjectionMatrix(fov, parameters.near, parameters.far, parameters.width, parameters.height, cx, cy));
+    // Same as glm::project, with the matrices multiplied once for all points
+    dmat4 projLookM = projM * lookM;
 
     // Project all the object points, and measure the distance between them and the image points
     double summedDistance = 0.0;
-    for (uint32_t i = 0; i < imagePoints.size(); ++i)
+    const auto pointCount = parameters.objectPoints.size();
+    for (size_t i = 0; i < pointCount; ++i)
     {
-        dvec3 projectedPoint;
-        projectedPoint = project(objectPoints[i], lookM, projM, viewport);
-        projectedPoint.z = 0.0;
+        dvec4 projectedPoint = projLookM * dvec4(parameters.objectPoints[i], 1.0);
+        projectedPoint /= projectedPoint.w;
+        const double dx = parameters.imagePoints[i].x - (projectedPoint.x * 0.5 + 0.5) * parameters.width;
+        const double dy = parameters.imagePoints[i].y - (projectedPoint.y * 0.5 + 0.5) * parameters.height;
 
-        if (camera._weightedCalibrationPoints)
-            summedDistance += pointsWeight[i] * pow(imagePoints[i].x - projectedPoint.x, 2.0) + pow(imagePoints[i].y - projectedPoint.y, 2.0);
+        if (parameters.weighted)
+            summedDistance += parameters.weights[i] * dx * dx + dy * dy;
         else
-            summedDistance += pow(imagePoints[i].x - projectedPoint.x, 2.0) + pow(imagePoints[i].y - projectedPoint.y, 2.0);
+            summedDistance += dx * dx + dy * dy;
     }
-    summedDistance /= imagePoints.size();
+    summedDistance /= pointCount;
 
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Camera::" << __FUNCTION__ << " - Actual summed distance: " << summedDistance << Log::endl;
@@ -1015,6 +973,58 @@ double Camera::calibrationCostFunc(const gsl_vector* v, void* params)
     return summedDistance;
 }
 
+/*************/
+Camera::CalibrationResult Camera::minimizeCalibration(gsl_multimin_fminimizer* minimizer,
+    const CalibrationParameters& params,
+    const std::array<double, 9>& start,
+    const std::array<double, 9>& step,
+    size_t maxIterations,
+    double sizeThreshold,
+    double targetMinimum)
+{
+    gsl_multimin_function calibrationFunc;
+    calibrationFunc.n = 9;
+    calibrationFunc.f = &Camera::calibrationCostFunc;
+    calibrationFunc.params = const_cast<CalibrationParameters*>(&params);
+
+    gsl_vector* x = gsl_vector_alloc(9);
+    gsl_vector* stepSize = gsl_vector_alloc(9);
+    for (size_t i = 0; i < 9; ++i)
+    {
+        gsl_vector_set(x, i, start[i]);
+        gsl_vector_set(stepSize, i, step[i]);
+    }
+
+    gsl_multimin_fminimizer_set(minimizer, &calibrationFunc, x, stepSize);
+
+    size_t iter = 0;
+    int status = GSL_CONTINUE;
+    double localMinimum = std::numeric_limits<double>::max();
+    while (status == GSL_CONTINUE && iter < maxIterations && localMinimum > targetMinimum)
+    {
+        iter++;
+        status = gsl_multimin_fminimizer_iterate(minimizer);
+        if (status)
+        {
+            Log::get() << Log::WARNING << "Camera::" << __FUNCTION__ << " - An error has occured during minimization" << Log::endl;
+            break;
+        }
+
+        status = gsl_multimin_test_size(minimizer->size, sizeThreshold);
+        localMinimum = gsl_multimin_fminimizer_minimum(minimizer);
+    }
+
+    CalibrationResult result;
+    result.minimum = localMinimum;
+    for (size_t i = 0; i < 9; ++i)
+        result.values[i] = gsl_vector_get(minimizer->x, i);
+
+    gsl_vector_free(x);
+    gsl_vector_free(stepSize);
+
+    return result;
+}
+
 /*************/
 dmat4 Camera::computeProjectionMatrix()
 {
@@ -1086,6 +1096,39 @@ void Camera::sendCalibrationPointsToObjects()
     }
 }
 
+/*************/
+void Camera::updateUniformBuffer()
+{
+    if (_uniformBuffer == 0)
+    {
+        glCreateBuffers(1, &_uniformBuffer);
+        glNamedBufferStorage(_uniformBuffer, sizeof(UniformBlock), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    }
+
+    UniformBlock block{};
+    const auto colorBalance = colorBalanceFromTemperature(_colorTemperature);
+    block.cameraAttributes = vec4(_blendWidth, _brightness, _saturation, _contrast);
+    block.fovAndColorBalance = vec4(_fov * _width / _height * M_PI / 180.0, _fov * M_PI / 180.0, colorBalance.x, colorBalance.y);
+    block.wireframeColor = vec4(_wireframeColor);
+    block.showCameraCount = _showCameraCount;
+    for (int u = 0; u < 3; ++u)
+        block.colorMixMatrix[u] = vec4(_colorMixMatrix[u], 0.f);
+
+    // Only the LUT entries in use are uploaded
+    size_t uploadSize = offsetof(UniformBlock, colorLUT);
+    if (_colorLUT.size() == _colorLUTSize * 3 && _isColorLUTActivated && _colorLUTSize <= 256)
+    {
+        block.isColorLUT = 1;
+        block.colorLUTSize = static_cast<int32_t>(_colorLUTSize);
+        for (uint64_t i = 0; i < _colorLUTSize; ++i)
+            block.colorLUT[i] = vec4(_colorLUT[i * 3].as<float>(), _colorLUT[i * 3 + 1].as<float>(), _colorLUT[i * 3 + 2].as<float>(), 0.f);
+        uploadSize += _colorLUTSize * sizeof(vec4);
+    }
+
+    glNamedBufferSubData(_uniformBuffer, 0, uploadSize, &block);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::getUniformBlockBinding("_cameraUniforms"), _uniformBuffer);
+}
+
 /*************/
 void Camera::registerAttributes()
 {
@@ -1102,6 +1145,7 @@ void Camera::registerAttributes()
         },
         {'r', 'r', 'r'});
     setAttributeDescription("eye", "Set the camera position");
+    setAttributeVolatile("eye", true);
 
     addAttribute(
         "target",
@@ -1114,6 +1158,7 @@ void Camera::registerAttributes()
         },
         {'r', 'r', 'r'});
     setAttributeDescription("target", "Set the camera target position");
+    setAttributeVolatile("target", true);
 
     addAttribute(
         "fov",
@@ -1124,6 +1169,7 @@ void Camera::registerAttributes()
         [&]() -> Values { return {_fov}; },
         {'r'});
     setAttributeDescription("fov", "Set the camera field of view");
+    setAttributeVolatile("fov", true);
 
     addAttribute(
         "up",
@@ -1136,6 +1182,7 @@ void Camera::registerAttributes()
         },
         {'r', 'r', 'r'});
     setAttributeDescription("up", "Set the camera up vector");
+    setAttributeVolatile("up", true);
 
     addAttribute(
         "size",
@@ -1182,6 +1229,7 @@ void Camera::registerAttributes()
         },
         {'r', 'r'});
     setAttributeDescription("principalPoint", "Set the principal point of the lens (for lens shifting)");
+    setAttributeVolatile("principalPoint", true);
 
     addAttribute(
         "weightedCalibrationPoints",
@@ -1399,6 +1447,7 @@ void Camera::registerAttributes()
         },
         {});
     setAttributeDescription("calibrationPoints", "Set multiple calibration points, as an array of 6D vector (position, projection and status)");
+    setAttributeVolatile("calibrationPoints", true);
 
     // Rendering options
     addAttribute(
@@ -1660,10 +1709,12 @@ void Camera::registerAttributes()
     addAttribute(
         "buffer", [&](const Values&) { return true; }, [&]() -> Values { return {_mipmapBuffer}; }, {});
     setAttributeDescription("buffer", "Getter attribute which gives access to the mipmap image, if grabMipmapLevel is greater or equal to 0");
+    setAttributeVolatile("buffer", true);
 
     addAttribute(
         "bufferSpec", [&](const Values&) { return true; }, [&]() -> Values { return _mipmapBufferSpec; }, {});
     setAttributeDescription("bufferSpec", "Getter attribute to the specs of the attribute buffer");
+    setAttributeVolatile("bufferSpec", true);
 
     //
     // Various options
@@ -25,7 +25,9 @@
 #ifndef SPLASH_CAMERA_H
 #define SPLASH_CAMERA_H
 
+#include <array>
 #include <functional>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
@@ -263,6 +265,22 @@ class Camera : public GraphObject
     glm::dvec4 _clearColor{0.6, 0.6, 0.6, 1.0};
     glm::dvec4 _wireframeColor{1.0, 1.0, 1.0, 1.0};
 
+    // Parameters shared by all the objects drawn by the camera, laid out as the std140 _cameraUniforms block
+    struct UniformBlock
+    {
+        glm::vec4 cameraAttributes;   //!< blendWidth, brightness, saturation, contrast
+        glm::vec4 fovAndColorBalance; //!< fovX and fovY, r/g and b/g
+        glm::vec4 wireframeColor;
+        int32_t showCameraCount;
+        int32_t isColorLUT;
+        int32_t colorLUTSize;
+        int32_t padding;
+        glm::vec4 colorMixMatrix[3]; //!< mat3 columns are aligned as vec4
+        glm::vec4 colorLUT[256];     //!< vec3 array elements are aligned as vec4
+    };
+    static_assert(sizeof(UniformBlock) == 4208, "Camera::UniformBlock does not match the std140 layout of _cameraUniforms");
+    GLuint _uniformBuffer{0};
+
     // Mipmap capture
     int _grabMipmapLevel{-1};
     Value _mipmapBuffer{};
@@ -271,7 +289,7 @@ class Camera : public GraphObject
     // Color correction
     Values _colorLUT{0};
     bool _isColorLUTActivated{false};
-    glm::mat3 _colorMixMatrix;
+    glm::mat3 _colorMixMatrix{1.f};
     Values _colorCurves{0};
     Values _whitePoint{0};
     uint _colorSamples{0};
@@ -335,9 +353,52 @@ class Camera : public GraphObject
     };
     std::list<Drawable> _drawables;
 
+    //! Calibration data, gathered once before minimizing so that the cost function neither locks nor allocates
+    struct CalibrationParameters
+    {
+        std::vector<glm::dvec3> objectPoints{};
+        std::vector<glm::dvec2> imagePoints{};
+        std::vector<double> weights{};
+        double width{0.0}, height{0.0};
+        double near{0.0}, far{0.0};
+        bool weighted{true};
+        bool fovLocked{false};
+        double fov{0.0};
+        bool principalPointLocked{false};
+        double cx{0.0}, cy{0.0};
+    };
+
+    //! Result of a single minimization of the calibration cost function
+    struct CalibrationResult
+    {
+        double minimum{std::numeric_limits<double>::max()};
+        std::array<double, 9> values{};
+    };
+
+    static const uint32_t _calibrationSeed{42}; //!< Seed for the random part of the calibration start points, for reproducible results
+
     // Function used for the calibration (camera parameters optimization)
     static double calibrationCostFunc(const gsl_vector* v, void* params);
 
+    /**
+     * Minimize the calibration cost function from the given start point, using a Nelder-Mead simplex
+     * \param minimizer Minimizer to use, of type nmsimplex2rand and dimension 9
+     * \param params Calibration parameters
+     * \param start Start point
+     * \param step Initial step sizes of the simplex
+     * \param maxIterations Maximum iteration count
+     * \param sizeThreshold Simplex size under which the minimization has converged
+     * \param targetMinimum Cost under which the minimization stops
+     * \return Return the minimum found and its location
+     */
+    static CalibrationResult minimizeCalibration(gsl_multimin_fminimizer* minimizer,
+        const CalibrationParameters& params,
+        const std::array<double, 9>& start,
+        const std::array<double, 9>& step,
+        size_t maxIterations,
+        double sizeThreshold,
+        double targetMinimum);
+
     /**
      * Load some defaults models, like the locator for calibration
      */
@@ -357,6 +418,11 @@ class Camera : public GraphObject
      * Register new functors to modify attributes
      */
     void registerAttributes();
+
+    /**
+     * Upload the camera parameters to the uniform buffer, and bind it to the _cameraUniforms block
+     */
+    void updateUniformBuffer();
 };
 
 } // namespace Splash
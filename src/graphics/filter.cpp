@@ -42,10 +42,11 @@ void Filter::bind()
 }
 
 /*************/
-std::unordered_map<std::string, Values> Filter::getShaderUniforms() const
+Texture::ShaderUniforms Filter::getShaderUniforms() const
 {
-    std::unordered_map<std::string, Values> uniforms;
-    uniforms["size"] = {static_cast<float>(_fbo->getColorTexture()->getSpec().width), static_cast<float>(_fbo->getColorTexture()->getSpec().height)};
+    ShaderUniforms uniforms;
+    const auto spec = _fbo->getColorTexture()->getSpec();
+    uniforms.size = glm::vec2(static_cast<float>(spec.width), static_cast<float>(spec.height));
     return uniforms;
 }
 
@@ -280,21 +281,15 @@ void Filter::updateUniforms()
             obj->getAttribute("duration", duration);
             obj->getAttribute("remaining", remainingTime);
             if (remainingTime.size() == 1)
-                shader->setAttribute("uniform", {"_filmRemaining", remainingTime[0].as<float>()});
+                shader->setUniform("_filmRemaining", {remainingTime[0].as<float>()});
             if (duration.size() == 1)
-                shader->setAttribute("uniform", {"_filmDuration", duration[0].as<float>()});
+                shader->setUniform("_filmDuration", {duration[0].as<float>()});
         }
     }
 
     // Update uniforms specific to the current filtering shader
-    for (auto& uniform : _filterUniforms)
-    {
-        Values param;
-        param.push_back(uniform.first);
-        for (auto& v : uniform.second)
-            param.push_back(v);
-        shader->setAttribute("uniform", param);
-    }
+    for (const auto& uniform : _filterUniforms)
+        shader->setUniform(uniform.first, uniform.second);
 }
 
 /*************/
@@ -318,6 +313,7 @@ void Filter::registerAttributes()
         },
         {});
     setAttributeDescription("size", "Size of the input texture");
+    setAttributeVolatile("size", true);
 
     addAttribute(
         "sizeOverride",
@@ -351,10 +347,12 @@ void Filter::registerAttributes()
     addAttribute(
         "buffer", [&](const Values&) { return true; }, [&]() -> Values { return {_mipmapBuffer}; }, {});
     setAttributeDescription("buffer", "Getter attribute which gives access to the mipmap image, if grabMipmapLevel is greater or equal to 0");
+    setAttributeVolatile("buffer", true);
 
     addAttribute(
         "bufferSpec", [&](const Values&) { return true; }, [&]() -> Values { return _mipmapBufferSpec; }, {});
     setAttributeDescription("bufferSpec", "Getter attribute to the specs of the attribute buffer");
+    setAttributeVolatile("bufferSpec", true);
 }
 
 /*************/
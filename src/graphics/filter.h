@@ -80,7 +80,7 @@ class Filter : public Texture
      * Get the shader parameters related to this texture
      * Texture should be locked first
      */
-    std::unordered_map<std::string, Values> getShaderUniforms() const override;
+    ShaderUniforms getShaderUniforms() const override;
 
     /**
      * Get specs of the texture
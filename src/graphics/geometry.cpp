@@ -53,6 +53,9 @@ Geometry::~Geometry()
 
     glDeleteQueries(1, &_feedbackQuery);
 
+    for (auto& readback : _readbacks)
+        releaseReadback(readback);
+
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Geometry::~Geometry - Destructor" << Log::endl;
 #endif
@@ -84,12 +87,16 @@ void Geometry::activateAsSharedBuffer()
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, _glBuffers[2]->getId());
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, _glBuffers[3]->getId());
     }
+
+    updateVisibilityBuffer();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, _glVisibilityBuffer->getId());
 }
 
 /*************/
 void Geometry::activateForFeedback()
 {
-    _feedbackMaxNbrPrimitives = std::max(_verticesNumber / 3, _feedbackMaxNbrPrimitives);
+    const auto primitivesNumber = (_indicesNumber != 0 ? _indicesNumber : _verticesNumber) / 3;
+    _feedbackMaxNbrPrimitives = std::max(primitivesNumber, _feedbackMaxNbrPrimitives);
     if (_glTemporaryBuffers.size() < _glBuffers.size() || _buffersDirty || _feedbackMaxNbrPrimitives * 6 > _temporaryBufferSize)
     {
         _temporaryBufferSize = _feedbackMaxNbrPrimitives * 6; // 3 vertices per primitive, times two to keep some margin for future updates
@@ -113,6 +120,10 @@ void Geometry::activateForFeedback()
         glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, i, _glTemporaryBuffers[i]->getId());
     }
 
+    // The tessellation shader reads the visibility of the input triangles
+    updateVisibilityBuffer();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, _glVisibilityBuffer->getId());
+
     glBeginQuery(GL_PRIMITIVES_GENERATED, _feedbackQuery);
 }
 
@@ -125,6 +136,15 @@ void Geometry::deactivate() const
     _mutex.unlock();
 }
 
+/*************/
+void Geometry::draw(GLenum mode) const
+{
+    if (isIndexed())
+        glDrawElements(mode, _indicesNumber, GL_UNSIGNED_INT, nullptr);
+    else
+        glDrawArrays(mode, 0, getVerticesNumber());
+}
+
 /*************/
 void Geometry::deactivateFeedback()
 {
@@ -158,33 +178,113 @@ std::vector<char> Geometry::getGpuBufferAsVector(Geometry::BufferType type)
         return _glBuffers[typeId]->getBufferAsVector();
 }
 
+/*************/
+Geometry::Readback* Geometry::issueReadback() const
+{
+    const auto verticesNumber = static_cast<size_t>(_alternativeVerticesNumber);
+    std::array<size_t, 4> streamSizes;
+    for (size_t i = 0; i < streamSizes.size(); ++i)
+        streamSizes[i] = _glAlternativeBuffers[i]->getComponentSize() * _glAlternativeBuffers[i]->getElementSize() * verticesNumber;
+
+    _readbackIndex = (_readbackIndex + 1) % _readbackRingSize;
+    auto& readback = _readbacks[_readbackIndex];
+
+    size_t totalSize = 0;
+    for (size_t i = 0; i < streamSizes.size(); ++i)
+    {
+        readback.offsets[i] = totalSize;
+        totalSize += streamSizes[i];
+    }
+
+    // Immutable storage can not be resized, so the buffer is recreated with some margin when it is too small
+    if (readback.capacity < totalSize || !readback.buffer)
+    {
+        releaseReadback(readback);
+        const auto capacity = std::max<size_t>(totalSize + totalSize / 2, 1);
+        const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glCreateBuffers(1, &readback.buffer);
+        glNamedBufferStorage(readback.buffer, capacity, nullptr, flags);
+        readback.mapping = static_cast<const uint8_t*>(glMapNamedBufferRange(readback.buffer, 0, capacity, flags));
+        if (!readback.mapping)
+        {
+            Log::get() << Log::WARNING << "Geometry::" << __FUNCTION__ << " - Unable to map the readback buffer" << Log::endl;
+            releaseReadback(readback);
+            return nullptr;
+        }
+        readback.capacity = capacity;
+    }
+
+    for (size_t i = 0; i < streamSizes.size(); ++i)
+        if (streamSizes[i] != 0)
+            glCopyNamedBufferSubData(_glAlternativeBuffers[i]->getId(), readback.buffer, 0, readback.offsets[i], streamSizes[i]);
+
+    glDeleteSync(readback.fence);
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.verticesNumber = _alternativeVerticesNumber;
+    readback.issueTime = chrono::steady_clock::now();
+
+    // Make sure the copy is submitted, so that the fence is signaled by the next call
+    glFlush();
+
+    return &readback;
+}
+
+/*************/
+void Geometry::releaseReadback(Readback& readback)
+{
+    glDeleteSync(readback.fence);
+    if (readback.buffer)
+    {
+        if (readback.mapping)
+            glUnmapNamedBuffer(readback.buffer);
+        glDeleteBuffers(1, &readback.buffer);
+    }
+    readback = Readback();
+}
+
 /*************/
 SerializedObject Geometry::serialize() const
 {
     if (std::any_of(_glAlternativeBuffers.cbegin(), _glAlternativeBuffers.cend(), [](const auto& buffer) { return buffer == nullptr; }))
         return {};
 
-    const auto vertices = _glAlternativeBuffers[0]->getBufferAsVector(_alternativeVerticesNumber);
-    const auto uvs = _glAlternativeBuffers[1]->getBufferAsVector(_alternativeVerticesNumber);
-    const auto normals = _glAlternativeBuffers[2]->getBufferAsVector(_alternativeVerticesNumber);
-    const auto annexe = _glAlternativeBuffers[3]->getBufferAsVector(_alternativeVerticesNumber);
+    const auto previousIndex = _readbackIndex;
+    auto readback = issueReadback();
+    if (!readback)
+        return {};
 
-    const auto verticesData = reinterpret_cast<const glm::vec4*>(vertices.data());
-    const auto uvsData = reinterpret_cast<const glm::vec2*>(uvs.data());
-    const auto normalsData = reinterpret_cast<const glm::vec4*>(normals.data());
-    const auto annexeData = reinterpret_cast<const glm::vec4*>(annexe.data());
+    // When serializing continuously, the readback issued by the previous call is used if the GPU is done with it,
+    // which sends the geometry with one call of latency but without stalling the pipeline. Otherwise the new
+    // readback is waited for, as the previous one is either missing, still in flight or too old.
+    auto& previous = _readbacks[previousIndex];
+    if (previous.fence && chrono::steady_clock::now() - previous.issueTime < _readbackMaxAge && glClientWaitSync(previous.fence, 0, 0) != GL_TIMEOUT_EXPIRED)
+    {
+        readback = &previous;
+    }
+    else
+    {
+        const auto waitResult = glClientWaitSync(readback->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        if (waitResult == GL_WAIT_FAILED)
+        {
+            Log::get() << Log::WARNING << "Geometry::" << __FUNCTION__ << " - Error while waiting for the buffers readback" << Log::endl;
+            return {};
+        }
+    }
 
-    const Mesh::MeshContainer mesh = {
-        .name = _name,
-        .vertices = std::vector<glm::vec4>(verticesData, verticesData + _alternativeVerticesNumber),
-        .uvs = std::vector<glm::vec2>(uvsData, uvsData + _alternativeVerticesNumber),
-        .normals = std::vector<glm::vec4>(normalsData, normalsData + _alternativeVerticesNumber),
-        .annexe = std::vector<glm::vec4>(annexeData, annexeData + _alternativeVerticesNumber),
-    };
+    // The buffers are written in place in the order of a serialized MeshContainer, without copying them to a mesh first
+    const auto mapping = readback->mapping;
+    const auto verticesNumber = readback->verticesNumber;
+    const auto serializedMesh = std::make_tuple(_name,
+        Span<const glm::vec4>(reinterpret_cast<const glm::vec4*>(mapping + readback->offsets[0]), verticesNumber),
+        Span<const glm::vec2>(reinterpret_cast<const glm::vec2*>(mapping + readback->offsets[1]), verticesNumber),
+        Span<const glm::vec4>(reinterpret_cast<const glm::vec4*>(mapping + readback->offsets[2]), verticesNumber),
+        Span<const glm::vec4>(reinterpret_cast<const glm::vec4*>(mapping + readback->offsets[3]), verticesNumber),
+        Span<const uint32_t>());
 
-    std::vector<uint8_t> data;
-    Serial::serialize(mesh, data);
-    SerializedObject serializedObject(ResizableArray(std::move(data)));
+    SerializedObject serializedObject(Serial::getSize(serializedMesh));
+    Span<uint8_t> output(serializedObject);
+    Serial::serializeTo(serializedMesh, output);
 
     return serializedObject;
 }
@@ -298,6 +398,13 @@ void Geometry::update()
         else
             _glBuffers[3] = std::make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _verticesNumber, nullptr);
 
+        std::vector<uint32_t> indices = _mesh->getIndices();
+        _indicesNumber = indices.size();
+        if (!indices.empty())
+            _glIndexBuffer = std::make_shared<GpuBuffer>(1, GL_UNSIGNED_INT, GL_STATIC_DRAW, _indicesNumber, indices.data());
+        else
+            _glIndexBuffer.reset();
+
         for (auto& v : _vertexArray)
             glDeleteVertexArrays(1, &(v.second));
         _vertexArray.clear();
@@ -393,6 +500,9 @@ void Geometry::update()
             glEnableVertexAttribArray((GLuint)idx);
         }
 
+        // The index buffer is part of the vertex array state
+        glVertexArrayElementBuffer(vertexArrayIt->second, isIndexed() ? _glIndexBuffer->getId() : 0);
+
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
 
@@ -400,6 +510,14 @@ void Geometry::update()
     }
 }
 
+/*************/
+void Geometry::updateVisibilityBuffer()
+{
+    const auto primitivesNumber = static_cast<size_t>(std::max(getPrimitivesNumber(), 1));
+    if (!_glVisibilityBuffer || _glVisibilityBuffer->getSize() < primitivesNumber)
+        _glVisibilityBuffer = std::make_shared<GpuBuffer>(1, GL_FLOAT, GL_DYNAMIC_DRAW, primitivesNumber);
+}
+
 /*************/
 void Geometry::useAlternativeBuffers(bool isActive)
 {
@@ -90,6 +90,12 @@ class Geometry : public BufferObject
      */
     void deactivate() const;
 
+    /**
+     * Draw the geometry, which has to be activated. Indexed buffers are drawn with their index buffer
+     * \param mode Primitive type, usually GL_TRIANGLES or GL_PATCHES
+     */
+    void draw(GLenum mode) const;
+
     /**
      * Deactivate for feedback
      */
@@ -108,6 +114,18 @@ class Geometry : public BufferObject
      */
     int getVerticesNumber() const { return _useAlternativeBuffers ? _alternativeVerticesNumber : _verticesNumber; }
 
+    /**
+     * Get the number of triangles for this geometry
+     * \return Return the triangle count
+     */
+    int getPrimitivesNumber() const { return (isIndexed() ? _indicesNumber : getVerticesNumber()) / 3; }
+
+    /**
+     * Get whether the current buffers are drawn with an index buffer. The alternative buffers, filled by feedback, never are
+     * \return Return true if the geometry is indexed
+     */
+    bool isIndexed() const { return !_useAlternativeBuffers && _indicesNumber != 0; }
+
     /**
      * Get the geometry as serialized
      * \return Return the serialized geometry
@@ -185,11 +203,14 @@ class Geometry : public BufferObject
     std::array<std::shared_ptr<GpuBuffer>, 4> _glBuffers{};
     std::array<std::shared_ptr<GpuBuffer>, 4> _glAlternativeBuffers{}; // Alternative buffers used for rendering
     std::array<std::shared_ptr<GpuBuffer>, 4> _glTemporaryBuffers{};   // Temporary buffers used for feedback
+    std::shared_ptr<GpuBuffer> _glIndexBuffer{nullptr};                // Triangle indices into _glBuffers, if the mesh is indexed
+    std::shared_ptr<GpuBuffer> _glVisibilityBuffer{nullptr};           // Per-triangle visibility, filled by the blending compute shaders
     bool _buffersDirty{false};
     bool _buffersResized{false}; // Holds whether the alternative buffers have been resized in the previous feedback
     bool _useAlternativeBuffers{false};
 
     int _verticesNumber{0};
+    int _indicesNumber{0};
     int _alternativeVerticesNumber{0};
     int _alternativeBufferSize{0};
     int _temporaryVerticesNumber{0};
@@ -199,11 +220,45 @@ class Geometry : public BufferObject
     GLuint _feedbackQuery;
     int _feedbackMaxNbrPrimitives{0};
 
+    // Asynchronous readback of the alternative buffers, used for serialization.
+    // The four streams are packed in a single persistently mapped buffer per slot
+    struct Readback
+    {
+        GLuint buffer{0};
+        const uint8_t* mapping{nullptr};
+        size_t capacity{0};
+        std::array<size_t, 4> offsets{};
+        int verticesNumber{0};
+        GLsync fence{nullptr};
+        std::chrono::steady_clock::time_point issueTime{};
+    };
+    static constexpr size_t _readbackRingSize{3};
+    static constexpr std::chrono::milliseconds _readbackMaxAge{100}; //!< Older readbacks are considered outdated
+    mutable std::array<Readback, _readbackRingSize> _readbacks{};
+    mutable size_t _readbackIndex{0}; //!< Slot of the last issued readback
+
     /**
      * Initialization
      */
     void init();
 
+    /**
+     * Make sure the visibility buffer holds an entry per triangle of the current buffers
+     */
+    void updateVisibilityBuffer();
+
+    /**
+     * Copy the alternative buffers to the next readback slot, and insert a fence after the copy
+     * \return Return a pointer to the slot, or nullptr if the readback could not be issued
+     */
+    Readback* issueReadback() const;
+
+    /**
+     * Release the GL objects held by a readback slot
+     * \param readback Readback slot
+     */
+    static void releaseReadback(Readback& readback);
+
     /**
      * Register new functors to modify attributes
      */
@@ -60,61 +60,45 @@ void Object::activate()
     // Create and store the shader depending on its type
     auto shaderIt = _graphicsShaders.find(_fill);
     if (shaderIt == _graphicsShaders.end())
-    {
-        _shader = std::make_shared<Shader>();
-        _graphicsShaders[_fill] = _shader;
-    }
-    else
-    {
-        _shader = shaderIt->second;
-    }
-
-    // Set the shader depending on a few other parameters
-    Values shaderParameters{};
-    for (uint32_t i = 0; i < _textures.size(); ++i)
-        shaderParameters.push_back("TEX_" + std::to_string(i + 1));
-    shaderParameters.push_back("TEXCOUNT " + std::to_string(_textures.size()));
-
-    for (auto& p : _fillParameters)
-        shaderParameters.push_back(p);
-
-    if (_fill == "texture")
-    {
-        if (_vertexBlendingActive)
-        {
+        shaderIt = _graphicsShaders.emplace(_fill, GraphicsShader(std::make_shared<Shader>())).first;
+    auto& graphicsShader = shaderIt->second;
+    _shader = graphicsShader.shader;
+
+    // Set the shader variant depending on a few other parameters. The shader is only set up when it changes
+    const bool vertexBlending = _fill == "texture" && _vertexBlendingActive;
+    const bool textureRect = (_fill == "texture" || _fill == "filter") && _textures.size() > 0 && _textures[0]->getType() == "texture_syphon";
+    const bool textureSrgb = _textures.size() > 0 && _textures[0]->isSrgb();
+    uint32_t variant = static_cast<uint32_t>(_textures.size()) & SHADER_VARIANT_TEXTURE_COUNT_MASK;
+    if (vertexBlending)
+        variant |= SHADER_VARIANT_VERTEX_BLENDING;
+    if (textureRect)
+        variant |= SHADER_VARIANT_TEXTURE_RECT;
+    if (textureSrgb)
+        variant |= SHADER_VARIANT_TEXTURE_SRGB;
+
+    if (!graphicsShader.variantSet || graphicsShader.variant != variant)
+    {
+        Values shaderParameters{_fill};
+        for (uint32_t i = 0; i < _textures.size(); ++i)
+            shaderParameters.push_back("TEX_" + std::to_string(i + 1));
+        shaderParameters.push_back("TEXCOUNT " + std::to_string(_textures.size()));
+
+        for (auto& p : _fillParameters)
+            shaderParameters.push_back(p);
+
+        if (vertexBlending)
             shaderParameters.push_back("VERTEXBLENDING");
-            _shader->setAttribute("uniform", {"_farthestVertex", _farthestVisibleVertexDistance});
-        }
-
-        if (_textures.size() > 0 && _textures[0]->getType() == "texture_syphon")
-            shaderParameters.push_back("TEXTURE_RECT");
-
-        shaderParameters.push_front("texture");
-        _shader->setAttribute("fill", shaderParameters);
-    }
-    else if (_fill == "filter")
-    {
-        if (_textures.size() > 0 && _textures[0]->getType() == "texture_syphon")
+        if (textureRect)
             shaderParameters.push_back("TEXTURE_RECT");
+        if (textureSrgb)
+            shaderParameters.push_back("TEXTURE_SRGB");
 
-        shaderParameters.push_front("filter");
-        _shader->setAttribute("fill", shaderParameters);
-    }
-    else if (_fill == "window")
-    {
-        shaderParameters.push_front("window");
-        _shader->setAttribute("fill", shaderParameters);
-    }
-    else
-    {
-        shaderParameters.push_front(_fill);
         _shader->setAttribute("fill", shaderParameters);
+        graphicsShader.variant = variant;
+        graphicsShader.variantSet = true;
     }
 
-    // Set some uniforms
-    _shader->setAttribute("sideness", {_sideness});
-    _shader->setAttribute("uniform", {"_normalExp", _normalExponent});
-    _shader->setAttribute("uniform", {"_color", _color.r, _color.g, _color.b, _color.a});
+    _shader->setSideness(static_cast<Shader::Sideness>(_sideness));
 
     if (_geometries.size() > 0)
     {
@@ -123,27 +107,54 @@ void Object::activate()
     }
     _shader->activate();
 
+    // Set some uniforms, once the shader is active as its program may be shared with other objects
+    if (vertexBlending)
+        _shader->setUniform(graphicsShader.farthestVertexSlot, _farthestVisibleVertexDistance);
+    if (_fill == "primitiveId")
+        _shader->setUniform(graphicsShader.primitiveIdShiftSlot, _primitiveIdShift);
+    _shader->setUniform(graphicsShader.normalExpSlot, _normalExponent);
+    _shader->setUniform(graphicsShader.colorSlot, glm::vec4(_color));
+
+    for (auto unit = graphicsShader.textureSlots.size(); unit < _textures.size(); ++unit)
+    {
+        const auto prefix = _textures[unit]->getPrefix() + std::to_string(unit);
+        TextureSlots slots;
+        slots.sampler = _shader->getUniformSlot(prefix);
+        slots.size = _shader->getUniformSlot(prefix + "_size");
+        slots.flip = _shader->getUniformSlot(prefix + "_flip");
+        slots.flop = _shader->getUniformSlot(prefix + "_flop");
+        slots.encoding = _shader->getUniformSlot(prefix + "_encoding");
+        graphicsShader.textureSlots.push_back(slots);
+    }
+
     GLuint texUnit = 0;
     for (auto& t : _textures)
     {
         t->lock();
-        _shader->setTexture(t, texUnit, t->getPrefix() + std::to_string(texUnit));
+        const auto& slots = graphicsShader.textureSlots[texUnit];
+        _shader->setTexture(t, texUnit, slots.sampler);
 
         // Get texture specific uniforms and send them to the shader
-        auto texUniforms = t->getShaderUniforms();
-        for (auto u : texUniforms)
-        {
-            Values parameters;
-            parameters.push_back(Value(t->getPrefix() + std::to_string(texUnit) + "_" + u.first));
-            for (auto value : u.second)
-                parameters.push_back(value);
-            _shader->setAttribute("uniform", parameters);
-        }
+        const auto texUniforms = t->getShaderUniforms();
+        _shader->setUniform(slots.size, texUniforms.size);
+        _shader->setUniform(slots.flip, texUniforms.flip);
+        _shader->setUniform(slots.flop, texUniforms.flop);
+        _shader->setUniform(slots.encoding, texUniforms.encoding);
 
         texUnit++;
     }
 }
 
+/*************/
+Object::GraphicsShader::GraphicsShader(const std::shared_ptr<Shader>& shader)
+    : shader(shader)
+{
+    farthestVertexSlot = shader->getUniformSlot("_farthestVertex");
+    primitiveIdShiftSlot = shader->getUniformSlot("_primitiveIdShift");
+    normalExpSlot = shader->getUniformSlot("_normalExp");
+    colorSlot = shader->getUniformSlot("_color");
+}
+
 /*************/
 glm::dmat4 Object::computeModelMatrix() const
 {
@@ -206,7 +217,16 @@ void Object::draw()
         return;
 
     _shader->updateUniforms();
-    glDrawArrays(GL_TRIANGLES, 0, _geometries[0]->getVerticesNumber());
+    _geometries[0]->draw(GL_TRIANGLES);
+}
+
+/*************/
+int Object::getPrimitivesNumber() const
+{
+    int nbr = 0;
+    for (auto& g : _geometries)
+        nbr += g->getPrimitivesNumber();
+    return nbr;
 }
 
 /*************/
@@ -378,6 +398,9 @@ void Object::resetVisibility(int primitiveIdShift)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    // The shift is applied to the primitive IDs drawn by the primitiveId fill
+    _primitiveIdShift = primitiveIdShift;
+
     if (!_computeShaderResetVisibility)
     {
         _computeShaderResetVisibility = std::make_shared<Shader>(Shader::prgCompute);
@@ -390,10 +413,9 @@ void Object::resetVisibility(int primitiveIdShift)
         {
             geom->update();
             geom->activateAsSharedBuffer();
-            auto verticesNbr = geom->getVerticesNumber();
-            _computeShaderResetVisibility->setAttribute("uniform", {"_vertexNbr", verticesNbr});
-            _computeShaderResetVisibility->setAttribute("uniform", {"_primitiveIdShift", primitiveIdShift});
-            _computeShaderResetVisibility->doCompute(verticesNbr / 3 / 128 + 1);
+            auto primitivesNbr = geom->getPrimitivesNumber();
+            _computeShaderResetVisibility->setAttribute("uniform", {"_primitiveNbr", primitivesNbr});
+            _computeShaderResetVisibility->doCompute(primitivesNbr / 128 + 1);
             geom->deactivate();
         }
     }
@@ -479,7 +501,7 @@ void Object::tessellateForThisCamera(glm::dmat4 viewMatrix, glm::dmat4 projectio
 
             geom->activateForFeedback();
             _feedbackShaderSubdivideCamera->activate();
-            glDrawArrays(GL_PATCHES, 0, geom->getVerticesNumber());
+            geom->draw(GL_PATCHES);
             _feedbackShaderSubdivideCamera->deactivate();
 
             geom->deactivateFeedback();
@@ -513,6 +535,7 @@ void Object::transferVisibilityFromTexToAttr(int width, int height, int primitiv
     {
         geom->update();
         geom->activateAsSharedBuffer();
+        _computeShaderTransferVisibilityToAttr->setAttribute("uniform", {"_primitiveNbr", geom->getPrimitivesNumber()});
         _computeShaderTransferVisibilityToAttr->doCompute(width / 32 + 1, height / 32 + 1);
         glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
         geom->deactivate();
@@ -600,7 +623,7 @@ void Object::setViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4& mp)
 /*************/
 void Object::setShader(const std::shared_ptr<Shader>& shader)
 {
-    _graphicsShaders["userDefined"] = shader;
+    _graphicsShaders["userDefined"] = GraphicsShader(shader);
     _fill = "userDefined";
 }
 
@@ -690,6 +713,10 @@ void Object::registerAttributes()
             _fillParameters.clear();
             for (uint32_t i = 1; i < args.size(); ++i)
                 _fillParameters.push_back(args[i].as<std::string>());
+
+            // The shaders are set up again with the new parameters on next activation
+            for (auto& graphicsShader : _graphicsShaders)
+                graphicsShader.second.variantSet = false;
             return true;
         },
         [&]() -> Values { return {_fill}; },
@@ -146,6 +146,12 @@ class Object : public GraphObject
      */
     int getVerticesNumber() const;
 
+    /**
+     * Get the number of triangles for this object
+     * \return Return the number of triangles
+     */
+    int getPrimitivesNumber() const;
+
     /**
      * Get the coordinates of the closest vertex to the given point
      * \param p Coordinates around which to look
@@ -172,8 +178,8 @@ class Object : public GraphObject
     void resetTessellation();
 
     /**
-     * Reset the visibility flag, as well as the faces ID
-     * \param primitiveIdShift Shift for the ID of the vertices
+     * Reset the visibility flag of the faces, and set the shift of their ID
+     * \param primitiveIdShift Shift for the ID of the faces
      */
     void resetVisibility(int primitiveIdShift = 0);
 
@@ -243,8 +249,40 @@ class Object : public GraphObject
     std::shared_ptr<Shader> _computeShaderTransferVisibilityToAttr{};
     std::shared_ptr<Shader> _feedbackShaderSubdivideCamera{};
 
+    // Key of a graphics shader variant: the texture count, combined with these flags
+    static constexpr uint32_t SHADER_VARIANT_TEXTURE_COUNT_MASK = 0xFFFF;
+    static constexpr uint32_t SHADER_VARIANT_VERTEX_BLENDING = 1 << 16;
+    static constexpr uint32_t SHADER_VARIANT_TEXTURE_RECT = 1 << 17;
+    static constexpr uint32_t SHADER_VARIANT_TEXTURE_SRGB = 1 << 18;
+
+    // Slots of the uniforms related to a texture unit
+    struct TextureSlots
+    {
+        int sampler{-1};
+        int size{-1};
+        int flip{-1};
+        int flop{-1};
+        int encoding{-1};
+    };
+
+    // A graphics shader, along with its current variant and the slots of the uniforms set at each activation
+    struct GraphicsShader
+    {
+        std::shared_ptr<Shader> shader{};
+        uint32_t variant{0};
+        bool variantSet{false};
+        int farthestVertexSlot{-1};
+        int primitiveIdShiftSlot{-1};
+        int normalExpSlot{-1};
+        int colorSlot{-1};
+        std::vector<TextureSlots> textureSlots{};
+
+        GraphicsShader() = default;
+        explicit GraphicsShader(const std::shared_ptr<Shader>& shader);
+    };
+
     // A map for previously used graphics shaders
-    std::map<std::string, std::shared_ptr<Shader>> _graphicsShaders;
+    std::map<std::string, GraphicsShader> _graphicsShaders;
 
     std::vector<std::shared_ptr<Texture>> _textures;
     std::vector<std::shared_ptr<Geometry>> _geometries;
@@ -259,6 +297,7 @@ class Object : public GraphObject
     std::string _fill{"texture"};
     std::vector<std::string> _fillParameters{};
     int _sideness{0};
+    int _primitiveIdShift{0}; // Shift for the faces ID, when drawing them for visibility computation
     glm::dvec4 _color{0.0, 0.0, 0.0, 1.0};
     float _normalExponent{0.0};
 
@@ -1,5 +1,6 @@
 #include "./graphics/shader.h"
 
+#include <cstring>
 #include <fstream>
 #include <regex>
 
@@ -8,12 +9,19 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include "./graphics/shaderSources.h"
+#include "./graphics/shader_program_cache.h"
 #include "./utils/log.h"
 #include "./utils/timer.h"
 
 namespace Splash
 {
 
+std::atomic_uint64_t Shader::_nextUserId{0};
+std::mutex Shader::_programUniformsMutex;
+std::unordered_map<GLuint, Shader::ProgramUniforms> Shader::_programUniforms;
+std::mutex Shader::_uniformBlockBindingsMutex;
+std::unordered_map<std::string, GLuint> Shader::_uniformBlockBindings;
+
 /*************/
 Shader::Shader(ProgramType type)
     : GraphObject(nullptr)
@@ -23,9 +31,6 @@ Shader::Shader(ProgramType type)
     if (type == prgGraphic)
     {
         _programType = prgGraphic;
-        _shaders[vertex] = glCreateShader(GL_VERTEX_SHADER);
-        _shaders[geometry] = glCreateShader(GL_GEOMETRY_SHADER);
-        _shaders[fragment] = glCreateShader(GL_FRAGMENT_SHADER);
 
         registerGraphicAttributes();
 
@@ -34,7 +39,6 @@ Shader::Shader(ProgramType type)
     else if (type == prgCompute)
     {
         _programType = prgCompute;
-        _shaders[compute] = glCreateShader(GL_COMPUTE_SHADER);
 
         registerComputeAttributes();
 
@@ -43,10 +47,6 @@ Shader::Shader(ProgramType type)
     else if (type == prgFeedback)
     {
         _programType = prgFeedback;
-        _shaders[vertex] = glCreateShader(GL_VERTEX_SHADER);
-        _shaders[tess_ctrl] = glCreateShader(GL_TESS_CONTROL_SHADER);
-        _shaders[tess_eval] = glCreateShader(GL_TESS_EVALUATION_SHADER);
-        _shaders[geometry] = glCreateShader(GL_GEOMETRY_SHADER);
 
         registerFeedbackAttributes();
 
@@ -59,11 +59,10 @@ Shader::Shader(ProgramType type)
 /*************/
 Shader::~Shader()
 {
-    if (glIsProgram(_program))
-        glDeleteProgram(_program);
-    for (auto& shader : _shaders)
-        if (glIsShader(shader.second))
-            glDeleteShader(shader.second);
+    // The program belongs to the ShaderProgramCache, and may be used by other Shaders
+    for (auto& u : _uniforms)
+        if (u.second.glBuffer != 0)
+            glDeleteBuffers(1, &u.second.glBuffer);
 
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Shader::~Shader - Destructor" << Log::endl;
@@ -83,11 +82,14 @@ void Shader::activate()
         }
 
         _activated = true;
+        if (ShaderProgramCache::get().setLastUser(_program, _userId))
+            invalidateUniforms();
 
+        // Bindings are shared by all programs, so the uniform blocks set through this shader are bound again
         for (auto& u : _uniforms)
         {
-            if (u.second.type == "buffer")
-                glUniformBlockBinding(_program, u.second.glIndex, 1);
+            if (u.second.glBuffer != 0 && u.second.glBufferSize != 0 && u.second.glIndex != -1)
+                glBindBufferBase(GL_UNIFORM_BUFFER, u.second.glBinding, u.second.glBuffer);
         }
 
         glUseProgram(_program);
@@ -113,6 +115,8 @@ void Shader::activate()
         }
 
         _activated = true;
+        if (ShaderProgramCache::get().setLastUser(_program, _userId))
+            invalidateUniforms();
         glUseProgram(_program);
         updateUniforms();
         glEnable(GL_RASTERIZER_DISCARD);
@@ -160,6 +164,8 @@ void Shader::doCompute(GLuint numGroupsX, GLuint numGroupsY)
     }
 
     _activated = true;
+    if (ShaderProgramCache::get().setLastUser(_program, _userId))
+        invalidateUniforms();
     glUseProgram(_program);
     updateUniforms();
     glDispatchCompute(numGroupsX, numGroupsY, 1);
@@ -176,56 +182,26 @@ std::map<std::string, Values> Shader::getUniforms() const
 }
 
 /*************/
-bool Shader::setSource(const std::string& src, const ShaderType type)
+void Shader::setSource(const std::string& src, const ShaderType type)
 {
-    GLuint shader = _shaders[type];
-
     auto parsedSources = src;
     parseIncludes(parsedSources);
-    const char* shaderSrc = parsedSources.c_str();
-    glShaderSource(shader, 1, (const GLchar**)&shaderSrc, 0);
-    glCompileShader(shader);
-
-    GLint status;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-    if (status)
-    {
-#ifdef DEBUG
-        Log::get() << Log::DEBUGGING << "Shader::" << __FUNCTION__ << " - Shader of type " << stringFromShaderType(type) << " compiled successfully" << Log::endl;
-#endif
-    }
-    else
-    {
-        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error while compiling a shader of type " << stringFromShaderType(type) << Log::endl;
-        GLint length;
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
-        char* log = (char*)malloc(length);
-        glGetShaderInfoLog(shader, length, &length, log);
-        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error log: \n" << (const char*)log << Log::endl;
-        free(log);
-    }
-
     _shadersSource[type] = parsedSources;
     _isLinked = false;
-    return status;
 }
 
 /*************/
 bool Shader::setSource(const std::map<ShaderType, std::string>& sources)
 {
-    resetShader(vertex);
-    resetShader(geometry);
-    resetShader(fragment);
     _shadersSource.clear();
 
-    bool status = true;
     if (sources.find(ShaderType::vertex) == sources.end())
-        status = setSource(ShaderSources.VERSION_DIRECTIVE_GL4 + ShaderSources.VERTEX_SHADER_DEFAULT, ShaderType::vertex);
+        setSource(ShaderSources.VERSION_DIRECTIVE_GL4 + ShaderSources.VERTEX_SHADER_DEFAULT, ShaderType::vertex);
     for (auto& source : sources)
-        status = status && setSource(source.second, source.first);
+        setSource(source.second, source.first);
 
-    compileProgram();
-    return status;
+    // The program is built right away, for the caller to know whether the sources are valid
+    return linkProgram();
 }
 
 /*************/
@@ -240,7 +216,8 @@ bool Shader::setSourceFromFile(const std::string& filename, const ShaderType typ
         in.seekg(0, std::ios::beg);
         in.read(&contents[0], contents.size());
         in.close();
-        return setSource(contents, type);
+        setSource(contents, type);
+        return true;
     }
     else
     {
@@ -249,114 +226,215 @@ bool Shader::setSourceFromFile(const std::string& filename, const ShaderType typ
     }
 }
 
+/*************/
+void Shader::setSideness(const Sideness side)
+{
+    _sideness = side;
+}
+
 /*************/
 void Shader::setTexture(const std::shared_ptr<Texture>& texture, const GLuint textureUnit, const std::string& name)
 {
+    if (_uniforms.find(name) == _uniforms.end())
+        return;
+
+    setTexture(texture, textureUnit, getUniformSlot(name));
+}
+
+/*************/
+void Shader::setTexture(const std::shared_ptr<Texture>& texture, const GLuint textureUnit, int slot)
+{
+    assert(slot >= 0 && slot < static_cast<int>(_uniformSlots.size()));
+    if (_uniformSlots[slot]->glIndex == -1)
+        return;
+
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    texture->bind();
+    setUniform(slot, static_cast<int>(textureUnit));
+
+    _textures.push_back(texture);
+    if (_textureNbrSlot == -1)
+        _textureNbrSlot = getUniformSlot("_textureNbr");
+    setUniform(_textureNbrSlot, static_cast<int>(_textures.size()));
+}
+
+/*************/
+void Shader::setUniform(const std::string& name, const Values& values)
+{
+    // Check if the values changed from previous use
     auto uniformIt = _uniforms.find(name);
+    if (uniformIt != _uniforms.end() && !uniformIt->second.direct && Value(values) == Value(uniformIt->second.values))
+        return;
+    else if (uniformIt == _uniforms.end())
+        uniformIt = (_uniforms.emplace(make_pair(name, Uniform()))).first;
 
-    if (uniformIt != _uniforms.end())
-    {
-        auto& uniform = uniformIt->second;
-        if (uniform.glIndex == -1)
-            return;
+    uniformIt->second.values = values;
+    uniformIt->second.direct = false;
+    _uniformsToUpdate.push_back(name);
+}
 
-        glActiveTexture(GL_TEXTURE0 + textureUnit);
-        texture->bind();
+/*************/
+GLuint Shader::getUniformBlockBinding(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_uniformBlockBindingsMutex);
+    if (const auto bindingIt = _uniformBlockBindings.find(name); bindingIt != _uniformBlockBindings.end())
+        return bindingIt->second;
 
-        glUniform1i(uniform.glIndex, textureUnit);
+    const auto binding = static_cast<GLuint>(_uniformBlockBindings.size());
+    _uniformBlockBindings[name] = binding;
+    return binding;
+}
 
-        _textures.push_back(texture);
-        if ((uniformIt = _uniforms.find("_textureNbr")) != _uniforms.end())
-            if (uniformIt->second.glIndex != -1)
-            {
-                uniformIt->second.values = {(int)_textures.size()};
-                _uniformsToUpdate.push_back("_textureNbr");
-            }
-    }
+/*************/
+int Shader::getUniformSlot(const std::string& name)
+{
+    if (const auto slotIt = _uniformSlotIndices.find(name); slotIt != _uniformSlotIndices.end())
+        return slotIt->second;
+
+    // The uniform is resolved by the next link if it is not known yet
+    auto& uniform = _uniforms[name];
+    if (uniform.type.empty() && _isLinked)
+        uniform.glIndex = glGetUniformLocation(_program, name.c_str());
+
+    const auto slot = static_cast<int>(_uniformSlots.size());
+    _uniformSlots.push_back(&uniform);
+    _uniformSlotIndices[name] = slot;
+    return slot;
 }
 
 /*************/
-void Shader::setModelViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4& mp)
+void Shader::setUniform(int slot, int value)
 {
-    glm::mat4 floatMv = (glm::mat4)mv;
-    glm::mat4 floatMp = (glm::mat4)mp;
-    glm::mat4 floatMvp = (glm::mat4)(mp * mv);
+    assert(slot >= 0 && slot < static_cast<int>(_uniformSlots.size()));
+    auto& uniform = *_uniformSlots[slot];
+    if (!_isLinked || uniform.glIndex == -1)
+        return;
+    uniform.direct = true;
+    glProgramUniform1i(_program, uniform.glIndex, value);
+}
 
-    auto uniformIt = _uniforms.find("_modelViewProjectionMatrix");
-    if (uniformIt != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMvp));
+/*************/
+void Shader::setUniform(int slot, float value)
+{
+    assert(slot >= 0 && slot < static_cast<int>(_uniformSlots.size()));
+    auto& uniform = *_uniformSlots[slot];
+    if (!_isLinked || uniform.glIndex == -1)
+        return;
+    uniform.direct = true;
+    glProgramUniform1f(_program, uniform.glIndex, value);
+}
 
-    if ((uniformIt = _uniforms.find("_modelViewMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMv));
+/*************/
+void Shader::setUniform(int slot, const glm::vec2& value)
+{
+    assert(slot >= 0 && slot < static_cast<int>(_uniformSlots.size()));
+    auto& uniform = *_uniformSlots[slot];
+    if (!_isLinked || uniform.glIndex == -1)
+        return;
+    uniform.direct = true;
+    glProgramUniform2f(_program, uniform.glIndex, value.x, value.y);
+}
 
-    if ((uniformIt = _uniforms.find("_projectionMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMp));
+/*************/
+void Shader::setUniform(int slot, const glm::mat4& value)
+{
+    assert(slot >= 0 && slot < static_cast<int>(_uniformSlots.size()));
+    auto& uniform = *_uniformSlots[slot];
+    if (!_isLinked || uniform.glIndex == -1)
+        return;
+    uniform.direct = true;
+    glProgramUniformMatrix4fv(_program, uniform.glIndex, 1, GL_FALSE, glm::value_ptr(value));
+}
 
-    if ((uniformIt = _uniforms.find("_normalMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(floatMv))));
+/*************/
+void Shader::setUniform(int slot, const glm::vec4& value)
+{
+    assert(slot >= 0 && slot < static_cast<int>(_uniformSlots.size()));
+    auto& uniform = *_uniformSlots[slot];
+    if (!_isLinked || uniform.glIndex == -1)
+        return;
+    uniform.direct = true;
+    glProgramUniform4f(_program, uniform.glIndex, value.x, value.y, value.z, value.w);
 }
 
 /*************/
-void Shader::compileProgram()
+void Shader::setModelViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4& mp)
 {
-    GLint status;
-    if (glIsProgram(_program) == GL_TRUE)
-        glDeleteProgram(_program);
+    glm::mat4 floatMv = (glm::mat4)mv;
+    glm::mat4 floatMp = (glm::mat4)mp;
+    glm::mat4 floatMvp = (glm::mat4)(mp * mv);
 
-    _program = glCreateProgram();
-    for (auto& shader : _shaders)
+    if (_matrixSlots[0] == -1)
     {
-        if (glIsShader(shader.second))
-        {
-            glGetShaderiv(shader.second, GL_COMPILE_STATUS, &status);
-            if (status == GL_TRUE)
-            {
-                glAttachShader(_program, shader.second);
-#ifdef DEBUG
-                Log::get() << Log::DEBUGGING << "Shader::" << __FUNCTION__ << " - Shader of type " << std::stringFromShaderType(shader.first) << " successfully attached to the program"
-                           << Log::endl;
-#endif
-            }
-        }
+        _matrixSlots[0] = getUniformSlot("_modelViewProjectionMatrix");
+        _matrixSlots[1] = getUniformSlot("_modelViewMatrix");
+        _matrixSlots[2] = getUniformSlot("_projectionMatrix");
+        _matrixSlots[3] = getUniformSlot("_normalMatrix");
     }
+
+    setUniform(_matrixSlots[0], floatMvp);
+    setUniform(_matrixSlots[1], floatMv);
+    setUniform(_matrixSlots[2], floatMp);
+    if (_uniformSlots[_matrixSlots[3]]->glIndex != -1)
+        setUniform(_matrixSlots[3], glm::transpose(glm::inverse(floatMv)));
 }
 
 /*************/
-bool Shader::linkProgram()
+void Shader::resetProgram()
 {
-    GLint status;
-    glLinkProgram(_program);
-    glGetProgramiv(_program, GL_LINK_STATUS, &status);
-    if (status == GL_TRUE)
-    {
-#ifdef DEBUG
-        Log::get() << Log::DEBUGGING << "Shader::" << __FUNCTION__ << " - Shader program " << _currentProgramName << " linked successfully" << Log::endl;
-#endif
+    _program = 0;
+    _isLinked = false;
+}
 
-        for (auto src : _shadersSource)
-            parseUniforms(src.second);
+/*************/
+bool Shader::linkProgram()
+{
+    std::map<GLenum, std::string> sources;
+    for (const auto& [type, source] : _shadersSource)
+        sources[glShaderType(type)] = source;
 
-        _isLinked = true;
-        return true;
+    _program = ShaderProgramCache::get().getProgram(sources, _feedbackVaryings, _currentProgramName);
+    if (_program == 0)
+    {
+        _isLinked = false;
+        return false;
     }
-    else
+
     {
-        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error while linking the shader program " << _currentProgramName << Log::endl;
+        std::lock_guard<std::mutex> lock(_programUniformsMutex);
+        auto programUniformsIt = _programUniforms.find(_program);
+        if (programUniformsIt == _programUniforms.end())
+        {
+            ProgramUniforms programUniforms;
+            for (const auto& src : _shadersSource)
+                parseUniforms(src.second, programUniforms);
 
-        GLint length;
-        glGetProgramiv(_program, GL_INFO_LOG_LENGTH, &length);
-        char* log = (char*)malloc(length);
-        glGetProgramInfoLog(_program, length, &length, log);
-        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error log: \n" << (const char*)log << Log::endl;
-        free(log);
+            // Uniform block bindings are part of the program state, so they are only set once
+            for (auto& [name, uniform] : programUniforms.uniforms)
+            {
+                if (uniform.type != "buffer" || uniform.glIndex == -1)
+                    continue;
+                uniform.glBinding = getUniformBlockBinding(name);
+                glUniformBlockBinding(_program, uniform.glIndex, uniform.glBinding);
+            }
 
-        _isLinked = false;
-        return false;
+            programUniformsIt = _programUniforms.emplace(_program, std::move(programUniforms)).first;
+        }
+        setProgramUniforms(programUniformsIt->second);
     }
+
+    // The program may have been last used by this Shader with other sources, so this is forced
+    ShaderProgramCache::get().setLastUser(_program, 0);
+    _isLinked = true;
+    return true;
+}
+
+/*************/
+void Shader::invalidateUniforms()
+{
+    for (const auto& [name, uniform] : _uniforms)
+        if (uniform.glIndex != -1 && !uniform.direct && !uniform.values.empty())
+            _uniformsToUpdate.push_back(name);
 }
 
 /*************/
@@ -397,7 +475,7 @@ void Shader::parseIncludes(std::string& src)
 }
 
 /*************/
-void Shader::parseUniforms(const std::string& src)
+void Shader::parseUniforms(const std::string& src, ProgramUniforms& parsed) const
 {
     std::istringstream input(src);
     for (std::string line; getline(input, line);)
@@ -414,10 +492,9 @@ void Shader::parseUniforms(const std::string& src)
             std::string next = line.substr(position + 23, std::string::npos);
             std::string name = next.substr(0, next.find(" "));
 
-            _uniforms[name].type = "buffer";
-            _uniforms[name].glIndex = glGetUniformBlockIndex(_program, name.c_str());
-            glGenBuffers(1, &_uniforms[name].glBuffer);
-            _uniforms[name].glBufferReady = false;
+            // The buffer itself is created by each Shader, if it sets the block values
+            parsed.uniforms[name].type = "buffer";
+            parsed.uniforms[name].glIndex = glGetUniformBlockIndex(_program, name.c_str());
         }
         else
         {
@@ -467,80 +544,107 @@ void Shader::parseUniforms(const std::string& src)
                 continue;
             }
 
-            _uniforms[name].type = type;
-            _uniforms[name].glIndex = glGetUniformLocation(_program, name.c_str());
-            _uniforms[name].elementSize = type.find("mat") != std::string::npos ? elementSize * elementSize : elementSize;
-            _uniforms[name].arraySize = arraySize;
-            _uniformsDocumentation[name] = documentation;
+            auto& uniforms = parsed.uniforms;
+            uniforms[name].type = type;
+            uniforms[name].glIndex = glGetUniformLocation(_program, name.c_str());
+            uniforms[name].elementSize = type.find("mat") != std::string::npos ? elementSize * elementSize : elementSize;
+            uniforms[name].arraySize = arraySize;
+            parsed.documentation[name] = documentation;
 
             if (type == "int")
             {
                 int v;
-                glGetUniformiv(_program, _uniforms[name].glIndex, &v);
-                _uniforms[name].values = {v};
+                glGetUniformiv(_program, uniforms[name].glIndex, &v);
+                uniforms[name].values = {v};
             }
             else if (type == "float")
             {
                 float v;
-                glGetUniformfv(_program, _uniforms[name].glIndex, &v);
-                _uniforms[name].values = {v};
+                glGetUniformfv(_program, uniforms[name].glIndex, &v);
+                uniforms[name].values = {v};
             }
             else if (type == "vec2")
             {
                 float v[2];
-                glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1]};
+                glGetUniformfv(_program, uniforms[name].glIndex, v);
+                uniforms[name].values = {v[0], v[1]};
             }
             else if (type == "vec3")
             {
                 float v[3];
-                glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1], v[2]};
+                glGetUniformfv(_program, uniforms[name].glIndex, v);
+                uniforms[name].values = {v[0], v[1], v[2]};
             }
             else if (type == "vec4")
             {
                 float v[4];
-                glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1], v[2], v[3]};
+                glGetUniformfv(_program, uniforms[name].glIndex, v);
+                uniforms[name].values = {v[0], v[1], v[2], v[3]};
             }
             else if (type == "ivec2")
             {
                 int v[2];
-                glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1]};
+                glGetUniformiv(_program, uniforms[name].glIndex, v);
+                uniforms[name].values = {v[0], v[1]};
             }
             else if (type == "ivec3")
             {
                 int v[3];
-                glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1], v[2]};
+                glGetUniformiv(_program, uniforms[name].glIndex, v);
+                uniforms[name].values = {v[0], v[1], v[2]};
             }
             else if (type == "ivec4")
             {
                 int v[4];
-                glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1], v[2], v[3]};
+                glGetUniformiv(_program, uniforms[name].glIndex, v);
+                uniforms[name].values = {v[0], v[1], v[2], v[3]};
             }
             else if (type == "mat3")
             {
-                _uniforms[name].values = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+                uniforms[name].values = {0, 0, 0, 0, 0, 0, 0, 0, 0};
             }
             else if (type == "mat4")
             {
-                _uniforms[name].values = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+                uniforms[name].values = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
             }
             else if (type.find("sampler") != std::string::npos)
             {
-                _uniforms[name].values = {};
+                uniforms[name].values = {};
             }
             else
             {
-                _uniforms[name].glIndex = -1;
+                uniforms[name].glIndex = -1;
                 Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error while parsing uniforms: " << name << " is of unhandled type " << type << Log::endl;
             }
         }
     }
 
+}
+
+/*************/
+void Shader::setProgramUniforms(const ProgramUniforms& programUniforms)
+{
+    for (const auto& [name, programUniform] : programUniforms.uniforms)
+    {
+        auto& uniform = _uniforms[name];
+        uniform.type = programUniform.type;
+        uniform.glIndex = programUniform.glIndex;
+
+        if (programUniform.type == "buffer")
+        {
+            uniform.glBinding = programUniform.glBinding;
+        }
+        else
+        {
+            uniform.elementSize = programUniform.elementSize;
+            uniform.arraySize = programUniform.arraySize;
+            uniform.values = programUniform.values;
+        }
+    }
+
+    for (const auto& [name, documentation] : programUniforms.documentation)
+        _uniformsDocumentation[name] = documentation;
+
     // We parse all uniforms to deactivate the obsolete ones
     for (auto& u : _uniforms)
     {
@@ -600,9 +704,18 @@ void Shader::updateUniforms()
                 continue;
             }
 
+            if (uniform.direct)
+                continue;
+
             auto type = uniform.type;
             assert(!type.empty());
 
+            if (type == "buffer")
+            {
+                updateUniformBlock(uniform);
+                continue;
+            }
+
             if (uniform.arraySize == 0)
             {
                 if (uniform.elementSize != uniform.values.size())
@@ -647,29 +760,14 @@ void Shader::updateUniforms()
                     for (auto& v : uniform.values)
                         data.push_back(v.as<int>());
 
-                    if (uniform.type == "buffer")
-                    {
-                        glBindBuffer(GL_UNIFORM_BUFFER, uniform.glBuffer);
-                        if (!uniform.glBufferReady)
-                        {
-                            glBufferData(GL_UNIFORM_BUFFER, data.size() * sizeof(int), NULL, GL_STATIC_DRAW);
-                            uniform.glBufferReady = true;
-                        }
-                        glBufferSubData(GL_UNIFORM_BUFFER, 0, data.size() * sizeof(int), data.data());
-                        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-                        glBindBufferRange(GL_UNIFORM_BUFFER, 1, uniform.glBuffer, 0, data.size() * sizeof(int));
-                    }
-                    else
-                    {
-                        if (uniform.type == "int")
-                            glUniform1iv(uniform.glIndex, data.size(), data.data());
-                        else if (uniform.type == "ivec2")
-                            glUniform2iv(uniform.glIndex, data.size() / 2, data.data());
-                        else if (uniform.type == "ivec3")
-                            glUniform3iv(uniform.glIndex, data.size() / 3, data.data());
-                        else if (uniform.type == "ivec4")
-                            glUniform4iv(uniform.glIndex, data.size() / 4, data.data());
-                    }
+                    if (uniform.type == "int")
+                        glUniform1iv(uniform.glIndex, data.size(), data.data());
+                    else if (uniform.type == "ivec2")
+                        glUniform2iv(uniform.glIndex, data.size() / 2, data.data());
+                    else if (uniform.type == "ivec3")
+                        glUniform3iv(uniform.glIndex, data.size() / 3, data.data());
+                    else if (uniform.type == "ivec4")
+                        glUniform4iv(uniform.glIndex, data.size() / 4, data.data());
                 }
                 else if (type == "float" || type.find("vec") != std::string::npos)
                 {
@@ -677,29 +775,14 @@ void Shader::updateUniforms()
                     for (auto& v : uniform.values)
                         data.push_back(v.as<float>());
 
-                    if (uniform.type == "buffer")
-                    {
-                        glBindBuffer(GL_UNIFORM_BUFFER, uniform.glBuffer);
-                        if (!uniform.glBufferReady)
-                        {
-                            glBufferData(GL_UNIFORM_BUFFER, data.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-                            uniform.glBufferReady = true;
-                        }
-                        glBufferSubData(GL_UNIFORM_BUFFER, 0, data.size() * sizeof(float), data.data());
-                        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-                        glBindBufferRange(GL_UNIFORM_BUFFER, 1, uniform.glBuffer, 0, data.size() * sizeof(float));
-                    }
-                    else
-                    {
-                        if (uniform.type == "float")
-                            glUniform1fv(uniform.glIndex, data.size(), data.data());
-                        else if (uniform.type == "vec2")
-                            glUniform2fv(uniform.glIndex, data.size() / 2, data.data());
-                        else if (uniform.type == "vec3")
-                            glUniform3fv(uniform.glIndex, data.size() / 3, data.data());
-                        else if (uniform.type == "vec4")
-                            glUniform4fv(uniform.glIndex, data.size() / 4, data.data());
-                    }
+                    if (uniform.type == "float")
+                        glUniform1fv(uniform.glIndex, data.size(), data.data());
+                    else if (uniform.type == "vec2")
+                        glUniform2fv(uniform.glIndex, data.size() / 2, data.data());
+                    else if (uniform.type == "vec3")
+                        glUniform3fv(uniform.glIndex, data.size() / 3, data.data());
+                    else if (uniform.type == "vec4")
+                        glUniform4fv(uniform.glIndex, data.size() / 4, data.data());
                 }
             }
         }
@@ -709,18 +792,70 @@ void Shader::updateUniforms()
 }
 
 /*************/
-void Shader::resetShader(ShaderType type)
+void Shader::updateUniformBlock(Uniform& uniform)
 {
-    glDeleteShader(_shaders[type]);
-
-    if (type == vertex)
-        _shaders[type] = glCreateShader(GL_VERTEX_SHADER);
-    else if (type == geometry)
-        _shaders[type] = glCreateShader(GL_GEOMETRY_SHADER);
-    else if (type == fragment)
-        _shaders[type] = glCreateShader(GL_FRAGMENT_SHADER);
-    else
+    if (uniform.values.empty())
         return;
+
+    // Values are written as 32 bits words, the layout of the block being up to the caller
+    std::vector<uint32_t> data(uniform.values.size());
+    for (size_t i = 0; i < uniform.values.size(); ++i)
+    {
+        const auto& value = uniform.values[i];
+        if (value.getType() == Value::Type::integer || value.getType() == Value::Type::boolean)
+        {
+            const auto integer = value.as<int32_t>();
+            memcpy(&data[i], &integer, sizeof(integer));
+        }
+        else
+        {
+            const auto real = value.as<float>();
+            memcpy(&data[i], &real, sizeof(real));
+        }
+    }
+
+    const auto size = data.size() * sizeof(uint32_t);
+    if (uniform.glBuffer == 0)
+        glCreateBuffers(1, &uniform.glBuffer);
+    if (uniform.glBufferSize != size)
+    {
+        glNamedBufferData(uniform.glBuffer, size, data.data(), GL_DYNAMIC_DRAW);
+        uniform.glBufferSize = size;
+    }
+    else
+    {
+        glNamedBufferSubData(uniform.glBuffer, 0, size, data.data());
+    }
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, uniform.glBinding, uniform.glBuffer);
+}
+
+/*************/
+void Shader::resetShader(ShaderType type)
+{
+    _shadersSource.erase(type);
+    _isLinked = false;
+}
+
+/*************/
+GLenum Shader::glShaderType(int type)
+{
+    switch (type)
+    {
+    default:
+    case vertex:
+        return GL_VERTEX_SHADER;
+    case tess_ctrl:
+        return GL_TESS_CONTROL_SHADER;
+    case tess_eval:
+        return GL_TESS_EVALUATION_SHADER;
+    case geometry:
+        return GL_GEOMETRY_SHADER;
+    case fragment:
+        return GL_FRAGMENT_SHADER;
+    case compute:
+        return GL_COMPUTE_SHADER;
+    }
 }
 
 /*************/
@@ -743,16 +878,7 @@ void Shader::registerAttributes()
                 uniformArgs = args[1].as<Values>();
             }
 
-            // Check if the values changed from previous use
-            auto uniformIt = _uniforms.find(uniformName);
-            if (uniformIt != _uniforms.end() && Value(uniformArgs) == Value(uniformIt->second.values))
-                return true;
-            else if (uniformIt == _uniforms.end())
-                uniformIt = (_uniforms.emplace(make_pair(uniformName, Uniform()))).first;
-
-            uniformIt->second.values = uniformArgs;
-            _uniformsToUpdate.push_back(uniformName);
-
+            setUniform(uniformName, uniformArgs);
             return true;
         },
         {});
@@ -777,7 +903,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_TEXTURE, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_TEXTURE, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "object_cubemap" && (_fill != object_cubemap || _shaderOptions != options))
             {
@@ -787,7 +913,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_OBJECT_CUBEMAP, vertex);
                 setSource(options + ShaderSources.GEOMETRY_SHADER_OBJECT_CUBEMAP, geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_OBJECT_CUBEMAP, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "cubemap_projection" && (_fill != cubemap_projection || _shaderOptions != options))
             {
@@ -797,7 +923,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_CUBEMAP_PROJECTION, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_CUBEMAP_PROJECTION, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "image_filter" && (_fill != image_filter || _shaderOptions != options))
             {
@@ -807,7 +933,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_FILTER, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_IMAGE_FILTER, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "blacklevel_filter" && (_fill != blacklevel_filter || _shaderOptions != options))
             {
@@ -817,7 +943,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_FILTER, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_BLACKLEVEL_FILTER, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "color_curves_filter" && (_fill != color_curves_filter || _shaderOptions != options))
             {
@@ -827,7 +953,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_FILTER, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_COLOR_CURVES_FILTER, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "color" && (_fill != color || _shaderOptions != options))
             {
@@ -837,7 +963,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_MODELVIEW, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_COLOR, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "primitiveId" && (_fill != primitiveId || _shaderOptions != options))
             {
@@ -847,7 +973,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_MODELVIEW, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_PRIMITIVEID, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "userDefined" && (_fill != userDefined || _shaderOptions != options))
             {
@@ -859,7 +985,7 @@ void Shader::registerGraphicAttributes()
                 resetShader(geometry);
                 if (_shadersSource.find(ShaderType::fragment) == _shadersSource.end())
                     setSource(options + ShaderSources.FRAGMENT_SHADER_DEFAULT_FILTER, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "uv" && (_fill != uv || _shaderOptions != options))
             {
@@ -869,7 +995,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_MODELVIEW, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_UV, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "warp" && (_fill != warp || _shaderOptions != options))
             {
@@ -879,7 +1005,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_WARP, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_WARP, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "warpControl" && (_fill != warpControl || _shaderOptions != options))
             {
@@ -889,7 +1015,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_WARP_WIREFRAME, vertex);
                 setSource(options + ShaderSources.GEOMETRY_SHADER_WARP_WIREFRAME, geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_WARP_WIREFRAME, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "wireframe" && (_fill != wireframe || _shaderOptions != options))
             {
@@ -899,7 +1025,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_WIREFRAME, vertex);
                 setSource(options + ShaderSources.GEOMETRY_SHADER_WIREFRAME, geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_WIREFRAME, fragment);
-                compileProgram();
+                resetProgram();
             }
             else if (args[0].as<std::string>() == "window" && (_fill != window || _shaderOptions != options))
             {
@@ -909,7 +1035,7 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_WINDOW, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_WINDOW, fragment);
-                compileProgram();
+                resetProgram();
             }
             return true;
         },
@@ -959,25 +1085,25 @@ void Shader::registerComputeAttributes()
             {
                 _currentProgramName = args[0].as<std::string>();
                 setSource(options + ShaderSources.COMPUTE_SHADER_RESET_VISIBILITY, compute);
-                compileProgram();
+                resetProgram();
             }
             else if ("resetBlending" == args[0].as<std::string>())
             {
                 _currentProgramName = args[0].as<std::string>();
                 setSource(options + ShaderSources.COMPUTE_SHADER_RESET_BLENDING, compute);
-                compileProgram();
+                resetProgram();
             }
             else if ("computeCameraContribution" == args[0].as<std::string>())
             {
                 _currentProgramName = args[0].as<std::string>();
                 setSource(options + ShaderSources.COMPUTE_SHADER_COMPUTE_CAMERA_CONTRIBUTION, compute);
-                compileProgram();
+                resetProgram();
             }
             else if ("transferVisibilityToAttr" == args[0].as<std::string>())
             {
                 _currentProgramName = args[0].as<std::string>();
                 setSource(options + ShaderSources.COMPUTE_SHADER_TRANSFER_VISIBILITY_TO_ATTR, compute);
-                compileProgram();
+                resetProgram();
             }
 
             return true;
@@ -1007,7 +1133,7 @@ void Shader::registerFeedbackAttributes()
                 setSource(options + ShaderSources.TESS_CTRL_SHADER_FEEDBACK_TESSELLATE_FROM_CAMERA, tess_ctrl);
                 setSource(options + ShaderSources.TESS_EVAL_SHADER_FEEDBACK_TESSELLATE_FROM_CAMERA, tess_eval);
                 setSource(options + ShaderSources.GEOMETRY_SHADER_FEEDBACK_TESSELLATE_FROM_CAMERA, geometry);
-                compileProgram();
+                resetProgram();
             }
 
             return true;
@@ -1019,19 +1145,11 @@ void Shader::registerFeedbackAttributes()
             if (args.size() < 1)
                 return false;
 
-            GLchar* feedbackVaryings[args.size()];
-            std::vector<std::string> varyingNames;
-            for (uint32_t i = 0; i < args.size(); ++i)
-            {
-                varyingNames.push_back(args[i].as<std::string>());
-                feedbackVaryings[i] = new GLchar[256];
-                strcpy(feedbackVaryings[i], varyingNames[i].c_str());
-            }
-
-            glTransformFeedbackVaryings(_program, args.size(), const_cast<const GLchar**>(feedbackVaryings), GL_SEPARATE_ATTRIBS);
-
-            for (uint32_t i = 0; i < args.size(); ++i)
-                delete feedbackVaryings[i];
+            // The varyings are part of the program, which is fetched again with them
+            _feedbackVaryings.clear();
+            for (const auto& arg : args)
+                _feedbackVaryings.push_back(arg.as<std::string>());
+            resetProgram();
 
             return true;
         },
@@ -25,9 +25,11 @@
 #ifndef SPLASH_SHADER_H
 #define SPLASH_SHADER_H
 
+#include <array>
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -148,17 +150,17 @@ class Shader final : public GraphObject
     std::unordered_map<std::string, std::string> getUniformsDocumentation() const { return _uniformsDocumentation; }
 
     /**
-     * Set a shader source
+     * Set a shader source. It is compiled along with the other ones when the program is first needed,
+     * unless a program built from the same sources exists in the ShaderProgramCache
      * \param src Shader string
      * \param type Shader type
-     * \return Return true if the shader was compiled successfully
      */
-    bool setSource(const std::string& src, const ShaderType type);
+    void setSource(const std::string& src, const ShaderType type);
 
     /**
-     * Set multiple shaders at once
+     * Set multiple shaders at once, and build the program right away
      * \param sources Map of shader sources
-     * \return Return true if all shader could be compiled
+     * \return Return true if the program could be built
      */
     bool setSource(const std::map<ShaderType, std::string>& sources);
 
@@ -166,7 +168,7 @@ class Shader final : public GraphObject
      * Set a shader source from file
      * \param filename Shader file
      * \param type Shader type
-     * \return Return true if the shader was compiled successfully
+     * \return Return true if the file could be read
      */
     bool setSourceFromFile(const std::string& filename, const ShaderType type);
 
@@ -178,6 +180,50 @@ class Shader final : public GraphObject
      */
     void setTexture(const std::shared_ptr<Texture>& texture, const GLuint textureUnit, const std::string& name);
 
+    /**
+     * Add a new texture to use
+     * \param texture Texture
+     * \param textureUnit GL texture unit
+     * \param slot Slot of the sampler uniform, from getUniformSlot
+     */
+    void setTexture(const std::shared_ptr<Texture>& texture, const GLuint textureUnit, int slot);
+
+    /**
+     * Get the slot of a uniform, to set it through setUniform without looking it up by name.
+     * A slot stays valid when the program changes, and is ignored while the program has no such uniform
+     * \param name Uniform name
+     * \return Return the uniform slot
+     */
+    int getUniformSlot(const std::string& name);
+
+    /**
+     * Set the value of a uniform, sent to the program when the uniforms are next updated.
+     * For a uniform block, values are written one after the other as 32 bits integers or floats, and must follow its std140 layout
+     * \param name Uniform name
+     * \param values Uniform values
+     */
+    void setUniform(const std::string& name, const Values& values);
+
+    /**
+     * Get the binding point of a uniform block. Binding points are set per block name, and are the same for all programs,
+     * so a buffer bound to it is used by all the shaders declaring the block, unless they set the block values themselves
+     * \param name Uniform block name
+     * \return Return the binding point
+     */
+    static GLuint getUniformBlockBinding(const std::string& name);
+
+    /**
+     * Set the value of a uniform right away. This has to be called while the shader is active.
+     * The value is not kept by the shader, and has to be set again at each activation
+     * \param slot Uniform slot, from getUniformSlot
+     * \param value Uniform value
+     */
+    void setUniform(int slot, int value);
+    void setUniform(int slot, float value);
+    void setUniform(int slot, const glm::vec2& value);
+    void setUniform(int slot, const glm::vec4& value);
+    void setUniform(int slot, const glm::mat4& value);
+
     /**
      * Set the model view and projection matrices
      * \param mv View matrix
@@ -195,9 +241,10 @@ class Shader final : public GraphObject
     std::atomic_bool _activated{false};
     ProgramType _programType{prgGraphic};
 
-    std::unordered_map<int, GLuint> _shaders;
-    std::unordered_map<int, std::string> _shadersSource;
-    GLuint _program{0};
+    std::map<int, std::string> _shadersSource;
+    std::vector<std::string> _feedbackVaryings;
+    GLuint _program{0}; //!< Program from the ShaderProgramCache, shared with the other Shaders with the same sources
+    const uint64_t _userId{++_nextUserId}; //!< Identifies this Shader as a program user, an address being reused once the Shader is destroyed
     bool _isLinked = {false};
 
     struct Uniform
@@ -207,11 +254,33 @@ class Shader final : public GraphObject
         uint32_t arraySize{0};
         Values values{};
         GLint glIndex{-1};
-        GLuint glBuffer{0};
-        bool glBufferReady{false};
+        GLuint glBuffer{0}; //!< Buffer holding the values of a uniform block, if set through this shader
+        size_t glBufferSize{0};
+        GLuint glBinding{0}; //!< Binding point of a uniform block
+        bool direct{false};  //!< True if last set through setUniform, in which case values are outdated
     };
     std::map<std::string, Uniform> _uniforms;
     std::unordered_map<std::string, std::string> _uniformsDocumentation;
+
+    // Uniforms parsed from the sources of each program, so that this is done once per program.
+    // Their values are the defaults from the program, read before any Shader modified them
+    struct ProgramUniforms
+    {
+        std::map<std::string, Uniform> uniforms{};
+        std::unordered_map<std::string, std::string> documentation{};
+    };
+    static std::atomic_uint64_t _nextUserId;
+    static std::mutex _programUniformsMutex;
+    static std::unordered_map<GLuint, ProgramUniforms> _programUniforms;
+    static std::mutex _uniformBlockBindingsMutex; //!< Not _programUniformsMutex, as bindings are queried while linking with it held
+    static std::unordered_map<std::string, GLuint> _uniformBlockBindings;
+
+    // Uniforms set through slots. Pointers to the elements of _uniforms stay valid as these are never removed
+    std::vector<Uniform*> _uniformSlots{};
+    std::unordered_map<std::string, int> _uniformSlotIndices{};
+    int _textureNbrSlot{-1};
+    std::array<int, 4> _matrixSlots{-1, -1, -1, -1}; //!< Model view projection, model view, projection and normal matrices
+
     std::vector<std::string> _uniformsToUpdate;
     std::vector<std::shared_ptr<Texture>> _textures; // Currently used textures
     std::string _currentProgramName{};
@@ -222,15 +291,21 @@ class Shader final : public GraphObject
     Sideness _sideness{doubleSided};
 
     /**
-     * Compile the shader program
+     * Reset the shader program, for it to be built from the current sources when next needed
      */
-    void compileProgram();
+    void resetProgram();
 
     /**
-     * Link the shader program
+     * Get the shader program for the current sources from the ShaderProgramCache
+     * \return Return true if the program is linked
      */
     bool linkProgram();
 
+    /**
+     * Set all uniforms to be sent again, as another Shader may have modified them in the shared program
+     */
+    void invalidateUniforms();
+
     /**
      * Parses the shader to replace includes by the corresponding sources
      * \param src Shader source
@@ -239,8 +314,16 @@ class Shader final : public GraphObject
 
     /**
      * Parses the shader to find uniforms
+     * \param src Shader source
+     * \param parsed Parsed uniforms
+     */
+    void parseUniforms(const std::string& src, ProgramUniforms& parsed) const;
+
+    /**
+     * Update the uniforms from the ones of the current program
+     * \param programUniforms Uniforms of the current program
      */
-    void parseUniforms(const std::string& src);
+    void setProgramUniforms(const ProgramUniforms& programUniforms);
 
     /**
      * Get a string expression of the shader type, used for logging
@@ -250,11 +333,24 @@ class Shader final : public GraphObject
     std::string stringFromShaderType(int type);
 
     /**
-     * Replace a shader with an empty one
+     * Send the values of a uniform block to its buffer, and bind it
+     * \param uniform Uniform block
+     */
+    void updateUniformBlock(Uniform& uniform);
+
+    /**
+     * Remove a shader from the program
      * \param type Shader type
      */
     void resetShader(ShaderType type);
 
+    /**
+     * Get the GL shader type for a shader type
+     * \param type Shader type
+     * \return Return the GL shader type
+     */
+    static GLenum glShaderType(int type);
+
     /**
      * Register new functors to modify attributes
      */
@@ -44,6 +44,25 @@ struct ShaderSources
             #define COLOR_UYVY 2
             #define COLOR_YUYV 3
             #define COLOR_YCoCg 4
+            #define COLOR_YUV420P 5
+            #define COLOR_NV12 6
+            #define COLOR_YUV422P 7
+        )"},
+        //
+        // Camera parameters, set once per frame by each camera in a std140 uniform block.
+        // Its layout must match Camera::UniformBlock
+        {"cameraUniforms", R"(
+            layout(std140) uniform _cameraUniforms
+            {
+                vec4 _cameraAttributes; // blendWidth, brightness, saturation, contrast
+                vec4 _fovAndColorBalance; // fovX and fovY, r/g and b/g
+                vec4 _wireframeColor;
+                int _showCameraCount;
+                int _isColorLUT;
+                int _colorLUTSize;
+                mat3 _colorMixMatrix;
+                vec3 _colorLUT[256];
+            };
         )"},
         // Project a point wrt a mvp matrix, and check if it is in the view frustum.
         // Returns the distance on X and Y in the distToCenter parameter
@@ -267,27 +286,19 @@ struct ShaderSources
 
         layout(local_size_x = 128) in;
 
-        layout (std430, binding = 3) buffer annexeBuffer
+        layout (std430, binding = 4) buffer visibilityBuffer
         {
-            vec4 annexe[]; // Holds camera count, blending sum, flag set to true if primitive is visible, primitive ID
+            float visibility[]; // Set to 1.0 if the primitive is visible
         };
 
-        uniform int _vertexNbr;
-        uniform int _primitiveIdShift = 0;
+        uniform int _primitiveNbr;
 
         void main(void)
         {
             int globalID = int(gl_GlobalInvocationID.x);
 
-            if (globalID < _vertexNbr / 3)
-            {
-                for (int idx = 0; idx < 3; ++idx)
-                {
-                    int vertexId = globalID * 3 + idx;
-                    // the W coordinates holds the primitive ID, for use in the first visibility test
-                    annexe[vertexId].zw = vec2(0.0, float(globalID + _primitiveIdShift));
-                }
-            }
+            if (globalID < _primitiveNbr)
+                visibility[globalID] = 0.0;
         }
     )"};
 
@@ -333,13 +344,14 @@ struct ShaderSources
         layout(local_size_x = 32, local_size_y = 32) in;
 
         layout(binding = 0) uniform sampler2D imgVisibility;
-        layout(std430, binding = 3) buffer annexeBuffer
+        layout(std430, binding = 4) buffer visibilityBuffer
         {
-            vec4 annexe[];
+            float visibility[];
         };
 
         uniform vec2 _texSize;
         uniform int _idShift = 0;
+        uniform int _primitiveNbr;
 
         void main(void)
         {
@@ -348,11 +360,11 @@ struct ShaderSources
 
             if (all(lessThan(pixCoords.xy, _texSize.xy)))
             {
-                ivec4 visibility = ivec4(round(texelFetch(imgVisibility, ivec2(pixCoords), 0) * 255.0));
-                int primitiveID = visibility.r * 65025 + visibility.g * 255 + visibility.b - _idShift;
-                // Mark the primitive found as visible
-                for (int idx = primitiveID * 3; idx < primitiveID * 3 + 3; ++idx)
-                    annexe[idx].z = 1.0;
+                ivec4 primitiveColor = ivec4(round(texelFetch(imgVisibility, ivec2(pixCoords), 0) * 255.0));
+                int primitiveID = primitiveColor.r * 65025 + primitiveColor.g * 255 + primitiveColor.b - _idShift;
+                // Mark the primitive found as visible, if it belongs to this geometry
+                if (primitiveID >= 0 && primitiveID < _primitiveNbr)
+                    visibility[primitiveID] = 1.0;
             }
         }
     )"};
@@ -385,6 +397,11 @@ struct ShaderSources
             vec4 annexe[];
         };
 
+        layout (std430, binding = 4) buffer visibilityBuffer
+        {
+            float visibility[];
+        };
+
         uniform int _vertexNbr;
         uniform mat4 _mv; // Model View matrix
         uniform mat4 _mvp; // Model View Projection matrix
@@ -405,22 +422,22 @@ struct ShaderSources
 
             if (globalID < _vertexNbr / 3)
             {
+                // If this primitive was marked as non visible, we can return
+                if (visibility[globalID] == 0.0)
+                {
+                    // We set the w coordinate to 0
+                    for (int idx = 0; idx < 3; ++idx)
+                    {
+                        int vertexId = globalID * 3 + idx;
+                        annexe[vertexId].w = 0.0;
+                    }
+                    return;
+                }
+
                 for (int idx = 0; idx < 3; ++idx)
                 {
                     int vertexId = globalID * 3 + idx;
 
-                    // If this vertex was marked as non visible, we can return
-                    if (annexe[vertexId].z == 0.0)
-                    {
-                        // We set the w coordinate to 0
-                        for (int idx = 0; idx < 3; ++idx)
-                        {
-                            int vertexId = globalID * 3 + idx;
-                            annexe[vertexId].w = 0.0;
-                        }
-                        return;
-                     }
-
                     vec2 distToCenter;
                     vec4 normalizedSpaceVertex = vertex[vertexId];
                     vertexVisible[idx] = projectAndCheckVisibility(normalizedSpaceVertex, _mvp, 0.005, distToCenter);
@@ -500,6 +517,11 @@ struct ShaderSources
             vec4 annexe;
         } tcs_out[];
 
+        layout (std430, binding = 4) buffer visibilityBuffer
+        {
+            float visibility[];
+        };
+
         uniform mat4 _mvp;
         uniform mat4 _mNormal;
         uniform float _blendWidth = 0.1;
@@ -522,7 +544,8 @@ struct ShaderSources
                 gl_TessLevelOuter[1] = 1.0;
                 gl_TessLevelOuter[2] = 1.0;
 
-                if (tcs_in[0].annexe.z > 0.0)
+                // Each patch is an input triangle, indexed or not, so the patch ID is the primitive ID
+                if (visibility[gl_PrimitiveID] > 0.0)
                 {
                     // Check whether the vertices are visible, and their distances to the borders
                     for (int i = 0; i < 3; ++i)
@@ -865,9 +888,10 @@ struct ShaderSources
         layout(location = 2) in vec4 _normal;
         layout(location = 3) in vec4 _annexe;
 
+        #include cameraUniforms
+
         uniform mat4 _modelViewProjectionMatrix;
         uniform mat4 _normalMatrix;
-        uniform vec4 _cameraAttributes = vec4(0.05, 1.0, 1.0, 1.0); // blendWidth, brightness, saturation, contrast
 
         out VertexData
         {
@@ -1028,6 +1052,40 @@ struct ShaderSources
                 else // Odd pixel
                     color.rgb = yuv2rgb(yuyv.bga);
             }
+            // If the color format is planar YUV, the planes are stored one after the other in a single channel texture
+            else if (_tex0_encoding == COLOR_YUV420P || _tex0_encoding == COLOR_NV12 || _tex0_encoding == COLOR_YUV422P)
+            {
+                ivec2 size = ivec2(_tex0_size);
+                ivec2 pixelCoords = clamp(ivec2(realCoords * _tex0_size), ivec2(0), size - ivec2(1));
+
+                int uOffset, vOffset;
+                if (_tex0_encoding == COLOR_NV12)
+                {
+                    uOffset = size.x * size.y + (pixelCoords.y / 2) * size.x + (pixelCoords.x / 2) * 2;
+                    vOffset = uOffset + 1;
+                }
+                else if (_tex0_encoding == COLOR_YUV420P)
+                {
+                    uOffset = size.x * size.y + (pixelCoords.y / 2) * (size.x / 2) + pixelCoords.x / 2;
+                    vOffset = uOffset + (size.x / 2) * (size.y / 2);
+                }
+                else
+                {
+                    uOffset = size.x * size.y + pixelCoords.y * (size.x / 2) + pixelCoords.x / 2;
+                    vOffset = uOffset + (size.x / 2) * size.y;
+                }
+
+                vec3 yuv;
+                yuv.r = texelFetch(_tex0, pixelCoords, 0).r;
+                yuv.g = texelFetch(_tex0, ivec2(uOffset % size.x, uOffset / size.x), 0).r;
+                yuv.b = texelFetch(_tex0, ivec2(vOffset % size.x, vOffset / size.x), 0).r;
+
+                // Planar textures are not sampled as sRGB, so sRGB data is converted here as it is for the other formats
+    #ifdef TEXTURE_SRGB
+                yuv = srgb2rgb(yuv);
+    #endif
+                color.rgb = yuv2rgb(yuv);
+            }
             
             // Invert channels
             if (_invertChannels == 1)
@@ -1327,10 +1385,11 @@ struct ShaderSources
         layout(location = 2) in vec4 _normal;
         layout(location = 3) in vec4 _annexe;
 
+        #include cameraUniforms
+
         uniform mat4 _modelViewProjectionMatrix;
         uniform mat4 _modelViewMatrix;
         uniform mat4 _normalMatrix;
-        uniform vec4 _cameraAttributes = vec4(0.05, 1.0, 1.0, 1.0); // blendWidth, brightness, saturation, contrast
 
     #ifdef VERTEXBLENDING
         uniform float _farthestVertex = 0.0;
@@ -1402,17 +1461,10 @@ struct ShaderSources
         uniform vec2 _tex0_size = vec2(1.0);
         uniform vec2 _tex1_size = vec2(1.0);
 
-        uniform int _showCameraCount = 0;
+        #include cameraUniforms
+
         uniform int _sideness = 0;
-        uniform vec4 _cameraAttributes = vec4(0.05, 1.0, 1.0, 1.0); // blendWidth, brightness, saturation, contrast
-        uniform vec4 _fovAndColorBalance = vec4(0.0, 0.0, 1.0, 1.0); // fovX and fovY, r/g and b/g
-        uniform int _isColorLUT = 0;
         uniform vec4 _color = vec4(0.0, 0.0, 0.0, 1.0);
-        uniform int _colorLUTSize = 0;
-        uniform vec3 _colorLUT[256];
-        uniform mat3 _colorMixMatrix = mat3(1.0, 0.0, 0.0,
-                                            0.0, 1.0, 0.0,
-                                            0.0, 0.0, 1.0);
         uniform float _normalExp = 0.0;
 
         in VertexData
@@ -1513,8 +1565,9 @@ struct ShaderSources
     const std::string FRAGMENT_SHADER_COLOR{R"(
         #define PI 3.14159265359
 
+        #include cameraUniforms
+
         uniform int _sideness = 0;
-        uniform vec4 _fovAndColorBalance = vec4(0.0, 0.0, 1.0, 1.0); // fovX and fovY, r/g and b/g
         uniform vec4 _color = vec4(0.0, 1.0, 0.0, 1.0);
 
         in VertexData
@@ -1545,8 +1598,9 @@ struct ShaderSources
     const std::string FRAGMENT_SHADER_UV{R"(
         #define PI 3.14159265359
 
+        #include cameraUniforms
+
         uniform int _sideness = 0;
-        uniform vec4 _fovAndColorBalance = vec4(0.0, 0.0, 1.0, 1.0); // fovX and fovY, r/g and b/g
 
         in VertexData
         {
@@ -1573,8 +1627,7 @@ struct ShaderSources
     )"};
 
     /**
-     * Draws the primitive ID
-     * This shader has to be used after a pass of COMPUTE_SHADER_RESET_VISIBILITY
+     * Draws the primitive ID, shifted by the number of primitives of the objects drawn before
      */
     const std::string FRAGMENT_SHADER_PRIMITIVEID{R"(
         in VertexData
@@ -1585,11 +1638,13 @@ struct ShaderSources
             vec4 annexe;
         } vertexIn;
 
+        uniform int _primitiveIdShift = 0;
+
         out vec4 fragColor;
 
         void main(void)
         {
-            float index = round(vertexIn.annexe.w);
+            float index = float(gl_PrimitiveID + _primitiveIdShift);
             float thirdOrder = floor(index / 65025.0);
             float secondOrder = floor(fma(thirdOrder, -65025.0, index) / 255.0);
             float firstOrder = fma(secondOrder, -255.0, fma(thirdOrder, -65025.0, index));
@@ -1673,9 +1728,9 @@ struct ShaderSources
             vec4 position;
         } vertexIn;
 
-        uniform vec4 _wireframeColor = vec4(1.0, 0.0, 0.0, 1.0);
+        #include cameraUniforms
+
         uniform int _sideness = 0;
-        uniform vec4 _fovAndColorBalance = vec4(0.0, 0.0, 1.0, 1.0); // fovX and fovY, r/g and b/g
         out vec4 fragColor;
 
         float edgeFactor()
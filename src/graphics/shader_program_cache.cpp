@@ -0,0 +1,325 @@
+#include "./graphics/shader_program_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+#include "./utils/log.h"
+#include "./utils/osutils.h"
+
+namespace Splash
+{
+
+namespace
+{
+constexpr char BINARY_MAGIC[8] = {'S', 'P', 'L', 'P', 'R', 'O', 'G', '\0'};
+constexpr uint32_t BINARY_VERSION = 1;
+
+// A binary file holds this header, followed by the driver identifier, the program key and the program binary
+struct BinaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t binaryFormat;
+    uint64_t driverIdSize;
+    uint64_t keySize;
+    uint64_t binarySize;
+};
+} // namespace
+
+/*************/
+ShaderProgramCache::ShaderProgramCache()
+{
+    if (const auto cacheHome = getenv("XDG_CACHE_HOME"); cacheHome != nullptr && cacheHome[0] != '\0')
+        _directory = std::string(cacheHome) + "/splash/shaders/";
+    else
+        _directory = Utils::getHomePath() + "/.cache/splash/shaders/";
+}
+
+/*************/
+GLuint ShaderProgramCache::getProgram(const std::map<GLenum, std::string>& sources, const std::vector<std::string>& feedbackVaryings, const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto key = getKey(sources, feedbackVaryings);
+    if (const auto programIt = _programs.find(key); programIt != _programs.end())
+        return programIt->second;
+
+    queryDriver();
+
+    auto program = loadBinary(key);
+    if (program == 0)
+    {
+        program = buildProgram(sources, feedbackVaryings, name);
+        if (program != 0)
+            saveBinary(key, program);
+    }
+#ifdef DEBUG
+    else
+    {
+        Log::get() << Log::DEBUGGING << "ShaderProgramCache::" << __FUNCTION__ << " - Shader program " << name << " loaded from its binary" << Log::endl;
+    }
+#endif
+
+    // Programs which failed to build are kept too, so as not to try again with the same sources
+    _programs[key] = program;
+    return program;
+}
+
+/*************/
+bool ShaderProgramCache::setLastUser(GLuint program, uint64_t user)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& lastUser = _lastUsers[program];
+    if (lastUser == user)
+        return false;
+
+    lastUser = user;
+    return true;
+}
+
+/*************/
+void ShaderProgramCache::setDirectory(const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _directory = directory;
+    if (!_directory.empty() && _directory.back() != '/')
+        _directory += "/";
+}
+
+/*************/
+std::string ShaderProgramCache::getDirectory() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _directory;
+}
+
+/*************/
+std::string ShaderProgramCache::getKey(const std::map<GLenum, std::string>& sources, const std::vector<std::string>& feedbackVaryings)
+{
+    // Sizes are written along the strings, for the key to be unambiguous
+    std::string key;
+    for (const auto& [type, source] : sources)
+        key += std::to_string(type) + ":" + std::to_string(source.size()) + ":" + source;
+    for (const auto& varying : feedbackVaryings)
+        key += "varying:" + std::to_string(varying.size()) + ":" + varying;
+    return key;
+}
+
+/*************/
+std::string ShaderProgramCache::getBinaryFilename(const std::string& key)
+{
+    // FNV-1a, which contrary to std::hash is guaranteed to give the same result from one run to another
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const auto c : key)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+
+    std::ostringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+    return stream.str();
+}
+
+/*************/
+GLuint ShaderProgramCache::buildProgram(const std::map<GLenum, std::string>& sources, const std::vector<std::string>& feedbackVaryings, const std::string& name)
+{
+    auto program = glCreateProgram();
+    std::vector<GLuint> shaders;
+    bool compiled = true;
+
+    for (const auto& [type, source] : sources)
+    {
+        auto shader = glCreateShader(type);
+        const char* shaderSrc = source.c_str();
+        glShaderSource(shader, 1, (const GLchar**)&shaderSrc, 0);
+        glCompileShader(shader);
+        shaders.push_back(shader);
+
+        GLint status;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status != GL_TRUE)
+        {
+            Log::get() << Log::WARNING << "ShaderProgramCache::" << __FUNCTION__ << " - Error while compiling a shader of program " << name << Log::endl;
+            GLint length;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+            std::string log(std::max(length, 1), '\0');
+            glGetShaderInfoLog(shader, length, &length, log.data());
+            Log::get() << Log::WARNING << "ShaderProgramCache::" << __FUNCTION__ << " - Error log: \n" << log.c_str() << Log::endl;
+            compiled = false;
+            continue;
+        }
+
+        glAttachShader(program, shader);
+    }
+
+    GLint status = GL_FALSE;
+    if (compiled)
+    {
+        if (!feedbackVaryings.empty())
+        {
+            std::vector<const GLchar*> varyings;
+            for (const auto& varying : feedbackVaryings)
+                varyings.push_back(varying.c_str());
+            glTransformFeedbackVaryings(program, varyings.size(), varyings.data(), GL_SEPARATE_ATTRIBS);
+        }
+
+        if (_binariesSupported && !_directory.empty())
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        glLinkProgram(program);
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE)
+        {
+            Log::get() << Log::WARNING << "ShaderProgramCache::" << __FUNCTION__ << " - Error while linking the shader program " << name << Log::endl;
+            GLint length;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+            std::string log(std::max(length, 1), '\0');
+            glGetProgramInfoLog(program, length, &length, log.data());
+            Log::get() << Log::WARNING << "ShaderProgramCache::" << __FUNCTION__ << " - Error log: \n" << log.c_str() << Log::endl;
+        }
+    }
+
+    // The shaders are not needed anymore once the program is linked
+    for (const auto shader : shaders)
+    {
+        if (status == GL_TRUE)
+            glDetachShader(program, shader);
+        glDeleteShader(shader);
+    }
+
+    if (status != GL_TRUE)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+
+#ifdef DEBUG
+    Log::get() << Log::DEBUGGING << "ShaderProgramCache::" << __FUNCTION__ << " - Shader program " << name << " linked successfully" << Log::endl;
+#endif
+
+    return program;
+}
+
+/*************/
+GLuint ShaderProgramCache::loadBinary(const std::string& key)
+{
+    if (!_binariesSupported || _directory.empty())
+        return 0;
+
+    std::ifstream file(_directory + getBinaryFilename(key), std::ios::in | std::ios::binary);
+    if (!file)
+        return 0;
+
+    BinaryHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return 0;
+    if (memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 || header.version != BINARY_VERSION)
+        return 0;
+    if (header.driverIdSize != _driverId.size() || header.keySize != key.size() || header.binarySize == 0)
+        return 0;
+
+    // The key is checked in full, the file name being only a hash of it
+    std::string driverId(header.driverIdSize, '\0');
+    std::string storedKey(header.keySize, '\0');
+    std::vector<char> binary(header.binarySize);
+    if (!file.read(driverId.data(), driverId.size()) || driverId != _driverId)
+        return 0;
+    if (!file.read(storedKey.data(), storedKey.size()) || storedKey != key)
+        return 0;
+    if (!file.read(binary.data(), binary.size()))
+        return 0;
+
+    // The driver may still reject the binary, for example after an update keeping the same version string
+    auto program = glCreateProgram();
+    glProgramBinary(program, header.binaryFormat, binary.data(), binary.size());
+    GLint status;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+/*************/
+void ShaderProgramCache::saveBinary(const std::string& key, GLuint program)
+{
+    if (!_binariesSupported || _directory.empty())
+        return;
+
+    GLint binarySize = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+    if (binarySize <= 0)
+        return;
+
+    std::vector<char> binary(binarySize);
+    GLenum binaryFormat;
+    glGetProgramBinary(program, binarySize, &binarySize, &binaryFormat, binary.data());
+    if (binarySize <= 0)
+        return;
+
+    BinaryHeader header{};
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.version = BINARY_VERSION;
+    header.binaryFormat = binaryFormat;
+    header.driverIdSize = _driverId.size();
+    header.keySize = key.size();
+    header.binarySize = binarySize;
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(_directory, errorCode);
+
+    // The binary is written to a temporary file first, as other Scenes may be reading the same binary
+    const auto binaryPath = _directory + getBinaryFilename(key);
+    const auto temporaryPath = binaryPath + "." + std::to_string(getpid());
+    auto file = fopen(temporaryPath.c_str(), "wb");
+    if (!file)
+    {
+        Log::get() << Log::DEBUGGING << "ShaderProgramCache::" << __FUNCTION__ << " - Unable to write the program binary " << binaryPath << Log::endl;
+        return;
+    }
+
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+    success = success && fwrite(_driverId.data(), 1, _driverId.size(), file) == _driverId.size();
+    success = success && fwrite(key.data(), 1, key.size(), file) == key.size();
+    success = success && fwrite(binary.data(), 1, header.binarySize, file) == header.binarySize;
+    success = (fclose(file) == 0) && success;
+
+    if (!success || rename(temporaryPath.c_str(), binaryPath.c_str()) != 0)
+    {
+        Log::get() << Log::DEBUGGING << "ShaderProgramCache::" << __FUNCTION__ << " - Unable to write the program binary " << binaryPath << Log::endl;
+        remove(temporaryPath.c_str());
+    }
+}
+
+/*************/
+void ShaderProgramCache::queryDriver()
+{
+    if (_driverQueried)
+        return;
+    _driverQueried = true;
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    _binariesSupported = formatCount > 0;
+
+    for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+    {
+        const auto value = reinterpret_cast<const char*>(glGetString(name));
+        _driverId += std::string(value ? value : "") + "\n";
+    }
+
+    if (!_binariesSupported)
+        Log::get() << Log::MESSAGE << "ShaderProgramCache::" << __FUNCTION__ << " - Program binaries are not supported by the driver, shaders will be compiled at each run" << Log::endl;
+}
+
+} // namespace Splash
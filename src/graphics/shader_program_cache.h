@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @shader_program_cache.h
+ * The ShaderProgramCache class, sharing the linked shader programs of the process
+ */
+
+#ifndef SPLASH_SHADER_PROGRAM_CACHE_H
+#define SPLASH_SHADER_PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./core/constants.h"
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Process-wide cache of the linked shader programs.
+ *
+ * Programs are identified by their preprocessed sources, which include the defines set by the
+ * shader options, and by their transform feedback varyings. Shaders built from the same sources
+ * share the same program, which is compiled and linked only once.
+ *
+ * Linked programs are also stored as program binaries in a cache directory, so that they are
+ * not compiled again by the next runs as long as the driver does not change.
+ *
+ * As all GL contexts of a process share their objects, the programs are kept for the whole
+ * lifetime of the process.
+ */
+class ShaderProgramCache
+{
+  public:
+    /**
+     * Get the process-wide cache
+     * \return Return the ShaderProgramCache singleton
+     */
+    static ShaderProgramCache& get()
+    {
+        static auto instance = new ShaderProgramCache;
+        return *instance;
+    }
+
+    /**
+     * Other constructors and operators
+     */
+    ShaderProgramCache(const ShaderProgramCache&) = delete;
+    ShaderProgramCache& operator=(const ShaderProgramCache&) = delete;
+
+    /**
+     * Get the program for the given sources, compiling and linking it if it is not cached yet.
+     * A GL context has to be current
+     * \param sources Preprocessed sources, for each GL shader type
+     * \param feedbackVaryings Transform feedback varyings, if any
+     * \param name Program name, used for logging
+     * \return Return the program, or 0 if it could not be built
+     */
+    GLuint getProgram(const std::map<GLenum, std::string>& sources, const std::vector<std::string>& feedbackVaryings, const std::string& name);
+
+    /**
+     * Set the last user of a program, to know when its uniforms have to be set again
+     * \param program Program
+     * \param user Identifier of the user of the program, unique for the process lifetime. 0 means no user
+     * \return Return true if the program was last used by another user
+     */
+    bool setLastUser(GLuint program, uint64_t user);
+
+    /**
+     * Set the directory holding the program binaries
+     * \param directory Cache directory. If empty, binaries are neither read nor written
+     */
+    void setDirectory(const std::string& directory);
+
+    /**
+     * Get the directory holding the program binaries
+     * \return Return the cache directory
+     */
+    std::string getDirectory() const;
+
+  private:
+    mutable std::mutex _mutex{};
+    std::unordered_map<std::string, GLuint> _programs{}; //!< Programs for each key, 0 for the ones which failed to build
+    std::unordered_map<GLuint, uint64_t> _lastUsers{};
+
+    std::string _directory{};
+    std::string _driverId{}; //!< Vendor, renderer and version of the driver, the binaries being specific to it
+    bool _binariesSupported{false};
+    bool _driverQueried{false};
+
+    /**
+     * Constructor
+     */
+    ShaderProgramCache();
+
+    /**
+     * Build the key identifying a program
+     * \param sources Preprocessed sources, for each GL shader type
+     * \param feedbackVaryings Transform feedback varyings
+     * \return Return the key
+     */
+    static std::string getKey(const std::map<GLenum, std::string>& sources, const std::vector<std::string>& feedbackVaryings);
+
+    /**
+     * Hash a key into the name of its binary file
+     * \param key Program key
+     * \return Return the file name
+     */
+    static std::string getBinaryFilename(const std::string& key);
+
+    /**
+     * Compile and link a program from its sources
+     * \param sources Preprocessed sources, for each GL shader type
+     * \param feedbackVaryings Transform feedback varyings
+     * \param name Program name, used for logging
+     * \return Return the linked program, or 0
+     */
+    GLuint buildProgram(const std::map<GLenum, std::string>& sources, const std::vector<std::string>& feedbackVaryings, const std::string& name);
+
+    /**
+     * Create a program from its binary, if it is in the cache directory
+     * \param key Program key
+     * \return Return the linked program, or 0
+     */
+    GLuint loadBinary(const std::string& key);
+
+    /**
+     * Write the binary of a program to the cache directory
+     * \param key Program key
+     * \param program Linked program
+     */
+    void saveBinary(const std::string& key, GLuint program);
+
+    /**
+     * Query the driver identifier and the program binaries support, once a context is current
+     */
+    void queryDriver();
+};
+
+} // namespace Splash
+
+#endif // SPLASH_SHADER_PROGRAM_CACHE_H
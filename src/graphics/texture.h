@@ -41,6 +41,16 @@ namespace Splash
 
 class Texture : public GraphObject
 {
+  public:
+    // Uniforms describing a texture to the shaders, set as _texN_size, _texN_flip, etc. for the texture unit N
+    struct ShaderUniforms
+    {
+        glm::vec2 size{1.f, 1.f};
+        int32_t flip{0};
+        int32_t flop{0};
+        int32_t encoding{0}; //!< Color encoding, RGB by default
+    };
+
   public:
     /**
      *  Constructor
@@ -73,10 +83,16 @@ class Texture : public GraphObject
 
     /**
      * Get the shader parameters related to this texture. Texture should be locked first.
-     * The uniform should at least define the "size" attribute of the texture.
+     * The uniforms should at least define the size of the texture.
      * \return Return the shader uniforms
      */
-    virtual std::unordered_map<std::string, Values> getShaderUniforms() const = 0;
+    virtual ShaderUniforms getShaderUniforms() const = 0;
+
+    /**
+     * Check whether the texture holds sRGB data which is not sampled as such, and has to be converted by the shaders
+     * \return Return true if the data is sRGB
+     */
+    virtual bool isSrgb() const { return false; }
 
     /**
      *  Get spec of the texture
@@ -1,5 +1,7 @@
 #include "./graphics/texture_image.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "./image/image.h"
@@ -10,6 +12,8 @@ namespace Splash
 {
 
 constexpr int Texture_Image::_texLevels;
+constexpr size_t Texture_Image::_uploadRingSize;
+constexpr std::chrono::milliseconds Texture_Image::_uploadMaxWait;
 
 /*************/
 Texture_Image::Texture_Image(RootObject* root)
@@ -38,7 +42,8 @@ Texture_Image::~Texture_Image()
 
     std::lock_guard<std::mutex> lock(_mutex);
     glDeleteTextures(1, &_glTex);
-    glDeleteBuffers(2, _pbos);
+    for (auto& slot : _uploadSlots)
+        releaseUploadSlot(slot);
 }
 
 /*************/
@@ -92,10 +97,10 @@ RgbValue Texture_Image::getMeanValue() const
 }
 
 /*************/
-std::unordered_map<std::string, Values> Texture_Image::getShaderUniforms() const
+Texture::ShaderUniforms Texture_Image::getShaderUniforms() const
 {
     auto uniforms = _shaderUniforms;
-    uniforms["size"] = {static_cast<float>(_spec.width), static_cast<float>(_spec.height)};
+    uniforms.size = glm::vec2(static_cast<float>(_spec.width), static_cast<float>(_spec.height));
     return uniforms;
 }
 
@@ -312,6 +317,8 @@ GLenum Texture_Image::getChannelOrder(const ImageBufferSpec& spec)
         glChannelOrder = GL_RGBA;
     else if (spec.format == "YUYV" || spec.format == "UYVY")
         glChannelOrder = GL_RG;
+    else if (spec.format == "YUV420P" || spec.format == "NV12" || spec.format == "YUV422P")
+        glChannelOrder = GL_RED;
     else if (spec.channels == 1)
         glChannelOrder = GL_RED;
     else if (spec.channels == 3)
@@ -327,6 +334,8 @@ void Texture_Image::update()
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    reclaimUploadSlots();
+
     // If _img is nullptr, this texture is not set from an Image
     if (_img.expired())
         return;
@@ -354,6 +363,11 @@ void Texture_Image::update()
     const int imageDataSize = spec.rawSize();
     GLenum glChannelOrder = getChannelOrder(spec);
 
+    // Planar YUV images are stored as a single channel texture holding all the planes one after the other,
+    // and are converted to RGB in the shader
+    const bool isPlanar = (spec.format == "YUV420P" || spec.format == "NV12" || spec.format == "YUV422P");
+    const int textureHeight = isPlanar ? imageDataSize / spec.width : spec.height;
+
     // If the texture is compressed, we need to modify a few values
     bool isCompressed = false;
     if (spec.format == "RGB_DXT1")
@@ -377,7 +391,12 @@ void Texture_Image::update()
     GLenum dataFormat = GL_UNSIGNED_BYTE;
     if (!isCompressed)
     {
-        if (spec.channels == 4 && spec.type == ImageBufferSpec::Type::UINT8)
+        if (isPlanar)
+        {
+            dataFormat = GL_UNSIGNED_BYTE;
+            internalFormat = GL_R8;
+        }
+        else if (spec.channels == 4 && spec.type == ImageBufferSpec::Type::UINT8)
         {
             dataFormat = GL_UNSIGNED_INT_8_8_8_8_REV;
             if (srgb[0].as<bool>())
@@ -446,7 +465,7 @@ void Texture_Image::update()
         glTextureParameteri(_glTex, GL_TEXTURE_WRAP_S, _glTextureWrap);
         glTextureParameteri(_glTex, GL_TEXTURE_WRAP_T, _glTextureWrap);
 
-        if (_filtering)
+        if (_filtering && !isPlanar)
         {
             if (isCompressed)
                 glTextureParameteri(_glTex, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -466,8 +485,8 @@ void Texture_Image::update()
 #ifdef DEBUG
             Log::get() << Log::DEBUGGING << "Texture_Image::" << __FUNCTION__ << " - Creating a new texture" << Log::endl;
 #endif
-            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, spec.height);
-            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, img->data());
+            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, textureHeight);
+            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, textureHeight, glChannelOrder, dataFormat, img->data());
         }
         else if (isCompressed)
         {
@@ -479,63 +498,70 @@ void Texture_Image::update()
             glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, img->data());
         }
 
-        if (!updatePbos(spec.width, spec.height, spec.pixelBytes()))
-            return;
+        _uploadFormat.width = spec.width;
+        _uploadFormat.height = textureHeight;
+        _uploadFormat.size = imageDataSize;
+        _uploadFormat.channelOrder = glChannelOrder;
+        _uploadFormat.dataFormat = dataFormat;
+        _uploadFormat.internalFormat = internalFormat;
+        _uploadFormat.isCompressed = isCompressed;
 
-        // Fill one of the PBOs right now
-        auto pixels = _pbosPixels[0];
-        if (pixels != nullptr)
-        {
-            memcpy((void*)pixels, img->data(), imageDataSize);
-        }
+        if (!updateUploadRing(imageDataSize))
+            return;
 
-        // And copy it to the second PBO
-        glCopyNamedBufferSubData(_pbos[0], _pbos[1], 0, 0, imageDataSize);
         _spec = spec;
     }
     // Update the content of the texture, i.e the image
     else
     {
-        // Copy the pixels from the current PBO to the texture
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbos[_pboUploadIndex]);
-        if (!isCompressed)
-            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, 0);
+        // The image is copied to a free buffer of the ring, then uploaded from it. If none is available,
+        // the upload is done synchronously from the image
+        auto slot = acquireFreeSlot();
+        if (slot)
+        {
+            memcpy(slot->mapping, img->data(), imageDataSize);
+            uploadFromSlot(*slot);
+        }
+        else if (!isCompressed)
+        {
+            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, textureHeight, glChannelOrder, dataFormat, img->data());
+        }
         else
-            glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, 0);
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-
-        _pboUploadIndex = (_pboUploadIndex + 1) % 2;
-
-        // Fill the next PBO with the image pixels
-        auto pixels = _pbosPixels[_pboUploadIndex];
-        if (pixels != nullptr)
-            memcpy(pixels, img->data(), imageDataSize);
+        {
+            glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, img->data());
+        }
     }
 
     _spec.timestamp = spec.timestamp;
 
     // If needed, specify some uniforms for the shader which will use this texture
-    _shaderUniforms.clear();
 
     // Presentation parameters
-    _shaderUniforms["flip"] = flip;
-    _shaderUniforms["flop"] = flop;
+    _shaderUniforms.flip = flip.empty() ? 0 : flip[0].as<int>();
+    _shaderUniforms.flop = flop.empty() ? 0 : flop[0].as<int>();
+    _unsampledSrgb = isPlanar && !srgb.empty() && srgb[0].as<bool>();
 
     // Specify the color encoding
     if (spec.format.find("RGB") != std::string::npos)
-        _shaderUniforms["encoding"] = {ColorEncoding::RGB};
+        _shaderUniforms.encoding = ColorEncoding::RGB;
     else if (spec.format.find("BGR") != std::string::npos)
-        _shaderUniforms["encoding"] = {ColorEncoding::BGR};
+        _shaderUniforms.encoding = ColorEncoding::BGR;
     else if (spec.format == "UYVY")
-        _shaderUniforms["encoding"] = {ColorEncoding::UYVY};
+        _shaderUniforms.encoding = ColorEncoding::UYVY;
     else if (spec.format == "YUYV")
-        _shaderUniforms["encoding"] = {ColorEncoding::YUYV};
+        _shaderUniforms.encoding = ColorEncoding::YUYV;
     else if (spec.format == "YCoCg_DXT5")
-        _shaderUniforms["encoding"] = {ColorEncoding::YCoCg};
+        _shaderUniforms.encoding = ColorEncoding::YCoCg;
+    else if (spec.format == "YUV420P")
+        _shaderUniforms.encoding = ColorEncoding::YUV420P;
+    else if (spec.format == "NV12")
+        _shaderUniforms.encoding = ColorEncoding::NV12;
+    else if (spec.format == "YUV422P")
+        _shaderUniforms.encoding = ColorEncoding::YUV422P;
     else
-        _shaderUniforms["encoding"] = {ColorEncoding::RGB}; // Default case: RGB
+        _shaderUniforms.encoding = ColorEncoding::RGB; // Default case: RGB
 
-    if (_filtering && !isCompressed)
+    if (_filtering && !isCompressed && !isPlanar)
         generateMipmap();
 }
 
@@ -551,27 +577,108 @@ void Texture_Image::init()
 }
 
 /*************/
-bool Texture_Image::updatePbos(int width, int height, int bytes)
+bool Texture_Image::updateUploadRing(size_t size)
+{
+    if (std::all_of(_uploadSlots.cbegin(), _uploadSlots.cend(), [&](const auto& slot) { return slot.buffer && slot.capacity >= size; }))
+        return true;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    for (auto& slot : _uploadSlots)
+    {
+        releaseUploadSlot(slot);
+
+        glCreateBuffers(1, &slot.buffer);
+        glNamedBufferStorage(slot.buffer, size, nullptr, flags);
+        slot.mapping = static_cast<uint8_t*>(glMapNamedBufferRange(slot.buffer, 0, size, flags));
+        if (!slot.mapping)
+        {
+            Log::get() << Log::ERROR << "Texture_Image::" << __FUNCTION__ << " - Unable to initialize upload PBOs" << Log::endl;
+            for (auto& slotToRelease : _uploadSlots)
+                releaseUploadSlot(slotToRelease);
+            return false;
+        }
+        slot.capacity = size;
+    }
+
+    return true;
+}
+
+/*************/
+void Texture_Image::releaseUploadSlot(UploadSlot& slot)
 {
-    glDeleteBuffers(2, _pbos);
+    glDeleteSync(slot.fence);
+    if (slot.buffer)
+    {
+        if (slot.mapping)
+            glUnmapNamedBuffer(slot.buffer);
+        glDeleteBuffers(1, &slot.buffer);
+    }
 
-    auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
-    auto imageDataSize = width * height * bytes;
+    slot.buffer = 0;
+    slot.mapping = nullptr;
+    slot.capacity = 0;
+    slot.fence = nullptr;
+}
 
-    glCreateBuffers(2, _pbos);
-    glNamedBufferStorage(_pbos[0], imageDataSize, 0, flags);
-    glNamedBufferStorage(_pbos[1], imageDataSize, 0, flags);
+/*************/
+void Texture_Image::reclaimUploadSlots()
+{
+    for (auto& slot : _uploadSlots)
+    {
+        if (!slot.fence || glClientWaitSync(slot.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            continue;
 
-    _pbosPixels[0] = (GLubyte*)glMapNamedBufferRange(_pbos[0], 0, imageDataSize, flags);
-    _pbosPixels[1] = (GLubyte*)glMapNamedBufferRange(_pbos[1], 0, imageDataSize, flags);
+        // The upload latency is the time between the upload call and the GPU being done with it
+        if (Timer::get().isDebug())
+            Timer::get().setDuration("texture_upload " + _name, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - slot.issueTime).count());
 
-    if (!_pbosPixels[0] || !_pbosPixels[1])
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+}
+
+/*************/
+Texture_Image::UploadSlot* Texture_Image::acquireFreeSlot()
+{
+    for (auto& slot : _uploadSlots)
+        if (slot.buffer && !slot.fence)
+            return &slot;
+
+    // All the buffers are in use, so the oldest upload has to be waited for
+    UploadSlot* oldest = nullptr;
+    for (auto& slot : _uploadSlots)
+        if (slot.fence && (!oldest || slot.issueTime < oldest->issueTime))
+            oldest = &slot;
+    if (!oldest)
+        return nullptr;
+
+    ++_uploadStallCount;
+
+    const auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(_uploadMaxWait).count();
+    const auto waitResult = glClientWaitSync(oldest->fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    if (waitResult == GL_TIMEOUT_EXPIRED || waitResult == GL_WAIT_FAILED)
     {
-        Log::get() << Log::ERROR << "Texture_Image::" << __FUNCTION__ << " - Unable to initialize upload PBOs" << Log::endl;
-        return false;
+        Log::get() << Log::WARNING << "Texture_Image::" << __FUNCTION__ << " - Unable to get a free upload buffer for texture " << _name << Log::endl;
+        return nullptr;
     }
 
-    return true;
+    glDeleteSync(oldest->fence);
+    oldest->fence = nullptr;
+    return oldest;
+}
+
+/*************/
+void Texture_Image::uploadFromSlot(UploadSlot& slot)
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+    if (!_uploadFormat.isCompressed)
+        glTextureSubImage2D(_glTex, 0, 0, 0, _uploadFormat.width, _uploadFormat.height, _uploadFormat.channelOrder, _uploadFormat.dataFormat, 0);
+    else
+        glCompressedTextureSubImage2D(_glTex, 0, 0, 0, _uploadFormat.width, _uploadFormat.height, _uploadFormat.internalFormat, _uploadFormat.size, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.issueTime = std::chrono::steady_clock::now();
 }
 
 /*************/
@@ -606,6 +713,9 @@ void Texture_Image::registerAttributes()
         },
         {'i', 'i'});
     setAttributeDescription("size", "Change the texture size");
+
+    addAttribute("uploadStalls", [&]() -> Values { return {_uploadStallCount}; });
+    setAttributeDescription("uploadStalls", "Number of times an upload had to wait for the GPU to be done with a previous one");
 }
 
 } // namespace Splash
@@ -25,6 +25,8 @@
 #ifndef SPLASH_TEXTURE_IMAGE_H
 #define SPLASH_TEXTURE_IMAGE_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <glm/glm.hpp>
@@ -107,7 +109,13 @@ class Texture_Image final : public Texture
      * Get the shader parameters related to this texture. Texture should be locked first.
      * \return Return the shader uniforms
      */
-    std::unordered_map<std::string, Values> getShaderUniforms() const final;
+    ShaderUniforms getShaderUniforms() const final;
+
+    /**
+     * Check whether the texture holds sRGB data which is not sampled as such, which is the case of planar YUV images
+     * \return Return true if the data is sRGB
+     */
+    bool isSrgb() const final { return _unsampledSrgb; }
 
     /**
      * Grab the texture to the host memory, at the given mipmap level
@@ -171,17 +179,48 @@ class Texture_Image final : public Texture
         BGR=1,
         UYVY=2,
         YUYV=3,
-        YCoCg=4
+        YCoCg=4,
+        YUV420P=5,
+        NV12=6,
+        YUV422P=7
+    };
+
+    // Ring of persistently mapped buffers the frames are written to before being uploaded to the texture.
+    // A fence is inserted after each upload, and a buffer is only written to again once its fence is signaled.
+    // A slot holding a fence is in flight, and is free again once the fence has been reclaimed.
+    struct UploadSlot
+    {
+        GLuint buffer{0};
+        uint8_t* mapping{nullptr};
+        size_t capacity{0};
+        GLsync fence{nullptr};
+        std::chrono::steady_clock::time_point issueTime{};
+    };
+
+    // Upload parameters, set when the texture storage is created
+    struct UploadFormat
+    {
+        int width{0};
+        int height{0};
+        size_t size{0};
+        GLenum channelOrder{GL_RGBA};
+        GLenum dataFormat{GL_UNSIGNED_BYTE};
+        GLenum internalFormat{GL_RGBA};
+        bool isCompressed{false};
     };
 
     GLuint _glTex{0};
-    GLuint _pbos[2];
-    GLubyte* _pbosPixels[2];
+
+    static constexpr size_t _uploadRingSize{3};
+    static constexpr std::chrono::milliseconds _uploadMaxWait{100}; //!< Maximum wait for a buffer, after which the upload is done synchronously
+    std::array<UploadSlot, _uploadRingSize> _uploadSlots{};
+    UploadFormat _uploadFormat{};
+    int64_t _uploadStallCount{0}; //!< Number of times an upload had to wait for a buffer to be freed
 
     int _multisample{0};
     bool _cubemap{false};
-    int _pboUploadIndex{0};
     int64_t _lastDrawnTimestamp{0};
+    std::atomic_bool _unsampledSrgb{false}; //!< True if the texture holds sRGB data without an sRGB internal format
 
     // Store some texture parameters
     static const int _texLevels = 4;
@@ -197,7 +236,7 @@ class Texture_Image final : public Texture
     std::weak_ptr<Image> _img;
 
     // Parameters to send to the shader
-    std::unordered_map<std::string, Values> _shaderUniforms;
+    ShaderUniforms _shaderUniforms{};
 
     /**
      * Initialization
@@ -212,13 +251,34 @@ class Texture_Image final : public Texture
     GLenum getChannelOrder(const ImageBufferSpec& spec);
 
     /**
-     * Update the pbos according to the parameters
-     * \param width Width
-     * \param height Height
-     * \param bytes Bytes per pixel
+     * Make sure the upload buffers can hold the given size, recreating them if needed
+     * \param size Image size in bytes
      * \return Return true if all went well
      */
-    bool updatePbos(int width, int height, int bytes);
+    bool updateUploadRing(size_t size);
+
+    /**
+     * Release the GL objects held by an upload slot
+     * \param slot Upload slot
+     */
+    static void releaseUploadSlot(UploadSlot& slot);
+
+    /**
+     * Free the slots the GPU is done uploading from
+     */
+    void reclaimUploadSlots();
+
+    /**
+     * Get a free slot to copy a frame to, waiting for the oldest upload if needed
+     * \return Return a free slot, or nullptr if none could be acquired
+     */
+    UploadSlot* acquireFreeSlot();
+
+    /**
+     * Upload the content of a slot to the texture, and insert a fence after the upload
+     * \param slot Upload slot
+     */
+    void uploadFromSlot(UploadSlot& slot);
 
     /**
      * Register new functors to modify attributes
@@ -45,11 +45,11 @@ void VirtualProbe::unbind()
 }
 
 /*************/
-std::unordered_map<std::string, Values> VirtualProbe::getShaderUniforms() const
+Texture::ShaderUniforms VirtualProbe::getShaderUniforms() const
 {
     auto spec = _outFbo->getColorTexture()->getSpec();
-    std::unordered_map<std::string, Values> uniforms;
-    uniforms["size"] = {static_cast<float>(_spec.width), static_cast<float>(spec.height)};
+    ShaderUniforms uniforms;
+    uniforms.size = glm::vec2(static_cast<float>(_spec.width), static_cast<float>(spec.height));
     return uniforms;
 }
 
@@ -75,7 +75,7 @@ class VirtualProbe final : public Texture
      * Get the shader parameters related to this warp. Texture should be locked first.
      * \return Return the shader uniforms
      */
-    std::unordered_map<std::string, Values> getShaderUniforms() const override;
+    ShaderUniforms getShaderUniforms() const override;
 
     /**
      * Get spec of the texture
@@ -60,11 +60,11 @@ void Warp::bind()
 }
 
 /*************/
-std::unordered_map<std::string, Values> Warp::getShaderUniforms() const
+Texture::ShaderUniforms Warp::getShaderUniforms() const
 {
     auto spec = _fbo->getColorTexture()->getSpec();
-    std::unordered_map<std::string, Values> uniforms;
-    uniforms["size"] = {static_cast<float>(_spec.width), static_cast<float>(spec.height)};
+    ShaderUniforms uniforms;
+    uniforms.size = glm::vec2(static_cast<float>(_spec.width), static_cast<float>(spec.height));
     return uniforms;
 }
 
@@ -336,6 +336,7 @@ void Warp::registerAttributes()
         },
         {'i', 'i'});
     setAttributeDescription("size", "Size of the rendered output");
+    setAttributeVolatile("size", true);
 
     // Show the Bezier patch describing the warp
     // Also resets the selected control point if hidden
@@ -377,10 +378,12 @@ void Warp::registerAttributes()
     addAttribute(
         "buffer", [&](const Values&) { return true; }, [&]() -> Values { return {_mipmapBuffer}; }, {});
     setAttributeDescription("buffer", "Getter attribute which gives access to the mipmap image, if grabMipmapLevel is greater or equal to 0");
+    setAttributeVolatile("buffer", true);
 
     addAttribute(
         "bufferSpec", [&](const Values&) { return true; }, [&]() -> Values { return _mipmapBufferSpec; }, {});
     setAttributeDescription("bufferSpec", "Getter attribute to the specs of the attribute buffer");
+    setAttributeVolatile("bufferSpec", true);
 }
 
 } // namespace Splash
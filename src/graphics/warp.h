@@ -80,7 +80,7 @@ class Warp final : public Texture
      * Get the shader parameters related to this warp. Texture should be locked first.
      * \return Return the shader uniforms
      */
-    std::unordered_map<std::string, Values> getShaderUniforms() const;
+    ShaderUniforms getShaderUniforms() const;
 
     /**
      * Get the texture the warp is rendered to
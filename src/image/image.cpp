@@ -1,5 +1,6 @@
 #include "./image/image.h"
 
+#include <algorithm>
 #include <fstream>
 #include <future>
 #include <memory>
@@ -10,7 +11,6 @@
 #include <stb_image_write.h>
 
 #include "./core/serializer.h"
-#include "./core/serialize/serialize_imagebuffer.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
 #include "./utils/timer.h"
@@ -105,6 +105,7 @@ void Image::set(unsigned int w, unsigned int h, unsigned int channels, ImageBuff
 {
     ImageBufferSpec spec(w, h, channels, 8 * sizeof(channels) * (int)type, type);
     ImageBuffer img(spec);
+    img.zero();
 
     std::lock_guard<Spinlock> updateLock(_updateMutex);
     std::swap(*_bufferImage, img);
@@ -123,10 +124,39 @@ SerializedObject Image::serialize() const
     if (!_image)
         return {};
 
-    _image->setName(_name);
-    std::vector<uint8_t> data;
-    Serial::serialize(*_image, data);
-    SerializedObject obj(ResizableArray(std::move(data)));
+    SerializedObject obj;
+
+    // Frames held by a FramePool are sent as a handle to their slot, the others as raw data
+    const auto frame = _image->getFrame();
+    const auto spec = _image->getSpec();
+    if (frame)
+    {
+        const auto header = std::make_tuple(_name, spec.to_string(), static_cast<uint8_t>(PayloadType::FrameHandle), frame->getHandle());
+        obj = SerializedObject(Serial::getSize(header));
+        Span<uint8_t> output(obj);
+        Serial::serializeTo(header, output);
+
+        std::lock_guard<std::mutex> lockPool(_framePoolMutex);
+        if (_inFlightFrames.empty() || _inFlightFrames.back() != frame)
+            _inFlightFrames.push_back(frame);
+        while (_inFlightFrames.size() > _inFlightFrameCount)
+            _inFlightFrames.pop_front();
+    }
+    else
+    {
+        const auto header = std::make_tuple(_name, spec.to_string(), static_cast<uint8_t>(PayloadType::Raw));
+        const auto rawSize = static_cast<size_t>(spec.rawSize());
+        obj = SerializedObject(Serial::getSize(header) + rawSize);
+        Span<uint8_t> output(obj);
+        Serial::serializeTo(header, output);
+        const auto data = reinterpret_cast<const uint8_t*>(_image->data());
+        std::copy(data, data + rawSize, output.data());
+
+        // The image is sent to another process, next frames will be allocated in shared memory
+        std::lock_guard<std::mutex> lockPool(_framePoolMutex);
+        if (!_framePool && _root)
+            _framePool = std::make_unique<FramePool>("splash_" + _root->getSocketPrefix() + "_" + std::to_string(getpid()) + "_" + _name);
+    }
 
     if (Timer::get().isDebug())
         Timer::get() >> ("serialize " + _name);
@@ -148,9 +178,46 @@ bool Image::deserialize(SerializedObject&& obj)
 
     // We only deserialize part of the serialized ImageBuffer,
     // to prevent copying the content of the buffer another time
-    auto serializedImageIt = serializedImage.cbegin();
-    _name = Serial::detail::deserializer<std::string>(serializedImageIt);
-    const ImageBufferSpec spec(Serial::detail::deserializer<std::string>(serializedImageIt));
+    Span<const uint8_t> input(serializedImage);
+    _name = Serial::deserializeFrom<std::string>(input);
+    const ImageBufferSpec spec(Serial::deserializeFrom<std::string>(input));
+    const auto payloadType = static_cast<PayloadType>(Serial::deserializeFrom<uint8_t>(input));
+
+    // The image has been sent as a handle to a FramePool slot
+    const auto shift = serializedImage.size() - input.size();
+    if (payloadType == PayloadType::FrameHandle)
+    {
+        const auto handle = Serial::deserializeFrom<FramePool::Handle>(input);
+
+        std::shared_ptr<FramePool::Frame> frame;
+        {
+            std::lock_guard<std::mutex> lockPool(_framePoolMutex);
+            if (!_framePool)
+                _framePool = std::make_unique<FramePool>();
+            frame = _framePool->map(handle);
+        }
+
+        if (!frame)
+        {
+            Log::get() << Log::DEBUGGING << "Image::" << __FUNCTION__ << " - Frame " << std::get<0>(handle) << " is not available anymore, dropping it" << Log::endl;
+            return false;
+        }
+
+        _bufferImage = std::make_unique<ImageBuffer>(spec, frame);
+        _bufferImageUpdated = true;
+        updateTimestamp(_bufferImage->getSpec().timestamp);
+
+        if (Timer::get().isDebug())
+            Timer::get() >> ("deserialize " + _name);
+
+        return true;
+    }
+
+    if (payloadType != PayloadType::Raw || input.size() != static_cast<size_t>(spec.rawSize()))
+    {
+        Log::get() << Log::WARNING << "Image::" << __FUNCTION__ << " - Received an invalid image payload for image " << _name << Log::endl;
+        return false;
+    }
 
     // If the specs did change, regenerate a buffer
     // Otherwise make sure the timestamp is updated
@@ -159,7 +226,6 @@ bool Image::deserialize(SerializedObject&& obj)
     else
         _bufferImage->getSpec().timestamp = spec.timestamp;
 
-    auto shift = std::distance(serializedImage.cbegin(), serializedImageIt);
     serializedImage.shift(shift);
     _bufferImage->setRawBuffer(std::move(serializedImage));
 
@@ -172,6 +238,23 @@ bool Image::deserialize(SerializedObject&& obj)
     return true;
 }
 
+/*************/
+std::unique_ptr<ImageBuffer> Image::createImageBuffer(const ImageBufferSpec& spec)
+{
+    std::shared_ptr<FramePool::Frame> frame;
+    {
+        std::lock_guard<std::mutex> lockPool(_framePoolMutex);
+        if (_framePool)
+            frame = _framePool->acquire(spec.rawSize());
+    }
+
+    // Fall back to a regular buffer if the pool has no free slot
+    if (frame)
+        return std::make_unique<ImageBuffer>(spec, frame);
+    else
+        return std::make_unique<ImageBuffer>(spec);
+}
+
 /*************/
 bool Image::read(const std::string& filename)
 {
@@ -26,12 +26,14 @@
 #define SPLASH_IMAGE_H
 
 #include <chrono>
+#include <deque>
 #include <mutex>
 
 #include "./core/constants.h"
 
 #include "./core/attribute.h"
 #include "./core/buffer_object.h"
+#include "./core/frame_pool.h"
 #include "./core/imagebuffer.h"
 #include "./core/root_object.h"
 
@@ -183,6 +185,14 @@ class Image : public BufferObject
     void createDefaultImage(); //< Create a default black image
     void createPattern();      //< Create a default pattern
 
+    /**
+     * Create an image buffer to hold a new frame. Once this image has been serialized, the buffer
+     * is taken from a shared FramePool so that it is sent to other processes without being copied
+     * \param spec Image spec
+     * \return Return the image buffer
+     */
+    std::unique_ptr<ImageBuffer> createImageBuffer(const ImageBufferSpec& spec);
+
     /**
      * Update the _mediaInfo member
      */
@@ -208,11 +218,23 @@ class Image : public BufferObject
     virtual void updateTimestamp(int64_t timestamp = -1) final;
 
   private:
+    // Type of the payload following the name and spec in a serialized image
+    enum class PayloadType : uint8_t
+    {
+        Raw = 0,        //!< Raw image data
+        FrameHandle = 1 //!< Handle to a FramePool slot holding the image data
+    };
+
     static const uint32_t _imageCopyThreads = 2;
     static const uint32_t _serializedImageHeaderSize = 4096;
+    static const uint32_t _inFlightFrameCount = 4;
     // Deserialization is done in this buffer, to avoid realloc
     ImageBuffer _bufferDeserialize;
 
+    mutable std::mutex _framePoolMutex{};
+    mutable std::unique_ptr<FramePool> _framePool{nullptr};                   //!< Pool for the frames sent to other processes, or mapped from them
+    mutable std::deque<std::shared_ptr<FramePool::Frame>> _inFlightFrames{}; //!< Last frames sent, kept until the receivers had time to map them
+
     /**
      * Add more media info, to be implemented by derived classes
      */
@@ -1,8 +1,8 @@
 #include "./image/image_ffmpeg.h"
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
-#include <future>
 #include <numeric>
 #if HAVE_LINUX
 #include <fcntl.h>
@@ -13,6 +13,7 @@
 #include "./utils/cgutils.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
+#include "./utils/thread_pool.h"
 #include "./utils/timer.h"
 
 namespace chrono = std::chrono;
@@ -25,6 +26,7 @@ Image_FFmpeg::Image_FFmpeg(RootObject* root)
     : Image(root)
 {
     _type = "image_ffmpeg";
+    _timedFrames.setMaxDepth(_maximumFrameCount, _maximumBufferSize);
     registerAttributes();
 
     // This is used for getting documentation "offline"
@@ -41,6 +43,8 @@ Image_FFmpeg::~Image_FFmpeg()
 /*************/
 void Image_FFmpeg::freeFFmpegObjects()
 {
+    // A pending seek uses the context which is about to be freed
+    ThreadPool::get().wait(_seekFuture);
     _clockTime = -1;
 
     if (_continueRead)
@@ -121,6 +125,27 @@ bool Image_FFmpeg::read(const std::string& filename)
     return true;
 }
 
+/*************/
+ImageBufferSpec Image_FFmpeg::getPlanarSpec(AVPixelFormat pixelFormat, int width, int height)
+{
+    // Planes are stored one after the other in a single channel texture as wide as the image,
+    // so chroma subsampling must not lead to partial rows, and rows must respect the unpack alignment
+    if (width % 4 != 0 || height % 2 != 0)
+        return {};
+
+    switch (pixelFormat)
+    {
+    default:
+        return {};
+    case AV_PIX_FMT_YUV420P:
+        return ImageBufferSpec(width, height, 3, 12, ImageBufferSpec::Type::UINT8, "YUV420P");
+    case AV_PIX_FMT_NV12:
+        return ImageBufferSpec(width, height, 3, 12, ImageBufferSpec::Type::UINT8, "NV12");
+    case AV_PIX_FMT_YUV422P:
+        return ImageBufferSpec(width, height, 3, 16, ImageBufferSpec::Type::UINT8, "YUV422P");
+    }
+}
+
 /*************/
 std::string Image_FFmpeg::tagToFourCC(unsigned int tag)
 {
@@ -325,25 +350,8 @@ void Image_FFmpeg::readLoop()
         return;
     }
 
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
-    std::vector<unsigned char> buffer(numBytes);
-
+    // The conversion context is only created if a frame can not be sent as planar YUV
     struct SwsContext* swsContext = nullptr;
-    if (!isHap)
-    {
-        swsContext = sws_getContext(videoCodecContext->width,
-            videoCodecContext->height,
-            videoCodecContext->pix_fmt,
-            videoCodecContext->width,
-            videoCodecContext->height,
-            AV_PIX_FMT_YUYV422,
-            SWS_BILINEAR,
-            nullptr,
-            nullptr,
-            nullptr);
-
-        av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, buffer.data(), AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
-    }
 
     AVPacket* packet = av_packet_alloc();
     if (!packet)
@@ -354,6 +362,21 @@ void Image_FFmpeg::readLoop()
 
     _videoTimeBase = static_cast<double>(videoStream->time_base.num) / static_cast<double>(videoStream->time_base.den);
 
+    // Hap frames are decoded by a few threads at once, each of them also
+    // decoding the chunks of its frame in parallel
+    std::vector<std::thread> hapDecoders;
+    if (isHap)
+    {
+        const auto hapDecoderCount = std::clamp(Utils::getCoreCount() / 4, 2, 4);
+        {
+            std::lock_guard<std::mutex> lockHap(_hapMutex);
+            _hapMaxPendingPackets = hapDecoderCount * 2;
+            _hapRunDecoders = true;
+        }
+        for (int i = 0; i < hapDecoderCount; ++i)
+            hapDecoders.emplace_back([=]() { hapDecodeLoop(videoCodecContext->width, videoCodecContext->height); });
+    }
+
     // This implements looping
     _startTime = Timer::getTime();
     while (_continueRead)
@@ -384,13 +407,28 @@ void Image_FFmpeg::readLoop()
 
                     if (frameFinished)
                     {
-                        sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, videoCodecContext->height, rgbFrame->data, rgbFrame->linesize);
+                        const auto pixelFormat = static_cast<AVPixelFormat>(frame->format);
+                        const auto planarSpec = getPlanarSpec(pixelFormat, frame->width, frame->height);
+
+                        // Planar YUV frames are sent as-is, the conversion to RGB being done on the GPU.
+                        // Other formats are converted to YUYV. In both cases the frame is written straight
+                        // into its image buffer, which may live in shared memory
+                        if (planarSpec.rawSize() != 0)
+                        {
+                            img = createImageBuffer(planarSpec);
+                            av_image_copy_to_buffer(img->data(), planarSpec.rawSize(), frame->data, frame->linesize, pixelFormat, frame->width, frame->height, 1);
+                        }
+                        else
+                        {
+                            swsContext = sws_getCachedContext(
+                                swsContext, frame->width, frame->height, pixelFormat, frame->width, frame->height, AV_PIX_FMT_YUYV422, SWS_BILINEAR, nullptr, nullptr, nullptr);
 
-                        ImageBufferSpec spec(videoCodecContext->width, videoCodecContext->height, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
-                        img.reset(new ImageBuffer(spec));
+                            ImageBufferSpec spec(frame->width, frame->height, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
+                            img = createImageBuffer(spec);
 
-                        unsigned char* pixels = reinterpret_cast<unsigned char*>(img->data());
-                        std::copy(buffer.begin(), buffer.end(), pixels);
+                            av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, img->data(), AV_PIX_FMT_YUYV422, frame->width, frame->height, 1);
+                            sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, frame->height, rgbFrame->data, rgbFrame->linesize);
+                        }
 
                         if (packet->pts != AV_NOPTS_VALUE)
                             timing = static_cast<uint64_t>((double)frame->best_effort_timestamp * _videoTimeBase * 1e6);
@@ -405,84 +443,32 @@ void Image_FFmpeg::readLoop()
                     av_frame_unref(frame);
                 }
                 //
-                // If the codec is marked as Hap / Hap alpha / Hap Q
+                // If the codec is marked as Hap / Hap alpha / Hap Q, the packet is handed to the
+                // Hap decoding threads which will queue the frame once decoded
                 else if (isHap)
                 {
-                    // We are using kind of a hack to store a DXT compressed image in an ImageBuffer
-                    // First, we check the texture format type
-                    std::string textureFormat;
-                    if (hapDecodeFrame(packet->data, packet->size, nullptr, 0, textureFormat))
-                    {
-                        // Check if we need to resize the reader buffer
-                        // We set the size so as to have just enough place for the given texture format
-                        ImageBufferSpec spec;
-                        if (textureFormat == "RGB_DXT1")
-                        {
-                            spec = ImageBufferSpec(videoCodecContext->width, (int)(ceil((float)videoCodecContext->height / 2.f)), 1, 8, ImageBufferSpec::Type::UINT8);
-                        }
-                        else if (textureFormat == "RGBA_DXT5")
-                        {
-                            spec = ImageBufferSpec(videoCodecContext->width, videoCodecContext->height, 1, 8, ImageBufferSpec::Type::UINT8);
-                        }
-                        else if (textureFormat == "YCoCg_DXT5")
-                        {
-                            spec = ImageBufferSpec(videoCodecContext->width, videoCodecContext->height, 1, 8, ImageBufferSpec::Type::UINT8);
-                        }
-                        else
-                        {
-                            av_packet_unref(packet);
-                            return;
-                        }
-
-                        spec.format = {textureFormat};
-                        img.reset(new ImageBuffer(spec));
-
-                        unsigned long outputBufferBytes = spec.width * spec.height * spec.channels;
-
-                        if (hapDecodeFrame(packet->data, packet->size, img->data(), outputBufferBytes, textureFormat))
-                        {
-                            if (packet->pts != AV_NOPTS_VALUE)
-                                timing = static_cast<uint64_t>(static_cast<double>(packet->pts) * _videoTimeBase * 1e6);
-                            else
-                                timing = 0.0;
+                    auto hapPacket = av_packet_alloc();
+                    av_packet_move_ref(hapPacket, packet);
 
-                            hasFrame = true;
-                        }
-                    }
+                    std::unique_lock<std::mutex> lockHap(_hapMutex);
+                    _hapCondition.wait(lockHap, [&]() { return _hapPackets.size() < _hapMaxPendingPackets; });
+                    _hapPackets.push_back({hapPacket, _hapNextPacketSequence++});
+                    _hapCondition.notify_all();
                 }
 
-                int64_t totalBufferSize = 0;
+                if (hasFrame)
                 {
-                    std::lock_guard<std::mutex> lockFrames(_videoQueueMutex);
-                    if (hasFrame)
-                    {
-                        // Add the frame size to the history
-                        _framesSize.push_back(img->getSize());
-
-                        _timedFrames.emplace_back();
-                        std::swap(_timedFrames[_timedFrames.size() - 1].frame, img);
-                        _timedFrames[_timedFrames.size() - 1].timing = timing;
-                    }
-
-                    // Check the current buffer size (sum of all frames in buffer)
-                    for (auto& f : _framesSize)
-                        totalBufferSize += f;
+                    const auto frameSize = img->getSize();
+                    if (!_timedFrames.tryPush({std::move(img), timing}, frameSize))
+                        Log::get() << Log::WARNING << "Image_FFmpeg::" << __FUNCTION__ << " - Frame queue is full, dropping a frame" << Log::endl;
                 }
 
-                int timedFramesBuffered = _timedFrames.size();
-
                 _videoSeekMutex.unlock();
                 av_packet_unref(packet);
 
                 // Do not store more than a few frames in memory
-                // _maximumBufferSize is divided by 2 as another frame queue is held by the display loop
-                while (timedFramesBuffered > 0 && totalBufferSize > _maximumBufferSize / 2 && _continueRead)
-                {
-                    std::this_thread::sleep_for(chrono::milliseconds(5));
-                    std::lock_guard<std::mutex> lockSeek(_videoSeekMutex);
-                    std::lock_guard<std::mutex> lockQueue(_videoQueueMutex);
-                    timedFramesBuffered = _timedFrames.size();
-                }
+                while (_continueRead && !_timedFrames.waitNotFull(chrono::milliseconds(100)))
+                    continue;
             }
 #if HAVE_PORTAUDIO
             // Reading the audio
@@ -527,8 +513,17 @@ void Image_FFmpeg::readLoop()
             }
         }
 
-        // This prevents looping to happen before the queue has been consumed
-        std::lock_guard<std::mutex> lockEnd(_videoEndMutex);
+        // This prevents looping to happen before the queue has been consumed,
+        // including the frames still being decoded by the Hap decoding threads
+        if (isHap)
+        {
+            std::unique_lock<std::mutex> lockHap(_hapMutex);
+            while (_continueRead && _hapNextFrameSequence != _hapNextPacketSequence)
+                _hapCondition.wait_for(lockHap, chrono::milliseconds(100));
+        }
+
+        while (_continueRead && !_timedFrames.waitEmpty(chrono::milliseconds(100)))
+            continue;
 
         // If we loop, seek to the beginning, or whatever time is set in _trimStart
         if (_loopOnVideo)
@@ -537,9 +532,21 @@ void Image_FFmpeg::readLoop()
             std::this_thread::sleep_for(chrono::milliseconds(50));
     }
 
+    if (!hapDecoders.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lockHap(_hapMutex);
+            _hapRunDecoders = false;
+        }
+        _hapCondition.notify_all();
+        for (auto& decoder : hapDecoders)
+            decoder.join();
+        resetHapPipeline();
+    }
+
     av_frame_free(&rgbFrame);
     av_frame_free(&frame);
-    if (!isHap)
+    if (swsContext)
         sws_freeContext(swsContext);
     avcodec_close(videoCodecContext);
     avcodec_free_context(&videoCodecContext);
@@ -555,6 +562,102 @@ void Image_FFmpeg::readLoop()
 #endif
 }
 
+/*************/
+Image_FFmpeg::TimedFrame Image_FFmpeg::decodeHapPacket(const AVPacket* packet, int width, int height)
+{
+    // We are using kind of a hack to store a DXT compressed image in an ImageBuffer
+    // First, we check the texture format type
+    TimedFrame timedFrame;
+    std::string textureFormat;
+    if (!hapDecodeFrame(packet->data, packet->size, nullptr, 0, textureFormat))
+        return timedFrame;
+
+    // We set the size so as to have just enough place for the given texture format
+    ImageBufferSpec spec;
+    if (textureFormat == "RGB_DXT1")
+        spec = ImageBufferSpec(width, (int)(ceil((float)height / 2.f)), 1, 8, ImageBufferSpec::Type::UINT8);
+    else if (textureFormat == "RGBA_DXT5")
+        spec = ImageBufferSpec(width, height, 1, 8, ImageBufferSpec::Type::UINT8);
+    else if (textureFormat == "YCoCg_DXT5")
+        spec = ImageBufferSpec(width, height, 1, 8, ImageBufferSpec::Type::UINT8);
+    else
+        return timedFrame;
+
+    spec.format = {textureFormat};
+    auto img = createImageBuffer(spec);
+
+    unsigned long outputBufferBytes = spec.width * spec.height * spec.channels;
+    if (!hapDecodeFrame(packet->data, packet->size, img->data(), outputBufferBytes, textureFormat))
+        return timedFrame;
+
+    if (packet->pts != AV_NOPTS_VALUE)
+        timedFrame.timing = static_cast<uint64_t>(static_cast<double>(packet->pts) * _videoTimeBase * 1e6);
+    timedFrame.frame = std::move(img);
+    return timedFrame;
+}
+
+/*************/
+void Image_FFmpeg::hapDecodeLoop(int width, int height)
+{
+    while (true)
+    {
+        HapPacket hapPacket;
+        uint64_t generation = 0;
+        {
+            std::unique_lock<std::mutex> lockHap(_hapMutex);
+            _hapCondition.wait(lockHap, [&]() { return !_hapPackets.empty() || !_hapRunDecoders; });
+            if (!_hapRunDecoders)
+                return;
+
+            hapPacket = _hapPackets.front();
+            _hapPackets.pop_front();
+            generation = _hapGeneration;
+        }
+        // Wake up the read loop if it waits for room in the packet queue
+        _hapCondition.notify_all();
+
+        auto timedFrame = decodeHapPacket(hapPacket.packet, width, height);
+        av_packet_free(&hapPacket.packet);
+
+        std::lock_guard<std::mutex> lockHap(_hapMutex);
+        // The pipeline has been reset while decoding, after a seek
+        if (generation != _hapGeneration)
+            continue;
+
+        // Frames which failed to decode are kept as empty frames, to keep the sequence contiguous
+        _hapDecodedFrames.emplace(hapPacket.sequence, std::move(timedFrame));
+
+        // The frames are pushed with _hapMutex held, so there is a single producer at a time
+        auto frameIt = _hapDecodedFrames.begin();
+        while (frameIt != _hapDecodedFrames.end() && frameIt->first == _hapNextFrameSequence)
+        {
+            if (frameIt->second.frame)
+            {
+                const auto frameSize = frameIt->second.frame->getSize();
+                if (!_timedFrames.tryPush(std::move(frameIt->second), frameSize))
+                    Log::get() << Log::WARNING << "Image_FFmpeg::" << __FUNCTION__ << " - Frame queue is full, dropping a frame" << Log::endl;
+            }
+            frameIt = _hapDecodedFrames.erase(frameIt);
+            ++_hapNextFrameSequence;
+        }
+        _hapCondition.notify_all();
+    }
+}
+
+/*************/
+void Image_FFmpeg::resetHapPipeline()
+{
+    std::lock_guard<std::mutex> lockHap(_hapMutex);
+    for (auto& hapPacket : _hapPackets)
+        av_packet_free(&hapPacket.packet);
+    _hapPackets.clear();
+    _hapDecodedFrames.clear();
+    _hapNextPacketSequence = 0;
+    _hapNextFrameSequence = 0;
+    ++_hapGeneration;
+    _hapCondition.notify_all();
+}
+
 #if HAVE_PORTAUDIO
 /*************/
 void Image_FFmpeg::audioLoop()
@@ -620,10 +723,9 @@ void Image_FFmpeg::seek(float seconds, bool clearQueues)
     }
     else
     {
-        std::lock_guard<std::mutex> lockQueue(_videoQueueMutex);
-        // As seeking will no necessarily go to the desired timestamp, but to the closest i-frame,
-        // we will set _startTime at the next frame in the videoDisplayLoop
-        _startTime = -1;
+        // Frames being decoded by the Hap decoding threads are from before the seek
+        if (clearQueues)
+            resetHapPipeline();
 
         if (clearQueues)
         {
@@ -633,16 +735,22 @@ void Image_FFmpeg::seek(float seconds, bool clearQueues)
                 _speaker->clearQueue();
 #endif
         }
+
+        // As seeking will no necessarily go to the desired timestamp, but to the closest i-frame,
+        // we will set _startTime at the next frame in the videoDisplayLoop
+        _startTime = -1;
     }
 }
 
 /*************/
 void Image_FFmpeg::seek_async(float seconds, bool clearQueues)
 {
-    _seekFuture = std::async(std::launch::async, [=]() {
-        seek(seconds, clearQueues);
-        _timeJump = false;
-    });
+    _seekFuture = ThreadPool::get().submit(
+        [=]() {
+            seek(seconds, clearQueues);
+            _timeJump = false;
+        },
+        ThreadPool::Priority::High);
 }
 
 /*************/
@@ -650,130 +758,119 @@ void Image_FFmpeg::videoDisplayLoop()
 {
     while (_continueRead)
     {
-        auto localQueue = std::deque<TimedFrame>();
-        if (!_timedFrames.empty())
-        {
-            std::lock_guard<std::mutex> lockFrames(_videoQueueMutex);
-            std::swap(localQueue, _timedFrames);
-            _framesSize.clear();
-        }
-        else
-        {
-            std::this_thread::sleep_for(chrono::milliseconds(1));
+        if (!_timedFrames.waitNotEmpty(chrono::milliseconds(100)))
             continue;
-        }
+
+        // The queue may have been cleared by a seek in-between
+        auto nextFrame = _timedFrames.front();
+        if (!nextFrame)
+            continue;
+        TimedFrame& timedFrame = *nextFrame;
 
         // This sets the start time after a seek
-        if (!localQueue.empty() && _startTime == -1)
-            _startTime = Timer::getTime() - localQueue[0].timing;
+        if (_startTime == -1)
+            _startTime = Timer::getTime() - timedFrame.timing;
+
+        //
+        // Get the current master and local clocks
+        //
+        int64_t clockAsMs = 0;
+        bool clockIsPaused = false;
+        bool useClock = _useClock && Timer::get().getMasterClock<chrono::milliseconds>(clockAsMs, clockIsPaused);
+        if (useClock)
+        {
+            float seconds = (float)clockAsMs / 1e3f + _shiftTime + _trimStart;
+            _clockTime = seconds * 1e6;
+        }
 
-        std::lock_guard<std::mutex> lockEnd(_videoEndMutex);
-        while (!localQueue.empty() && _continueRead)
+        //
+        // Show the frame at the right timing, according to clocks
+        //
+        if (timedFrame.timing != 0ull)
         {
-            // If seek, clear the local queue as the frames should not be shown
-            if (_startTime == -1)
+            if (_paused || (clockIsPaused && useClock))
             {
-                localQueue.clear();
+                _startTime = Timer::getTime() - _currentTime;
+                std::this_thread::sleep_for(chrono::milliseconds(2));
                 continue;
             }
-
-            //
-            // Get the current master and local clocks
-            //
-            int64_t clockAsMs = 0;
-            bool clockIsPaused = false;
-            bool useClock = _useClock && Timer::get().getMasterClock<chrono::milliseconds>(clockAsMs, clockIsPaused);
-            if (useClock)
+            else if (useClock && _clockTime != -1l)
+            {
+                _currentTime = Timer::getTime() - _startTime;
+                auto delta = abs(_currentTime - _clockTime);
+                // If the difference between master clock and local clock is greater than 1.5 frames @30Hz, we adjust local clock
+                if (delta > 50000)
+                {
+                    _startTime = Timer::getTime() - _clockTime;
+                    _currentTime = _clockTime;
+                }
+            }
+            else
             {
-                float seconds = (float)clockAsMs / 1e3f + _shiftTime + _trimStart;
-                _clockTime = seconds * 1e6;
+                _currentTime = Timer::getTime() - _startTime;
             }
 
-            //
-            // Show the frame at the right timing, according to clocks
-            //
-            TimedFrame& timedFrame = localQueue[0];
-            if (timedFrame.timing != 0ull)
+            // If the frame is beyond the trimming end, seek to the trimming start
+            if (_trimEnd > _trimStart)
             {
-                if (_paused || (clockIsPaused && useClock))
+                if (timedFrame.timing < _trimStart)
                 {
-                    _startTime = Timer::getTime() - _currentTime;
-                    std::this_thread::sleep_for(chrono::milliseconds(2));
+                    auto expectedValue = false;
+                    _timedFrames.clear();
+                    if (_timeJump.compare_exchange_strong(expectedValue, true, std::memory_order_acquire))
+                        seek_async(static_cast<float>(_trimStart) / 1e6);
                     continue;
                 }
-                else if (useClock && _clockTime != -1l)
-                {
-                    _currentTime = Timer::getTime() - _startTime;
-                    auto delta = abs(_currentTime - _clockTime);
-                    // If the difference between master clock and local clock is greater than 1.5 frames @30Hz, we adjust local clock
-                    if (delta > 50000)
-                    {
-                        _startTime = Timer::getTime() - _clockTime;
-                        _currentTime = _clockTime;
-                    }
-                }
-                else
+                else if (timedFrame.timing > _trimEnd)
                 {
-                    _currentTime = Timer::getTime() - _startTime;
+                    auto expectedValue = false;
+                    _timedFrames.clear();
+                    if (_timeJump.compare_exchange_strong(expectedValue, true, std::memory_order_acquire))
+                        seek_async(getMediaDuration());
+                    continue;
                 }
+            }
+
+            // Compute the difference between next frame and the current clock
+            int64_t waitTime = timedFrame.timing - _currentTime;
 
-                // If the frame is beyond the trimming end, seek to the trimming start
-                if (_trimEnd > _trimStart)
+            // If the gap is too big, we seek through the video
+            if (abs(waitTime / 1e6) > (_intraOnly ? 1.f : 3.f)) // Maximum gap duration depending on encoding type (arbitrary values)
+            {
+                auto expectedValue = false;
+                if (_timeJump.compare_exchange_strong(expectedValue, true, std::memory_order_acquire))
                 {
-                    if (timedFrame.timing < _trimStart)
-                    {
-                        auto expectedValue = false;
-                        localQueue.clear();
-                        if (_timeJump.compare_exchange_strong(expectedValue, true, std::memory_order_acquire))
-                            seek_async(static_cast<float>(_trimStart) / 1e6);
-                        continue;
-                    }
-                    else if (timedFrame.timing > _trimEnd)
-                    {
-                        auto expectedValue = false;
-                        localQueue.clear();
-                        if (_timeJump.compare_exchange_strong(expectedValue, true, std::memory_order_acquire))
-                            seek_async(getMediaDuration());
-                        continue;
-                    }
+                    _elapsedTime = _currentTime / 1e6;
+                    _timedFrames.clear();
+                    seek_async(_elapsedTime);
                 }
-
-                // Compute the difference between next frame and the current clock
-                int64_t waitTime = timedFrame.timing - _currentTime;
-
-                // If the gap is too big, we seek through the video
-                if (abs(waitTime / 1e6) > (_intraOnly ? 1.f : 3.f)) // Maximum gap duration depending on encoding type (arbitrary values)
+                else
                 {
-                    auto expectedValue = false;
-                    if (_timeJump.compare_exchange_strong(expectedValue, true, std::memory_order_acquire))
-                    {
-                        _elapsedTime = _currentTime / 1e6;
-                        localQueue.clear();
-                        seek_async(_elapsedTime);
-                    }
-
-                    continue;
+                    // A seek is already running, this frame will not be shown
+                    _timedFrames.pop();
                 }
 
-                // Wait for the right time to display the frame
-                if (waitTime > 0)
-                    std::this_thread::sleep_for(chrono::microseconds(waitTime));
+                continue;
+            }
 
-                _elapsedTime = timedFrame.timing;
+            // Wait for the right time to display the frame
+            if (waitTime > 0)
+                std::this_thread::sleep_for(chrono::microseconds(waitTime));
 
-                {
-                    std::lock_guard<Spinlock> updateLock(_updateMutex);
-                    if (!_bufferImage)
-                        _bufferImage = std::make_unique<ImageBuffer>();
-                    std::swap(_bufferImage, timedFrame.frame);
-                    _bufferImageUpdated = true;
-                }
+            _elapsedTime = timedFrame.timing;
 
-                updateTimestamp(_bufferImage->getSpec().timestamp);
+            {
+                std::lock_guard<Spinlock> updateLock(_updateMutex);
+                if (!_bufferImage)
+                    _bufferImage = std::make_unique<ImageBuffer>();
+                std::swap(_bufferImage, timedFrame.frame);
+                _bufferImageUpdated = true;
             }
 
-            localQueue.pop_front();
+            updateTimestamp(_bufferImage->getSpec().timestamp);
         }
+
+        _timedFrames.pop();
     }
 }
 
@@ -793,6 +890,7 @@ void Image_FFmpeg::registerAttributes()
         [&](const Values& args) {
             int64_t sizeMB = std::max(16, args[0].as<int>());
             _maximumBufferSize = sizeMB * (int64_t)1048576;
+            _timedFrames.setMaxDepth(_maximumFrameCount, _maximumBufferSize);
             return true;
         },
         [&]() -> Values { return {_maximumBufferSize / (int64_t)1048576}; },
@@ -31,6 +31,7 @@
 #include <condition_variable>
 #include <deque>
 #include <future>
+#include <map>
 #include <mutex>
 #include <thread>
 
@@ -46,6 +47,7 @@ extern "C" {
 
 #include "./core/attribute.h"
 #include "./image/image.h"
+#include "./utils/spsc_queue.h"
 #if HAVE_PORTAUDIO
 #include "./sound/speaker.h"
 #endif
@@ -93,15 +95,30 @@ class Image_FFmpeg final : public Image
         std::unique_ptr<ImageBuffer> frame{};
         uint64_t timing{0ull}; // in us
     };
-    std::deque<TimedFrame> _timedFrames;
-
-    // Frame size history, used to keep the frame buffer smaller than _maximumBufferSize
-    std::vector<int64_t> _framesSize{};
+    // Frames handed from the read loop to the display loop. Its depth is limited to _maximumBufferSize bytes,
+    // and to fewer frames than its slot count to leave room for the frames being decoded by the Hap decoding threads
+    SpscQueue<TimedFrame> _timedFrames{128};
+    static constexpr size_t _maximumFrameCount{96};
     int64_t _maximumBufferSize{(int64_t)1 << 29};
 
-    std::mutex _videoQueueMutex;
+    // Hap decoding pipeline: packets read by readLoop are decoded by a few threads
+    // at once, then the frames are moved to _timedFrames in their reading order
+    struct HapPacket
+    {
+        AVPacket* packet{nullptr};
+        uint64_t sequence{0}; //!< Reading order of the packet
+    };
+    std::mutex _hapMutex{};
+    std::condition_variable _hapCondition{};
+    std::deque<HapPacket> _hapPackets{};                 //!< Packets waiting to be decoded
+    std::map<uint64_t, TimedFrame> _hapDecodedFrames{}; //!< Decoded frames waiting for the previous ones to be decoded
+    size_t _hapMaxPendingPackets{0};                     //!< Maximum number of packets waiting to be decoded
+    uint64_t _hapNextPacketSequence{0};                  //!< Sequence of the next packet read
+    uint64_t _hapNextFrameSequence{0};                   //!< Sequence of the next frame to move to _timedFrames
+    uint64_t _hapGeneration{0};                          //!< Incremented when the pipeline is reset, to discard the frames being decoded
+    bool _hapRunDecoders{false};
+
     std::mutex _videoSeekMutex;
-    std::mutex _videoEndMutex;
     std::future<void> _seekFuture;
 
     std::atomic_bool _timeJump{false};
@@ -150,6 +167,15 @@ class Image_FFmpeg final : public Image
      */
     std::string tagToFourCC(unsigned int tag);
 
+    /**
+     * Get the spec of an image holding a planar YUV frame as-is, to be converted to RGB on the GPU
+     * \param pixelFormat Frame pixel format
+     * \param width Frame width
+     * \param height Frame height
+     * \return Return the spec, with a null size if the frame can not be sent as planar YUV
+     */
+    static ImageBufferSpec getPlanarSpec(AVPixelFormat pixelFormat, int width, int height);
+
     /**
      * Free everything related to FFmpeg
      */
@@ -165,6 +191,27 @@ class Image_FFmpeg final : public Image
      */
     void readLoop();
 
+    /**
+     * Decode a Hap packet
+     * \param packet Packet to decode
+     * \param width Video width
+     * \param height Video height
+     * \return Return the decoded frame, which is empty if decoding failed
+     */
+    TimedFrame decodeHapPacket(const AVPacket* packet, int width, int height);
+
+    /**
+     * Hap decoding loop, run by each Hap decoding thread
+     * \param width Video width
+     * \param height Video height
+     */
+    void hapDecodeLoop(int width, int height);
+
+    /**
+     * Drop the Hap packets waiting to be decoded and the frames being decoded
+     */
+    void resetHapPipeline();
+
     /**
      * Seek in the video
      * \param seconds Desired position
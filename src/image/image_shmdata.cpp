@@ -16,6 +16,7 @@
 #include "./utils/cgutils.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
+#include "./utils/thread_pool.h"
 #include "./utils/timer.h"
 
 namespace Splash
@@ -81,9 +82,7 @@ void Image_Shmdata::onCaps(const std::string& dataType)
         _blue = 0;
         _channels = 0;
         _isHap = false;
-        _isYUV = false;
-        _is420 = false;
-        _is422 = false;
+        _yuvFormat = "";
 
         std::regex regHap, regWidth, regHeight;
         std::regex regVideo, regFormat;
@@ -151,15 +150,25 @@ void Image_Shmdata::onCaps(const std::string& dataType)
                 {
                     _bpp = 12;
                     _channels = 3;
-                    _isYUV = true;
-                    _is420 = true;
+                    _yuvFormat = "YUV420P";
                 }
-                else if ("UYVY" == substr)
+                else if ("NV12" == substr)
                 {
                     _bpp = 12;
                     _channels = 3;
-                    _isYUV = true;
-                    _is422 = true;
+                    _yuvFormat = "NV12";
+                }
+                else if ("UYVY" == substr)
+                {
+                    _bpp = 16;
+                    _channels = 3;
+                    _yuvFormat = "UYVY";
+                }
+                else if ("YUY2" == substr)
+                {
+                    _bpp = 16;
+                    _channels = 3;
+                    _yuvFormat = "YUYV";
                 }
             }
         }
@@ -258,73 +267,54 @@ void Image_Shmdata::readHapFrame(void* data, int data_size)
 }
 
 /*************/
-void Image_Shmdata::readUncompressedFrame(void* data, int /*data_size*/)
+void Image_Shmdata::readUncompressedFrame(void* data, int data_size)
 {
-    // Check if we need to resize the reader buffer
-    auto bufSpec = _readerBuffer.getSpec();
-    if (bufSpec.width != _width || bufSpec.height != _height || bufSpec.channels != _channels)
+    if (_yuvFormat.empty() && _channels != 3 && _channels != 4)
+        return;
+
+    // Planar YUV frames are packed in a single channel texture as wide as the image, which is only possible
+    // for the same sizes as in Image_FFmpeg::getPlanarSpec. Otherwise they are repacked as UYVY
+    const bool isPlanar = _yuvFormat == "YUV420P" || _yuvFormat == "NV12";
+    const bool repackPlanar = isPlanar && (_width % 4 != 0 || _height % 2 != 0);
+
+    // YUV frames are kept as is, the conversion to RGB being done by the texture shader
+    ImageBufferSpec spec(_width, _height, _channels, _bpp, ImageBufferSpec::Type::UINT8);
+    if (repackPlanar)
+    {
+        spec.format = "UYVY";
+        spec.bpp = 16;
+    }
+    else if (!_yuvFormat.empty())
+    {
+        spec.format = _yuvFormat;
+    }
+    else
     {
-        ImageBufferSpec spec(_width, _height, _channels, 8 * _channels, ImageBufferSpec::Type::UINT8);
+        spec.bpp = 8 * _channels;
         if (_green < _blue)
             spec.format = "BGR";
         else
             spec.format = "RGB";
         if (_channels == 4)
             spec.format.push_back('A');
+    }
 
-        if (_is420 || _is422)
-        {
-            spec.format = "UYVY";
-            spec.bpp = 16;
-        }
-
+    // Check if we need to resize the reader buffer
+    if (_readerBuffer.getSpec() != spec)
         _readerBuffer = ImageBuffer(spec);
-    }
 
-    if (!_isYUV && (_channels == 3 || _channels == 4))
+    const auto chromaSize = static_cast<size_t>((_width + 1) / 2) * static_cast<size_t>((_height + 1) / 2);
+    const auto frameSize = repackPlanar ? static_cast<size_t>(_width) * _height + 2 * chromaSize : static_cast<size_t>(spec.rawSize());
+    if (data_size < 0 || static_cast<size_t>(data_size) < frameSize)
     {
-        char* pixels = (char*)(_readerBuffer).data();
-        std::vector<std::future<void>> threads;
-        for (uint32_t block = 0; block < _shmdataCopyThreads; ++block)
-        {
-            int size = _width * _height * _channels * sizeof(char);
-            threads.push_back(std::async(std::launch::async, [=]() {
-                int sizeOfBlock; // We compute the size of the block, to handle image size non divisible by _shmdataCopyThreads
-                if (size - size / _shmdataCopyThreads * block < 2 * size / _shmdataCopyThreads)
-                    sizeOfBlock = size - size / _shmdataCopyThreads * block;
-                else
-                    sizeOfBlock = size / _shmdataCopyThreads;
-
-                memcpy(pixels + size / _shmdataCopyThreads * block, (const char*)data + size / _shmdataCopyThreads * block, sizeOfBlock);
-            }));
-        }
+        Log::get() << Log::WARNING << "Image_Shmdata::" << __FUNCTION__ << " - Received frame is smaller than expected from the caps" << Log::endl;
+        return;
     }
-    else if (_is420)
-    {
-        const unsigned char* Y = static_cast<const unsigned char*>(data);
-        const unsigned char* U = static_cast<const unsigned char*>(data) + _width * _height;
-        const unsigned char* V = static_cast<const unsigned char*>(data) + _width * _height * 5 / 4;
-        char* pixels = (char*)(_readerBuffer).data();
 
-        for (uint32_t y = 0; y < _height; ++y)
-        {
-            for (uint32_t x = 0; x < _width; x += 2)
-            {
-                pixels[(x + y * _width) * 2 + 0] = U[(x / 2) + (y / 2) * (_width / 2)];
-                pixels[(x + y * _width) * 2 + 1] = Y[x + y * _width];
-                pixels[(x + y * _width) * 2 + 2] = V[(x / 2) + (y / 2) * (_width / 2)];
-                pixels[(x + y * _width) * 2 + 3] = Y[x + y * _width + 1];
-            }
-        }
-    }
-    else if (_is422)
-    {
-        const unsigned char* YUV = static_cast<const unsigned char*>(data);
-        char* pixels = (char*)(_readerBuffer).data();
-        std::copy(YUV, YUV + _width * _height * 2, pixels);
-    }
+    if (repackPlanar)
+        repackPlanarToUYVY(reinterpret_cast<uint8_t*>(_readerBuffer.data()), static_cast<const uint8_t*>(data));
     else
-        return;
+        copyFrame(reinterpret_cast<uint8_t*>(_readerBuffer.data()), static_cast<const uint8_t*>(data), frameSize);
 
     {
         std::lock_guard<Spinlock> updateLock(_updateMutex);
@@ -336,6 +326,56 @@ void Image_Shmdata::readUncompressedFrame(void* data, int /*data_size*/)
     updateTimestamp();
 }
 
+/*************/
+void Image_Shmdata::copyFrame(uint8_t* destination, const uint8_t* source, size_t size)
+{
+    if (size < _minParallelCopySize)
+    {
+        memcpy(destination, source, size);
+        return;
+    }
+
+    // The source is only valid during the shmdata callback, which parallelFor does not return from before all blocks are copied
+    ThreadPool::get().parallelFor(_shmdataCopyThreads, [&](size_t block) {
+        // The last block takes the remainder of the division
+        const auto blockSize = size / _shmdataCopyThreads;
+        const auto offset = blockSize * block;
+        const auto length = block == _shmdataCopyThreads - 1 ? size - offset : blockSize;
+        memcpy(destination + offset, source + offset, length);
+    });
+}
+
+/*************/
+void Image_Shmdata::repackPlanarToUYVY(uint8_t* destination, const uint8_t* source)
+{
+    const auto chromaWidth = (_width + 1) / 2;
+    const auto chromaHeight = (_height + 1) / 2;
+    const bool isNV12 = _yuvFormat == "NV12";
+
+    const uint8_t* Y = source;
+    const uint8_t* U = source + _width * _height;
+    const uint8_t* V = isNV12 ? U + 1 : U + chromaWidth * chromaHeight;
+    const uint32_t chromaStep = isNV12 ? 2 : 1;
+
+    for (uint32_t y = 0; y < _height; ++y)
+    {
+        const auto chromaRow = (y / 2) * chromaWidth * chromaStep;
+        auto pixels = destination + y * _width * 2;
+        for (uint32_t x = 0; x < _width; x += 2)
+        {
+            const auto chromaIndex = chromaRow + (x / 2) * chromaStep;
+            pixels[x * 2 + 0] = U[chromaIndex];
+            pixels[x * 2 + 1] = Y[x + y * _width];
+            // With an odd width the last pixel has no pair, and only its U and Y values fit in the row
+            if (x + 1 < _width)
+            {
+                pixels[x * 2 + 2] = V[chromaIndex];
+                pixels[x * 2 + 3] = Y[x + y * _width + 1];
+            }
+        }
+    }
+}
+
 /*************/
 void Image_Shmdata::registerAttributes()
 {
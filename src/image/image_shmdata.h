@@ -64,6 +64,7 @@ class Image_Shmdata final : public Image
 
   private:
     static const uint32_t _shmdataCopyThreads = 2;
+    static const size_t _minParallelCopySize = 1 << 20; //!< Smaller frames are copied by the shmdata thread alone
     Utils::ShmdataLogger _logger;
     std::unique_ptr<shmdata::Follower> _reader{nullptr};
 
@@ -77,9 +78,7 @@ class Image_Shmdata final : public Image
     uint32_t _blue{0};
     uint32_t _channels{0};
     bool _isHap{false};
-    bool _isYUV{false};
-    bool _is420{false};
-    bool _is422{false};
+    std::string _yuvFormat{""}; //!< Format of YUV frames, which are kept as is and converted by the texture shader
 
     // Hap specific attributes
     std::string _textureFormat{""};
@@ -118,6 +117,21 @@ class Image_Shmdata final : public Image
      */
     void readUncompressedFrame(void* data, int data_size);
 
+    /**
+     * Copy a frame, split in blocks copied in parallel by the thread pool
+     * \param destination Destination buffer
+     * \param source Source buffer
+     * \param size Frame size in bytes
+     */
+    void copyFrame(uint8_t* destination, const uint8_t* source, size_t size);
+
+    /**
+     * Repack a planar YUV420P or NV12 frame as UYVY, for sizes which cannot be uploaded as planar
+     * \param destination Destination buffer, of the size of the UYVY frame
+     * \param source Planar frame
+     */
+    void repackPlanarToUYVY(uint8_t* destination, const uint8_t* source);
+
     /**
      * Register new functors to modify attributes
      */
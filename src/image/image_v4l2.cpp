@@ -830,6 +830,7 @@ void Image_V4L2::registerAttributes()
 
     addAttribute(
         "sourceFormat", [&](const Values&) { return true; }, [&]() -> Values { return {_sourceFormatAsString}; }, {});
+    setAttributeVolatile("sourceFormat", true);
 
     addAttribute(
         "pixelFormat",
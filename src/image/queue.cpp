@@ -364,6 +364,7 @@ void Queue::registerAttributes()
     addAttribute(
         "elapsed", [&](const Values& /*args*/) { return true; }, [&]() -> Values { return {static_cast<float>(_currentTime / 1e6)}; }, {'r'});
     setAttributeDescription("elapsed", "Time elapsed since the beginning of the queue");
+    setAttributeVolatile("elapsed", true);
 
     addAttribute("seek",
         [&](const Values& args) {
@@ -416,7 +417,7 @@ void QueueSurrogate::unbind()
 }
 
 /*************/
-std::unordered_map<std::string, Values> QueueSurrogate::getShaderUniforms() const
+Texture::ShaderUniforms QueueSurrogate::getShaderUniforms() const
 {
     return _filter->getShaderUniforms();
 }
@@ -179,7 +179,7 @@ class QueueSurrogate final : public Texture
      * Get the shader parameters related to this texture. Texture should be locked first.
      * \return Return the shader uniforms
      */
-    std::unordered_map<std::string, Values> getShaderUniforms() const;
+    ShaderUniforms getShaderUniforms() const;
 
     /**
      * Get the filter created by the queue
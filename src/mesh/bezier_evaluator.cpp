@@ -0,0 +1,143 @@
+#include "./mesh/bezier_evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Splash
+{
+
+namespace
+{
+/*************/
+// Add weight * source to destination. The fixed size inner loop is vectorized by the compiler
+inline void accumulate(float* __restrict destination, const float* __restrict source, float weight, int length)
+{
+    for (int block = 0; block < length; block += BezierEvaluator::BLOCK_SIZE)
+        for (int k = 0; k < BezierEvaluator::BLOCK_SIZE; ++k)
+            destination[block + k] += weight * source[block + k];
+}
+} // namespace
+
+/*************/
+bool BezierEvaluator::evaluate(const glm::ivec2& size, const std::vector<glm::vec2>& controlPoints, int resolution)
+{
+    resolution = std::max(resolution, 2);
+    if (size.x < 1 || size.y < 1 || static_cast<int>(controlPoints.size()) != size.x * size.y)
+        return false;
+
+    if (size == _size && resolution == _resolution && _incrementalUpdates < MAX_INCREMENTAL_UPDATES)
+    {
+        std::vector<int> movedPoints;
+        for (int i = 0; i < static_cast<int>(controlPoints.size()); ++i)
+            if (controlPoints[i] != _controlPoints[i])
+                movedPoints.push_back(i);
+
+        // A moved point costs as much as a full evaluation of a control point row
+        if (static_cast<int>(movedPoints.size()) < size.y)
+        {
+            for (const auto index : movedPoints)
+                moveControlPoint(index, controlPoints[index] - _controlPoints[index]);
+            _controlPoints = controlPoints;
+            ++_incrementalUpdates;
+            return true;
+        }
+    }
+
+    if (size != _size || resolution != _resolution)
+    {
+        _size = size;
+        _resolution = resolution;
+        _stride = (resolution + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+
+        computeBasis(size.x, resolution, _stride, _basisU);
+        computeBasis(size.y, resolution, resolution, _basisV);
+        _rowsX.resize(static_cast<size_t>(size.y * _stride));
+        _rowsY.resize(_rowsX.size());
+        _x.resize(static_cast<size_t>(resolution * _stride));
+        _y.resize(_x.size());
+    }
+
+    _controlPoints = controlPoints;
+    evaluateFull();
+    _incrementalUpdates = 0;
+    return false;
+}
+
+/*************/
+void BezierEvaluator::getVertices(std::vector<glm::vec4>& vertices) const
+{
+    vertices.resize(static_cast<size_t>(_resolution * _resolution));
+    auto vertex = vertices.begin();
+    for (int v = 0; v < _resolution; ++v)
+    {
+        const auto rowX = &_x[v * _stride];
+        const auto rowY = &_y[v * _stride];
+        for (int u = 0; u < _resolution; ++u)
+            *vertex++ = glm::vec4(rowX[u], rowY[u], 0.f, 1.f);
+    }
+}
+
+/*************/
+void BezierEvaluator::computeBasis(int controlCount, int resolution, int stride, std::vector<float>& basis)
+{
+    basis.assign(static_cast<size_t>(controlCount * stride), 0.f);
+
+    const int degree = controlCount - 1;
+    double binomialCoeff = 1.0;
+    for (int i = 0; i < controlCount; ++i)
+    {
+        if (i > 0)
+            binomialCoeff = binomialCoeff * static_cast<double>(degree - i + 1) / static_cast<double>(i);
+
+        for (int s = 0; s < resolution; ++s)
+        {
+            const auto t = static_cast<double>(s) / static_cast<double>(resolution - 1);
+            basis[s + i * stride] = static_cast<float>(binomialCoeff * std::pow(t, i) * std::pow(1.0 - t, degree - i));
+        }
+    }
+}
+
+/*************/
+void BezierEvaluator::evaluateFull()
+{
+    // Evaluate each row of control points along the horizontal axis
+    std::fill(_rowsX.begin(), _rowsX.end(), 0.f);
+    std::fill(_rowsY.begin(), _rowsY.end(), 0.f);
+    for (int j = 0; j < _size.y; ++j)
+    {
+        for (int i = 0; i < _size.x; ++i)
+        {
+            const auto& point = _controlPoints[i + j * _size.x];
+            const auto basis = &_basisU[i * _stride];
+            accumulate(&_rowsX[j * _stride], basis, point.x, _stride);
+            accumulate(&_rowsY[j * _stride], basis, point.y, _stride);
+        }
+    }
+
+    // Then combine these rows along the vertical axis
+    std::fill(_x.begin(), _x.end(), 0.f);
+    std::fill(_y.begin(), _y.end(), 0.f);
+    for (int v = 0; v < _resolution; ++v)
+    {
+        for (int j = 0; j < _size.y; ++j)
+        {
+            const auto weight = _basisV[v + j * _resolution];
+            accumulate(&_x[v * _stride], &_rowsX[j * _stride], weight, _stride);
+            accumulate(&_y[v * _stride], &_rowsY[j * _stride], weight, _stride);
+        }
+    }
+}
+
+/*************/
+void BezierEvaluator::moveControlPoint(int index, const glm::vec2& displacement)
+{
+    const auto basisU = &_basisU[(index % _size.x) * _stride];
+    const auto basisV = &_basisV[(index / _size.x) * _resolution];
+    for (int v = 0; v < _resolution; ++v)
+    {
+        accumulate(&_x[v * _stride], basisU, basisV[v] * displacement.x, _stride);
+        accumulate(&_y[v * _stride], basisU, basisV[v] * displacement.y, _stride);
+    }
+}
+
+} // namespace Splash
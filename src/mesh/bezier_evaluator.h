@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @bezier_evaluator.h
+ * The BezierEvaluator class, which evaluates a 2D Bezier patch over a regular grid
+ */
+
+#ifndef SPLASH_BEZIER_EVALUATOR_H
+#define SPLASH_BEZIER_EVALUATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Evaluates a tensor-product Bezier patch over a grid of resolution x resolution points.
+ *
+ * The Bernstein basis is tabulated once per patch size and resolution, and the evaluation is
+ * separated in two passes (along the rows of control points, then along the columns) working
+ * on contiguous blocks of floats which the compiler turns into SIMD instructions.
+ *
+ * As every control point of a Bezier patch influences the whole patch, moving a few control points
+ * is handled by adding their displacement weighted by their basis function to the previous result,
+ * which is much cheaper than a full evaluation.
+ */
+class BezierEvaluator
+{
+  public:
+    static constexpr int BLOCK_SIZE = 8;                    //!< Floats processed together, a row of the grid being padded to a multiple of it
+    static constexpr uint32_t MAX_INCREMENTAL_UPDATES = 64; //!< Incremental updates before a full evaluation, to limit the accumulated rounding errors
+
+    /**
+     * Evaluate the patch, incrementally if only a few control points moved since the previous evaluation
+     * \param size Control point count along each axis
+     * \param controlPoints Control points, row by row
+     * \param resolution Evaluated point count along each axis
+     * \return Return true if the evaluation was incremental
+     */
+    bool evaluate(const glm::ivec2& size, const std::vector<glm::vec2>& controlPoints, int resolution);
+
+    /**
+     * Get the resolution of the last evaluation
+     * \return Return the resolution
+     */
+    int getResolution() const { return _resolution; }
+
+    /**
+     * Get an evaluated point
+     * \param u Horizontal index
+     * \param v Vertical index
+     * \return Return the point position
+     */
+    glm::vec2 getVertex(int u, int v) const { return {_x[u + v * _stride], _y[u + v * _stride]}; }
+
+    /**
+     * Copy the evaluated points, row by row, in the XY plane
+     * \param vertices Vector to copy the points to, resized to resolution * resolution
+     */
+    void getVertices(std::vector<glm::vec4>& vertices) const;
+
+  private:
+    glm::ivec2 _size{0, 0};
+    int _resolution{0};
+    int _stride{0};
+    std::vector<glm::vec2> _controlPoints{};
+    uint32_t _incrementalUpdates{0};
+
+    std::vector<float> _basisU{}; //!< Horizontal basis functions, one padded row per control point column
+    std::vector<float> _basisV{}; //!< Vertical basis functions, one row per control point row
+    std::vector<float> _rowsX{};  //!< Control point rows evaluated horizontally
+    std::vector<float> _rowsY{};
+    std::vector<float> _x{}; //!< Evaluated points, one padded row per grid row
+    std::vector<float> _y{};
+
+    /**
+     * Tabulate the Bernstein polynomials of the given degree
+     * \param controlCount Control point count, the degree being one less
+     * \param resolution Sample count
+     * \param stride Distance between two basis functions in the table
+     * \param basis Table to fill
+     */
+    static void computeBasis(int controlCount, int resolution, int stride, std::vector<float>& basis);
+
+    /**
+     * Evaluate the whole patch from the current control points
+     */
+    void evaluateFull();
+
+    /**
+     * Move a control point, updating the evaluated points
+     * \param index Control point index
+     * \param displacement Control point displacement
+     */
+    void moveControlPoint(int index, const glm::vec2& displacement);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_BEZIER_EVALUATOR_H
@@ -110,6 +110,13 @@ std::vector<float> Mesh::getAnnexeFlat() const
     return annexe;
 }
 
+/*************/
+std::vector<uint32_t> Mesh::getIndices() const
+{
+    std::shared_lock<std::shared_mutex> readLock(_readMutex);
+    return _mesh.indices;
+}
+
 /*************/
 bool Mesh::read(const std::string& filename)
 {
@@ -126,6 +133,7 @@ bool Mesh::read(const std::string& filename)
         mesh.vertices = objLoader.getVertices();
         mesh.uvs = objLoader.getUVs();
         mesh.normals = objLoader.getNormals();
+        mesh.indices = objLoader.getIndices();
 
         std::lock_guard<std::shared_mutex> readLock(_readMutex);
         _mesh = mesh;
@@ -141,12 +149,18 @@ SerializedObject Mesh::serialize() const
     if (Timer::get().isDebug())
         Timer::get() << "serialize " + _name;
 
+    // The fields are written in place in the order of a serialized MeshContainer,
+    // which saves copying the mesh to set its name
     std::shared_lock<std::shared_mutex> readLock(_readMutex);
-    auto mesh = _mesh;
-    mesh.name = _name;
-    std::vector<uint8_t> data;
-    Serial::serialize(mesh, data);
-    SerializedObject obj(ResizableArray(std::move(data)));
+    SerializedObject obj(Serial::getSize(_name) + Serial::getSize(_mesh.vertices) + Serial::getSize(_mesh.uvs) + Serial::getSize(_mesh.normals) +
+                         Serial::getSize(_mesh.annexe) + Serial::getSize(_mesh.indices));
+    Span<uint8_t> output(obj);
+    Serial::serializeTo(_name, output);
+    Serial::serializeTo(_mesh.vertices, output);
+    Serial::serializeTo(_mesh.uvs, output);
+    Serial::serializeTo(_mesh.normals, output);
+    Serial::serializeTo(_mesh.annexe, output);
+    Serial::serializeTo(_mesh.indices, output);
 
     if (Timer::get().isDebug())
         Timer::get() >> ("serialize " + _name);
@@ -204,9 +218,7 @@ void Mesh::createDefaultMesh(int subdiv)
 
     MeshContainer mesh;
 
-    std::vector<glm::vec2> positions;
-    std::vector<glm::vec2> uvs;
-
+    // The grid vertices are shared between the neighbouring triangles
     for (int v = 0; v < subdiv + 2; ++v)
     {
         glm::vec2 position;
@@ -220,8 +232,9 @@ void Mesh::createDefaultMesh(int subdiv)
             uv.x = static_cast<float>(u) / static_cast<float>(subdiv + 1);
             position.x = uv.x * 2.f - 1.f;
 
-            positions.push_back(position);
-            uvs.push_back(uv);
+            mesh.vertices.push_back(glm::vec4(position, 0.0, 1.0));
+            mesh.uvs.push_back(uv);
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
         }
     }
 
@@ -229,24 +242,16 @@ void Mesh::createDefaultMesh(int subdiv)
     {
         for (int u = 0; u < subdiv + 1; ++u)
         {
-            mesh.vertices.push_back(glm::vec4(positions[u + v * (subdiv + 2)], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(positions[u + 1 + v * (subdiv + 2)], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(positions[u + (v + 1) * (subdiv + 2)], 0.0, 1.0));
-
-            mesh.vertices.push_back(glm::vec4(positions[u + 1 + v * (subdiv + 2)], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(positions[u + 1 + (v + 1) * (subdiv + 2)], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(positions[u + (v + 1) * (subdiv + 2)], 0.0, 1.0));
-
-            mesh.uvs.push_back(uvs[u + v * (subdiv + 2)]);
-            mesh.uvs.push_back(uvs[u + 1 + v * (subdiv + 2)]);
-            mesh.uvs.push_back(uvs[u + (v + 1) * (subdiv + 2)]);
+            const auto index = static_cast<uint32_t>(u + v * (subdiv + 2));
+            const auto nextRowIndex = index + static_cast<uint32_t>(subdiv + 2);
 
-            mesh.uvs.push_back(uvs[u + 1 + v * (subdiv + 2)]);
-            mesh.uvs.push_back(uvs[u + 1 + (v + 1) * (subdiv + 2)]);
-            mesh.uvs.push_back(uvs[u + (v + 1) * (subdiv + 2)]);
+            mesh.indices.push_back(index);
+            mesh.indices.push_back(index + 1);
+            mesh.indices.push_back(nextRowIndex);
 
-            for (size_t i = 0; i < 6; ++i)
-                mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.indices.push_back(index + 1);
+            mesh.indices.push_back(nextRowIndex + 1);
+            mesh.indices.push_back(nextRowIndex);
         }
     }
 
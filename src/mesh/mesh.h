@@ -49,6 +49,7 @@ class Mesh : public BufferObject
         std::vector<glm::vec2> uvs;
         std::vector<glm::vec4> normals;
         std::vector<glm::vec4> annexe;
+        std::vector<uint32_t> indices; //!< Triangle indices into the vertex attributes, empty if the mesh is a triangle soup
     };
 
   public:
@@ -128,6 +129,12 @@ class Mesh : public BufferObject
      */
     virtual std::vector<float> getAnnexeFlat() const;
 
+    /**
+     * Get the indices of the vertices of each triangle
+     * \return Return a vector of indices, three per triangle, or an empty vector if the mesh is a triangle soup
+     */
+    virtual std::vector<uint32_t> getIndices() const;
+
     /**
      * Read / update the mesh
      * \param filename File to load from
@@ -116,28 +116,30 @@ void Mesh_BezierPatch::createPatch(Patch& patch)
     _patchUpdated = true;
 
     MeshContainer mesh;
-    for (int v = 0; v < height - 1; ++v)
+    for (int v = 0; v < height; ++v)
     {
-        for (int u = 0; u < width - 1; ++u)
+        for (int u = 0; u < width; ++u)
         {
             mesh.vertices.push_back(glm::vec4(patch.vertices[u + v * width], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(patch.vertices[u + 1 + v * width], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(patch.vertices[u + (v + 1) * width], 0.0, 1.0));
-
-            mesh.vertices.push_back(glm::vec4(patch.vertices[u + 1 + (v + 1) * width], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(patch.vertices[u + (v + 1) * width], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(patch.vertices[u + 1 + v * width], 0.0, 1.0));
-
             mesh.uvs.push_back(patch.uvs[u + v * width]);
-            mesh.uvs.push_back(patch.uvs[u + 1 + v * width]);
-            mesh.uvs.push_back(patch.uvs[u + (v + 1) * width]);
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+        }
+    }
 
-            mesh.uvs.push_back(patch.uvs[u + 1 + (v + 1) * width]);
-            mesh.uvs.push_back(patch.uvs[u + (v + 1) * width]);
-            mesh.uvs.push_back(patch.uvs[u + 1 + v * width]);
+    for (int v = 0; v < height - 1; ++v)
+    {
+        for (int u = 0; u < width - 1; ++u)
+        {
+            const auto index = static_cast<uint32_t>(u + v * width);
+            const auto nextRowIndex = index + static_cast<uint32_t>(width);
+
+            mesh.indices.push_back(index);
+            mesh.indices.push_back(index + 1);
+            mesh.indices.push_back(nextRowIndex);
 
-            for (size_t i = 0; i < 6; ++i)
-                mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.indices.push_back(nextRowIndex + 1);
+            mesh.indices.push_back(nextRowIndex);
+            mesh.indices.push_back(index + 1);
         }
     }
     _bezierControl = mesh;
@@ -150,82 +152,46 @@ void Mesh_BezierPatch::updatePatch()
 {
     std::lock_guard<std::mutex> lock(_patchMutex);
 
-    std::vector<glm::vec2> vertices;
-    std::vector<glm::vec2> uvs;
-
-    // Update the binomial coefficients if needed
-    if (_patch.size != _binomialDimensions)
-    {
-        _binomialCoeffsX.clear();
-        _binomialCoeffsY.clear();
-
-        for (int i = 0; i < _patch.size.x; ++i)
-            _binomialCoeffsX.push_back(static_cast<float>(binomialCoeff(_patch.size.x - 1, i)));
-
-        for (int i = 0; i < _patch.size.y; ++i)
-            _binomialCoeffsY.push_back(static_cast<float>(binomialCoeff(_patch.size.y - 1, i)));
-
-        _binomialDimensions = _patch.size;
-    }
+    _evaluator.evaluate(_patch.size, _patch.vertices, _patchResolution);
+    const auto resolution = _evaluator.getResolution();
+    if (resolution == 0)
+        return;
 
-    // Compute the vertices positions
-    for (int v = 0; v < _patchResolution; ++v)
+    // The uvs, normals and triangles only depend on the resolution, vertices being shared between the neighbouring triangles
+    const auto vertexCount = static_cast<size_t>(resolution * resolution);
+    if (_bezierMesh.uvs.size() != vertexCount)
     {
-        glm::vec2 uv;
+        MeshContainer mesh;
+        mesh.uvs.reserve(vertexCount);
+        mesh.normals.assign(vertexCount, glm::vec4(0.0, 0.0, 1.0, 0.0));
+        mesh.indices.reserve(static_cast<size_t>((resolution - 1) * (resolution - 1) * 6));
 
-        uv.y = static_cast<float>(v) / static_cast<float>(_patchResolution - 1);
+        for (int v = 0; v < resolution; ++v)
+            for (int u = 0; u < resolution; ++u)
+                mesh.uvs.emplace_back(static_cast<float>(u) / static_cast<float>(resolution - 1), static_cast<float>(v) / static_cast<float>(resolution - 1));
 
-        for (int u = 0; u < _patchResolution; ++u)
+        for (int v = 0; v < resolution - 1; ++v)
         {
-            uv.x = static_cast<float>(u) / static_cast<float>(_patchResolution - 1);
-
-            glm::vec2 vertex{0.f, 0.f};
-            for (float j = 0; j < _patch.size.y; ++j)
+            for (int u = 0; u < resolution - 1; ++u)
             {
-                for (float i = 0; i < _patch.size.x; ++i)
-                {
-                    const auto iAsFloat = static_cast<float>(i);
-                    const auto jAsFloat = static_cast<float>(j);
-                    float factor = _binomialCoeffsY[j] * pow(uv.y, jAsFloat) * pow(1.f - uv.y, static_cast<float>(_patch.size.y) - 1.f - jAsFloat) * _binomialCoeffsX[i] * pow(uv.x, iAsFloat) *
-                                   pow(1.f - uv.x, static_cast<float>(_patch.size.x) - 1.f - iAsFloat);
-                    vertex += factor * _patch.vertices[i + j * _patch.size.x];
-                }
-            }
+                const auto index = static_cast<uint32_t>(u + v * resolution);
+                const auto nextRowIndex = index + static_cast<uint32_t>(resolution);
 
-            vertices.push_back(vertex);
-            uvs.push_back(uv);
-        }
-    }
+                mesh.indices.push_back(index);
+                mesh.indices.push_back(index + 1);
+                mesh.indices.push_back(nextRowIndex);
 
-    // Create the mesh
-    MeshContainer mesh;
-    for (int v = 0; v < _patchResolution - 1; ++v)
-    {
-        for (int u = 0; u < _patchResolution - 1; ++u)
-        {
-            mesh.vertices.push_back(glm::vec4(vertices[u + v * _patchResolution], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(vertices[u + 1 + v * _patchResolution], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(vertices[u + (v + 1) * _patchResolution], 0.0, 1.0));
-
-            mesh.vertices.push_back(glm::vec4(vertices[u + 1 + v * _patchResolution], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(vertices[u + 1 + (v + 1) * _patchResolution], 0.0, 1.0));
-            mesh.vertices.push_back(glm::vec4(vertices[u + (v + 1) * _patchResolution], 0.0, 1.0));
-
-            mesh.uvs.push_back(uvs[u + v * _patchResolution]);
-            mesh.uvs.push_back(uvs[u + 1 + v * _patchResolution]);
-            mesh.uvs.push_back(uvs[u + (v + 1) * _patchResolution]);
-
-            mesh.uvs.push_back(uvs[u + 1 + v * _patchResolution]);
-            mesh.uvs.push_back(uvs[u + 1 + (v + 1) * _patchResolution]);
-            mesh.uvs.push_back(uvs[u + (v + 1) * _patchResolution]);
-
-            for (size_t i = 0; i < 6; ++i)
-                mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+                mesh.indices.push_back(index + 1);
+                mesh.indices.push_back(nextRowIndex + 1);
+                mesh.indices.push_back(nextRowIndex);
+            }
         }
+
+        _bezierMesh = std::move(mesh);
     }
 
-    _bufferMesh = mesh;
-    _bezierMesh = mesh;
+    _evaluator.getVertices(_bezierMesh.vertices);
+    _bufferMesh = _bezierMesh;
 
     updateTimestamp();
     _meshUpdated = true;
@@ -34,6 +34,7 @@
 #include "./core/constants.h"
 
 #include "./core/attribute.h"
+#include "./mesh/bezier_evaluator.h"
 #include "./mesh/mesh.h"
 
 namespace Splash
@@ -94,29 +95,7 @@ class Mesh_BezierPatch final : public Mesh
     MeshContainer _bezierControl;
     MeshContainer _bezierMesh;
 
-    std::vector<float> _binomialCoeffsX{};
-    std::vector<float> _binomialCoeffsY{};
-    glm::ivec2 _binomialDimensions{0, 0};
-
-    // Factorial
-    inline int32_t factorial(int32_t i) { return (i == 0 || i == 1) ? 1 : factorial(i - 1) * i; }
-
-    // "Semi" factorial
-    inline int32_t factorial(int32_t n, int32_t k)
-    {
-        int32_t res = 1;
-        for (int32_t i = n - k + 1; i <= n; ++i)
-            res *= i;
-        return res;
-    }
-
-    // Binomial coefficient
-    inline int32_t binomialCoeff(int32_t n, int32_t i)
-    {
-        if (n < i)
-            return 0;
-        return factorial(n, i) / factorial(i);
-    }
+    BezierEvaluator _evaluator{};
 
     /**
      * Initialization
@@ -68,23 +68,23 @@ void Mesh_Shmdata::onData(void* data, int /*data_size*/)
     const int verticeNbr = *(intPtr++);
     const int polyNbr = *(intPtr++);
 
-    std::vector<glm::vec4> vertices(verticeNbr);
-    std::vector<glm::vec2> uvs(verticeNbr);
-    std::vector<glm::vec4> normals(verticeNbr);
+    MeshContainer newMesh;
+    newMesh.vertices.resize(verticeNbr);
+    newMesh.uvs.resize(verticeNbr);
+    newMesh.normals.resize(verticeNbr);
 
     floatPtr += 2;
     // First, create the vertices with no UV, normals or faces
     for (int v = 0; v < verticeNbr; ++v)
     {
-        vertices[v] = glm::vec4(floatPtr[0], floatPtr[1], floatPtr[2], 1.f);
-        uvs[v] = glm::vec2(floatPtr[3], floatPtr[4]);
-        normals[v] = glm::vec4(floatPtr[5], floatPtr[6], floatPtr[7], 0.f);
+        newMesh.vertices[v] = glm::vec4(floatPtr[0], floatPtr[1], floatPtr[2], 1.f);
+        newMesh.uvs[v] = glm::vec2(floatPtr[3], floatPtr[4]);
+        newMesh.normals[v] = glm::vec4(floatPtr[5], floatPtr[6], floatPtr[7], 0.f);
         floatPtr += 8;
     }
 
     intPtr += 8 * verticeNbr;
-    // Then create the faces
-    MeshContainer newMesh;
+    // Then create the faces, which index the shared vertices
     for (int p = 0; p < polyNbr; ++p)
     {
         int size = *(intPtr++);
@@ -93,20 +93,12 @@ void Mesh_Shmdata::onData(void* data, int /*data_size*/)
         if (size >= 3)
         {
             for (int vert = 0; vert < 3; ++vert)
-            {
-                newMesh.vertices.push_back(vertices[*(intPtr + vert)]);
-                newMesh.uvs.push_back(uvs[*(intPtr + vert)]);
-                newMesh.normals.push_back(normals[*(intPtr + vert)]);
-            }
+                newMesh.indices.push_back(static_cast<uint32_t>(*(intPtr + vert)));
         }
         if (size == 4)
         {
             for (int vert = 2; vert < 5; ++vert)
-            {
-                newMesh.vertices.push_back(vertices[*(intPtr + (vert % 4))]);
-                newMesh.uvs.push_back(uvs[*(intPtr + (vert % 4))]);
-                newMesh.normals.push_back(normals[*(intPtr + (vert % 4))]);
-            }
+                newMesh.indices.push_back(static_cast<uint32_t>(*(intPtr + (vert % 4))));
         }
 
         intPtr += size;
@@ -0,0 +1,479 @@
+#include "./mesh/meshloader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+#include "./utils/log.h"
+#include "./utils/thread_pool.h"
+
+namespace Splash
+{
+namespace Loader
+{
+
+namespace
+{
+constexpr size_t MIN_CHUNK_SIZE = 1 << 20; // Smaller chunks are not worth a task
+
+constexpr int RELATIVE_INDEX_BASE = std::numeric_limits<int>::min() / 2; // Base for the encoding of relative face indices
+
+constexpr char CACHE_MAGIC[8] = {'S', 'P', 'L', 'M', 'E', 'S', 'H', '\0'};
+constexpr uint32_t CACHE_VERSION = 1;
+
+// The cache holds this header, followed by the vertices, UVs, normals and indices arrays
+struct CacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t padding;
+    uint64_t sourceSize;
+    int64_t sourceModificationTime;
+    uint64_t verticesCount;
+    uint64_t indicesCount;
+};
+
+/*************/
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::string& filename)
+    {
+        _fd = open(filename.c_str(), O_RDONLY);
+        if (_fd < 0)
+            return;
+
+        struct stat fileStat;
+        if (fstat(_fd, &fileStat) != 0 || fileStat.st_size == 0)
+            return;
+
+        _size = static_cast<size_t>(fileStat.st_size);
+#if HAVE_LINUX
+        _modificationTime = static_cast<int64_t>(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec;
+#else
+        _modificationTime = static_cast<int64_t>(fileStat.st_mtimespec.tv_sec) * 1000000000 + fileStat.st_mtimespec.tv_nsec;
+#endif
+
+        auto mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (mapping == MAP_FAILED)
+            return;
+        _data = static_cast<const char*>(mapping);
+        madvise(mapping, _size, MADV_SEQUENTIAL);
+    }
+
+    ~MappedFile()
+    {
+        if (_data)
+            munmap(const_cast<char*>(_data), _size);
+        if (_fd >= 0)
+            close(_fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    explicit operator bool() const { return _data != nullptr; }
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+    int64_t getModificationTime() const { return _modificationTime; }
+
+  private:
+    int _fd{-1};
+    const char* _data{nullptr};
+    size_t _size{0};
+    int64_t _modificationTime{0};
+};
+
+/*************/
+inline const char* skipSpaces(const char* it, const char* end)
+{
+    while (it < end && (*it == ' ' || *it == '\t' || *it == '\r'))
+        ++it;
+    return it;
+}
+
+/*************/
+// Parse up to maxCount whitespace-separated floats, returning the number of values read
+int parseFloats(const char* it, const char* end, float* values, int maxCount)
+{
+    int count = 0;
+    while (count < maxCount)
+    {
+        it = skipSpaces(it, end);
+        if (it < end && *it == '+')
+            ++it;
+        if (it >= end)
+            break;
+
+#if defined(__cpp_lib_to_chars)
+        const auto result = std::from_chars(it, end, values[count]);
+        if (result.ptr == it)
+            break;
+        // Values too small to be represented are set to zero
+        if (result.ec == std::errc::result_out_of_range)
+            values[count] = 0.f;
+        it = result.ptr;
+#else
+        char buffer[64];
+        const auto length = std::min<size_t>(end - it, sizeof(buffer) - 1);
+        memcpy(buffer, it, length);
+        buffer[length] = '\0';
+        char* parseEnd = nullptr;
+        values[count] = strtof(buffer, &parseEnd);
+        if (parseEnd == buffer)
+            break;
+        it += parseEnd - buffer;
+#endif
+        ++count;
+    }
+    return count;
+}
+
+/*************/
+// Parse a face index, converting it to a zero-based index. Relative (negative) indices are stored as RELATIVE_INDEX_BASE plus
+// their index in the chunk, to be shifted once the number of elements in the previous chunks is known
+inline const char* parseFaceIndex(const char* it, const char* end, size_t chunkCount, int& index)
+{
+    int value = 0;
+    const auto result = std::from_chars(it, end, value);
+    if (result.ptr == it || value == 0)
+        index = -1;
+    else if (value > 0)
+        index = value - 1;
+    else
+        index = RELATIVE_INDEX_BASE + static_cast<int>(chunkCount) + value;
+    return result.ptr;
+}
+} // namespace
+
+/*************/
+bool Obj::load(const std::string& filename)
+{
+    _meshVertices.clear();
+    _meshUVs.clear();
+    _meshNormals.clear();
+    _meshIndices.clear();
+    _loadedFromCache = false;
+
+    MappedFile file(filename);
+    if (!file)
+        return false;
+
+    const auto useCache = _useCache && file.size() >= CACHE_MIN_FILE_SIZE;
+    if (useCache && readCache(filename, file.size(), file.getModificationTime()))
+    {
+        _loadedFromCache = true;
+        return true;
+    }
+
+    // Split the file in chunks of whole lines, parsed in parallel
+    const auto chunkCount = std::clamp<size_t>(file.size() / MIN_CHUNK_SIZE, 1, ThreadPool::get().getWorkerCount());
+    std::vector<const char*> chunkBounds{file.data()};
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        auto bound = std::max(file.data() + file.size() * i / chunkCount, chunkBounds.back());
+        auto lineEnd = static_cast<const char*>(memchr(bound, '\n', file.data() + file.size() - bound));
+        chunkBounds.push_back(lineEnd ? lineEnd + 1 : file.data() + file.size());
+    }
+    chunkBounds.push_back(file.data() + file.size());
+
+    std::vector<ParsedChunk> chunks(chunkCount);
+    ThreadPool::get().parallelFor(chunkCount, [&](size_t i) { chunks[i] = parseChunk(chunkBounds[i], chunkBounds[i + 1]); });
+
+    if (!buildIndexedMesh(chunks))
+    {
+        _meshVertices.clear();
+        _meshUVs.clear();
+        _meshNormals.clear();
+        _meshIndices.clear();
+        return false;
+    }
+
+    if (useCache)
+        writeCache(filename, file.size(), file.getModificationTime());
+
+    return true;
+}
+
+/*************/
+Obj::ParsedChunk Obj::parseChunk(const char* begin, const char* end)
+{
+    ParsedChunk chunk;
+    std::vector<FaceVertex> face;
+
+    for (auto it = begin; it < end;)
+    {
+        auto lineEnd = static_cast<const char*>(memchr(it, '\n', end - it));
+        if (!lineEnd)
+            lineEnd = end;
+
+        auto line = skipSpaces(it, lineEnd);
+        const auto lineLength = lineEnd - line;
+        it = lineEnd + 1;
+
+        if (lineLength < 2)
+            continue;
+
+        if (line[0] == 'v' && (line[1] == ' ' || line[1] == '\t'))
+        {
+            // Vertices are always added, as faces refer to them by their position in the file
+            float values[4]{0.f, 0.f, 0.f, 1.f};
+            parseFloats(line + 2, lineEnd, values, 4);
+            chunk.vertices.emplace_back(values[0], values[1], values[2], values[3]);
+        }
+        else if (lineLength > 2 && line[0] == 'v' && line[1] == 't' && (line[2] == ' ' || line[2] == '\t'))
+        {
+            float values[2]{0.f, 0.f};
+            parseFloats(line + 3, lineEnd, values, 2);
+            chunk.uvs.emplace_back(values[0], values[1]);
+        }
+        else if (lineLength > 2 && line[0] == 'v' && line[1] == 'n' && (line[2] == ' ' || line[2] == '\t'))
+        {
+            float values[3]{0.f, 0.f, 0.f};
+            parseFloats(line + 3, lineEnd, values, 3);
+            chunk.normals.emplace_back(values[0], values[1], values[2], 0.f);
+        }
+        else if (line[0] == 'f' && (line[1] == ' ' || line[1] == '\t'))
+        {
+            // Face vertices are defined as v, v/vt, v//vn or v/vt/vn
+            face.clear();
+            auto token = skipSpaces(line + 2, lineEnd);
+            while (token < lineEnd)
+            {
+                FaceVertex faceVertex;
+                token = parseFaceIndex(token, lineEnd, chunk.vertices.size(), faceVertex.vertexId);
+                if (token < lineEnd && *token == '/')
+                {
+                    ++token;
+                    if (token < lineEnd && *token != '/')
+                        token = parseFaceIndex(token, lineEnd, chunk.uvs.size(), faceVertex.uvId);
+                    if (token < lineEnd && *token == '/')
+                        token = parseFaceIndex(token + 1, lineEnd, chunk.normals.size(), faceVertex.normalId);
+                }
+
+                if (faceVertex.vertexId == -1)
+                    break;
+                face.push_back(faceVertex);
+
+                // Skip anything left from the current face vertex, as a trailing slash
+                while (token < lineEnd && *token != ' ' && *token != '\t')
+                    ++token;
+                token = skipSpaces(token, lineEnd);
+            }
+
+            // Faces are triangulated right away, as a fan around their first vertex
+            if (face.size() < 3)
+                continue;
+            chunk.triangles.insert(chunk.triangles.end(), face.begin(), face.begin() + 3);
+            for (size_t i = 3; i < face.size(); ++i)
+            {
+                chunk.triangles.push_back(face[i - 1]);
+                chunk.triangles.push_back(face[i]);
+                chunk.triangles.push_back(face[0]);
+            }
+        }
+    }
+
+    return chunk;
+}
+
+/*************/
+bool Obj::buildIndexedMesh(const std::vector<ParsedChunk>& chunks)
+{
+    std::vector<glm::vec4> vertices;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec4> normals;
+    size_t triangleVerticesCount = 0;
+    for (const auto& chunk : chunks)
+    {
+        vertices.insert(vertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+        uvs.insert(uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        triangleVerticesCount += chunk.triangles.size();
+    }
+
+    // Check that we have faces and vertices
+    if (vertices.empty() || triangleVerticesCount == 0)
+        return false;
+
+    // A vertex of the output mesh is identified by its attributes. When the normals are computed
+    // from the faces, the normal is part of the key as faces only share vertices with the same normal
+    struct VertexKey
+    {
+        int vertexId;
+        int uvId;
+        int normalId;
+        glm::vec4 normal;
+
+        bool operator==(const VertexKey& other) const
+        {
+            return vertexId == other.vertexId && uvId == other.uvId && normalId == other.normalId && memcmp(&normal, &other.normal, sizeof(normal)) == 0;
+        }
+    };
+
+    struct VertexKeyHash
+    {
+        size_t operator()(const VertexKey& key) const
+        {
+            uint32_t normalBits[4];
+            memcpy(normalBits, &key.normal, sizeof(normalBits));
+            size_t hash = std::hash<int>()(key.vertexId);
+            for (const auto value : {static_cast<uint32_t>(key.uvId), static_cast<uint32_t>(key.normalId), normalBits[0], normalBits[1], normalBits[2]})
+                hash ^= std::hash<uint32_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertexIndices;
+    vertexIndices.reserve(triangleVerticesCount);
+    _meshIndices.reserve(triangleVerticesCount);
+
+    // Resolve an index relative to its chunk, and check that it is valid
+    const auto resolveIndex = [](int& index, int chunkOffset, size_t count, bool isOptional) {
+        if (index < -1)
+            index = chunkOffset + (index - RELATIVE_INDEX_BASE);
+        if (index == -1)
+            return isOptional;
+        return index >= 0 && static_cast<size_t>(index) < count;
+    };
+
+    int verticesOffset = 0;
+    int uvsOffset = 0;
+    int normalsOffset = 0;
+    for (const auto& chunk : chunks)
+    {
+        for (size_t triangle = 0; triangle < chunk.triangles.size(); triangle += 3)
+        {
+            FaceVertex face[3]{chunk.triangles[triangle], chunk.triangles[triangle + 1], chunk.triangles[triangle + 2]};
+            for (auto& faceVertex : face)
+            {
+                if (!resolveIndex(faceVertex.vertexId, verticesOffset, vertices.size(), false) || !resolveIndex(faceVertex.uvId, uvsOffset, uvs.size(), true) ||
+                    !resolveIndex(faceVertex.normalId, normalsOffset, normals.size(), true))
+                {
+                    Log::get() << Log::WARNING << "Loader::Obj::" << __FUNCTION__ << " - A face refers to an undefined vertex, texture coordinate or normal" << Log::endl;
+                    return false;
+                }
+            }
+
+            glm::vec4 faceNormal(0.f);
+            if (face[0].normalId == -1)
+            {
+                auto edge1 = glm::vec3(vertices[face[1].vertexId] - vertices[face[0].vertexId]);
+                auto edge2 = glm::vec3(vertices[face[2].vertexId] - vertices[face[0].vertexId]);
+                faceNormal = glm::vec4(glm::normalize(glm::cross(edge1, edge2)), 0.0);
+            }
+
+            for (const auto& faceVertex : face)
+            {
+                const auto key = VertexKey{faceVertex.vertexId, faceVertex.uvId, faceVertex.normalId, faceNormal};
+                const auto newIndex = static_cast<uint32_t>(_meshVertices.size());
+                const auto vertexIt = vertexIndices.emplace(key, newIndex);
+                if (vertexIt.second)
+                {
+                    _meshVertices.push_back(vertices[faceVertex.vertexId]);
+                    _meshUVs.push_back(faceVertex.uvId == -1 ? glm::vec2(0.f, 0.f) : uvs[faceVertex.uvId]);
+                    _meshNormals.push_back(faceVertex.normalId == -1 ? faceNormal : normals[faceVertex.normalId]);
+                }
+                _meshIndices.push_back(vertexIt.first->second);
+            }
+        }
+
+        verticesOffset += chunk.vertices.size();
+        uvsOffset += chunk.uvs.size();
+        normalsOffset += chunk.normals.size();
+    }
+
+    return true;
+}
+
+/*************/
+bool Obj::readCache(const std::string& filename, uint64_t fileSize, int64_t modificationTime)
+{
+    MappedFile cache(filename + CACHE_EXTENSION);
+    if (!cache || cache.size() < sizeof(CacheHeader))
+        return false;
+
+    CacheHeader header;
+    memcpy(&header, cache.data(), sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION)
+        return false;
+    if (header.sourceSize != fileSize || header.sourceModificationTime != modificationTime)
+        return false;
+
+    const auto verticesCount = header.verticesCount;
+    const auto indicesCount = header.indicesCount;
+    const auto expectedSize = sizeof(CacheHeader) + verticesCount * (sizeof(glm::vec4) + sizeof(glm::vec2) + sizeof(glm::vec4)) + indicesCount * sizeof(uint32_t);
+    if (cache.size() != expectedSize || verticesCount == 0 || indicesCount == 0)
+        return false;
+
+    auto data = cache.data() + sizeof(CacheHeader);
+    _meshVertices.resize(verticesCount);
+    memcpy(_meshVertices.data(), data, verticesCount * sizeof(glm::vec4));
+    data += verticesCount * sizeof(glm::vec4);
+    _meshUVs.resize(verticesCount);
+    memcpy(_meshUVs.data(), data, verticesCount * sizeof(glm::vec2));
+    data += verticesCount * sizeof(glm::vec2);
+    _meshNormals.resize(verticesCount);
+    memcpy(_meshNormals.data(), data, verticesCount * sizeof(glm::vec4));
+    data += verticesCount * sizeof(glm::vec4);
+    _meshIndices.resize(indicesCount);
+    memcpy(_meshIndices.data(), data, indicesCount * sizeof(uint32_t));
+
+    if (std::any_of(_meshIndices.cbegin(), _meshIndices.cend(), [&](auto index) { return index >= verticesCount; }))
+    {
+        _meshVertices.clear();
+        _meshUVs.clear();
+        _meshNormals.clear();
+        _meshIndices.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/*************/
+void Obj::writeCache(const std::string& filename, uint64_t fileSize, int64_t modificationTime) const
+{
+    CacheHeader header{};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.sourceSize = fileSize;
+    header.sourceModificationTime = modificationTime;
+    header.verticesCount = _meshVertices.size();
+    header.indicesCount = _meshIndices.size();
+
+    // The cache is written to a temporary file first, so that a concurrent load never reads a partial cache
+    const auto cachePath = filename + CACHE_EXTENSION;
+    const auto temporaryPath = cachePath + "." + std::to_string(getpid());
+    auto file = fopen(temporaryPath.c_str(), "wb");
+    if (!file)
+    {
+        Log::get() << Log::DEBUGGING << "Loader::Obj::" << __FUNCTION__ << " - Unable to write the mesh cache " << cachePath << Log::endl;
+        return;
+    }
+
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+    success = success && fwrite(_meshVertices.data(), sizeof(glm::vec4), _meshVertices.size(), file) == _meshVertices.size();
+    success = success && fwrite(_meshUVs.data(), sizeof(glm::vec2), _meshUVs.size(), file) == _meshUVs.size();
+    success = success && fwrite(_meshNormals.data(), sizeof(glm::vec4), _meshNormals.size(), file) == _meshNormals.size();
+    success = success && fwrite(_meshIndices.data(), sizeof(uint32_t), _meshIndices.size(), file) == _meshIndices.size();
+    success = (fclose(file) == 0) && success;
+
+    if (!success || rename(temporaryPath.c_str(), cachePath.c_str()) != 0)
+    {
+        Log::get() << Log::DEBUGGING << "Loader::Obj::" << __FUNCTION__ << " - Unable to write the mesh cache " << cachePath << Log::endl;
+        remove(temporaryPath.c_str());
+    }
+}
+
+} // namespace Loader
+} // namespace Splash
@@ -95,10 +95,11 @@ bool Link::sendBuffer(const std::shared_ptr<BufferObject>& object)
 /*************/
 bool Link::sendMessage(const std::string& name, const std::string& attribute, const Values& message)
 {
-    std::vector<uint8_t> serializedMessage;
-    Serial::serialize(name, serializedMessage);
-    Serial::serialize(attribute, serializedMessage);
-    Serial::serialize(message, serializedMessage);
+    std::vector<uint8_t> serializedMessage(Serial::getSize(name) + Serial::getSize(attribute) + Serial::getSize(message));
+    Span<uint8_t> output(serializedMessage);
+    Serial::serializeTo(name, output);
+    Serial::serializeTo(attribute, output);
+    Serial::serializeTo(message, output);
 
     auto result = _channelOutput->sendMessage(serializedMessage);
 
@@ -114,12 +115,10 @@ bool Link::sendMessage(const std::string& name, const std::string& attribute, co
 /*************/
 void Link::handleInputMessages(const std::vector<uint8_t>& message)
 {
-    size_t offset = 0;
-    auto name = Serial::deserialize<std::string>(message);
-    offset += Serial::getSize(name);
-    auto attribute = Serial::deserialize<std::string>(message, offset);
-    offset += Serial::getSize(attribute);
-    auto value = Serial::deserialize<Values>(message, offset);
+    Span<const uint8_t> input(message);
+    const auto name = Serial::deserializeFrom<std::string>(input);
+    const auto attribute = Serial::deserializeFrom<std::string>(input);
+    const auto value = Serial::deserializeFrom<Values>(input);
 
     if (_rootObject)
         _rootObject->set(name, attribute, value);
@@ -137,8 +136,8 @@ void Link::handleInputBuffers(SerializedObject&& buffer)
     if (buffer.size() == 0)
         return;
 
-    auto bufferDataIt = buffer._data.cbegin();
-    const auto name = Serial::detail::deserializer<std::string>(bufferDataIt);
+    Span<const uint8_t> input(buffer);
+    const auto name = Serial::deserializeFrom<std::string>(input);
     if (_rootObject)
         _rootObject->setFromSerializedObject(name, std::move(buffer));
 }
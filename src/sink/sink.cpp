@@ -1,15 +1,20 @@
 #include "./sink/sink.h"
 
+#include <algorithm>
 #include <fstream>
 
 #include "./core/constants.h"
 #include "./core/scene.h"
 #include "./graphics/texture.h"
+#include "./utils/log.h"
 #include "./utils/timer.h"
 
 namespace Splash
 {
 
+std::mutex Sink::_orphanSlotsMutex{};
+std::vector<Sink::OrphanSlot> Sink::_orphanSlots{};
+
 /*************/
 Sink::Sink(RootObject* root)
     : GraphObject(root)
@@ -28,13 +33,56 @@ Sink::~Sink()
     if (!_root)
         return;
 
-    if (_mappedPixels)
+    if (_lastSlot)
+        _lastSlot->users.fetch_sub(1, std::memory_order_release);
+
+    // Buffers still referenced by frames are left mapped, their pixels having to stay valid,
+    // and are released later on by another Sink
+    for (auto& slot : _readbackSlots)
     {
-        glUnmapNamedBuffer(_pbos[_pboWriteIndex]);
-        _mappedPixels = nullptr;
+        if (slot->users.load(std::memory_order_acquire) == 0)
+        {
+            releaseReadbackSlot(*slot);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(_orphanSlotsMutex);
+            _orphanSlots.push_back({_root, slot});
+        }
     }
 
-    glDeleteBuffers(_pbos.size(), _pbos.data());
+    releaseOrphanSlots();
+}
+
+/*************/
+std::shared_ptr<const Sink::Frame> Sink::getFrame() const
+{
+    std::lock_guard<std::mutex> lock(_lockPixels);
+    return makeFrame();
+}
+
+/*************/
+std::shared_ptr<const Sink::Frame> Sink::waitForFrame(uint64_t timestamp, std::chrono::microseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(_lockPixels);
+    if (!_frameCondition.wait_for(lock, timeout, [&]() { return _lastSlot && _lastSlot->timestamp > timestamp; }))
+        return nullptr;
+    return makeFrame();
+}
+
+/*************/
+std::shared_ptr<const Sink::Frame> Sink::makeFrame() const
+{
+    if (!_lastSlot)
+        return nullptr;
+
+    // The frame keeps the slot alive, for its mapping to outlive the Sink if needed
+    auto slot = _lastSlot;
+    slot->users.fetch_add(1, std::memory_order_relaxed);
+    return std::shared_ptr<const Frame>(new Frame{slot->mapping, slot->spec, slot->timestamp}, [slot](const Frame* frame) {
+        slot->users.fetch_sub(1, std::memory_order_release);
+        delete frame;
+    });
 }
 
 /*************/
@@ -91,28 +139,35 @@ void Sink::unlinkIt(const std::shared_ptr<GraphObject>& obj)
 /*************/
 void Sink::render()
 {
-    if (!_inputFilter || !_mappedPixels)
+    if (!_inputFilter)
         return;
 
-    handlePixels(reinterpret_cast<char*>(_mappedPixels), _spec);
+    {
+        std::lock_guard<std::mutex> lock(_lockPixels);
+        if (!_newFrame)
+            return;
+        _newFrame = false;
+    }
+
+    if (auto frame = getFrame(); frame)
+        handleFrame(frame);
 }
 
 /*************/
 void Sink::update()
 {
+    releaseOrphanSlots();
+
     if (!_inputFilter)
         return;
 
+    // Downloads issued by previous updates are checked without waiting for them
+    collectReadbacks();
+
     auto textureSpec = _inputFilter->getSpec();
     if (textureSpec.rawSize() == 0)
         return;
 
-    if (!_pbos.empty() && _mappedPixels)
-    {
-        glUnmapNamedBuffer(_pbos[_pboWriteIndex]);
-        _mappedPixels = nullptr;
-    }
-
     if (_spec.type != ImageBufferSpec::Type::UINT16 && _sixteenBpc)
         _inputFilter->setSixteenBpc(true);
     else if (_spec.type == ImageBufferSpec::Type::UINT16 && !_sixteenBpc)
@@ -146,16 +201,20 @@ void Sink::update()
     uint64_t period = static_cast<uint64_t>(1e6 / (double)_framerate);
     if (period != 0 && _lastFrameTiming != 0 && currentTime - _lastFrameTiming < period)
         return;
-    _lastFrameTiming = currentTime;
 
-    if (_spec != textureSpec || _pbos.size() != _pboCount)
+    updateReadbackSlots();
+    _spec = textureSpec;
+
+    // Rather than waiting for a buffer in the render loop, the grab is skipped and tried again at the next update
+    auto slot = acquireFreeSlot(_spec.rawSize());
+    if (!slot)
     {
-        updatePbos(textureSpec.width, textureSpec.height, textureSpec.pixelBytes());
-        _spec = textureSpec;
-        _image = ImageBuffer(_spec);
+        ++_skippedGrabs;
+        return;
     }
+    _lastFrameTiming = currentTime;
 
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbos[_pboWriteIndex]);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
 
     auto scene = dynamic_cast<Scene*>(_root);
     // Nvidia hardware and/or drivers do not like much copying to a PBO
@@ -183,7 +242,6 @@ void Sink::update()
     }
     else
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbos[_pboWriteIndex]);
         if (_spec.bpp == 64)
             glGetTextureImage(_inputFilter->getTexId(), 0, GL_RGBA, GL_UNSIGNED_SHORT, 0, 0);
         else if (_spec.bpp == 32)
@@ -200,34 +258,144 @@ void Sink::update()
 
     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
-    _pboWriteIndex = (_pboWriteIndex + 1) % _pbos.size();
+    // The mapping being coherent, the pixels are visible to the CPU once the fence is signaled.
+    // The fence is polled without the flush bit, so it is flushed here for it to be signaled at some point
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    slot->spec = _spec;
+    slot->timestamp = currentTime;
+}
+
+/*************/
+void Sink::handleFrame(const std::shared_ptr<const Frame>& /*frame*/)
+{
+    // Frames are read through getFrame by default
+}
+
+/*************/
+void Sink::updateReadbackSlots()
+{
+    const auto isFree = [](const auto& slot) { return slot->fence == nullptr && slot->users.load(std::memory_order_acquire) == 0; };
+    while (_readbackSlots.size() > _pboCount)
+    {
+        auto slotIt = std::find_if(_readbackSlots.begin(), _readbackSlots.end(), isFree);
+        if (slotIt == _readbackSlots.end())
+            break;
+        releaseReadbackSlot(**slotIt);
+        _readbackSlots.erase(slotIt);
+    }
 
-    _mappedPixels = (GLubyte*)glMapNamedBufferRange(_pbos[_pboWriteIndex], 0, _spec.rawSize(), GL_MAP_READ_BIT);
+    while (_readbackSlots.size() < _pboCount)
+        _readbackSlots.push_back(std::make_shared<ReadbackSlot>());
 }
 
 /*************/
-void Sink::handlePixels(const char* pixels, const ImageBufferSpec& spec)
+void Sink::releaseReadbackSlot(ReadbackSlot& slot)
 {
-    uint32_t size = spec.rawSize();
-    if (size != _buffer.size())
-        _buffer.resize(size);
+    glDeleteSync(slot.fence);
+    if (slot.buffer)
+    {
+        if (slot.mapping)
+            glUnmapNamedBuffer(slot.buffer);
+        glDeleteBuffers(1, &slot.buffer);
+    }
 
-    memcpy(_buffer.data(), pixels, size);
+    slot.buffer = 0;
+    slot.mapping = nullptr;
+    slot.capacity = 0;
+    slot.fence = nullptr;
 }
 
 /*************/
-void Sink::updatePbos(int width, int height, int bytes)
+void Sink::releaseOrphanSlots()
 {
-    if (!_pbos.empty())
-        glDeleteBuffers(_pbos.size(), _pbos.data());
+    std::lock_guard<std::mutex> lock(_orphanSlotsMutex);
+    if (_orphanSlots.empty())
+        return;
 
-    _pbos.resize(_pboCount);
-    glCreateBuffers(_pbos.size(), _pbos.data());
+    // The acquire load pairs with the release of the frames, so that their readers are done with the pixels
+    for (auto orphanIt = _orphanSlots.begin(); orphanIt != _orphanSlots.end();)
+    {
+        if (orphanIt->root != _root || orphanIt->slot->users.load(std::memory_order_acquire) != 0)
+        {
+            ++orphanIt;
+            continue;
+        }
 
-    for (uint32_t i = 0; i < _pbos.size(); ++i)
-        glNamedBufferData(_pbos[i], width * height * bytes, 0, GL_STREAM_READ);
+        releaseReadbackSlot(*orphanIt->slot);
+        orphanIt = _orphanSlots.erase(orphanIt);
+    }
+}
 
-    _pboWriteIndex = 0;
+/*************/
+Sink::ReadbackSlot* Sink::acquireFreeSlot(size_t size)
+{
+    for (auto& slot : _readbackSlots)
+    {
+        // The acquire load pairs with the release of the frames, so that their readers are done with the pixels
+        if (slot->fence != nullptr || slot->users.load(std::memory_order_acquire) != 0)
+            continue;
+
+        if (slot->buffer && slot->capacity >= size)
+            return slot.get();
+
+        // Immutable storage can not be resized, so the buffer is created again
+        releaseReadbackSlot(*slot);
+        const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &slot->buffer);
+        glNamedBufferStorage(slot->buffer, size, nullptr, flags | GL_CLIENT_STORAGE_BIT);
+        slot->mapping = static_cast<const uint8_t*>(glMapNamedBufferRange(slot->buffer, 0, size, flags));
+        if (!slot->mapping)
+        {
+            Log::get() << Log::WARNING << "Sink::" << __FUNCTION__ << " - Unable to map the readback buffer" << Log::endl;
+            releaseReadbackSlot(*slot);
+            return nullptr;
+        }
+        slot->capacity = size;
+        return slot.get();
+    }
+
+    return nullptr;
+}
+
+/*************/
+void Sink::collectReadbacks()
+{
+    std::shared_ptr<ReadbackSlot> newest{nullptr};
+    for (auto& slot : _readbackSlots)
+    {
+        if (!slot->fence)
+            continue;
+
+        const auto waitResult = glClientWaitSync(slot->fence, 0, 0);
+        if (waitResult == GL_TIMEOUT_EXPIRED)
+            continue;
+
+        glDeleteSync(slot->fence);
+        slot->fence = nullptr;
+        if (waitResult == GL_WAIT_FAILED)
+        {
+            Log::get() << Log::WARNING << "Sink::" << __FUNCTION__ << " - Error while waiting for the frame download" << Log::endl;
+            continue;
+        }
+
+        if (!newest || slot->timestamp > newest->timestamp)
+            newest = slot;
+    }
+
+    // Older downloads are dropped, their slots being free again
+    if (!newest || (_lastSlot && newest->timestamp <= _lastSlot->timestamp))
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_lockPixels);
+        newest->users.fetch_add(1, std::memory_order_relaxed);
+        if (_lastSlot)
+            _lastSlot->users.fetch_sub(1, std::memory_order_release);
+        _lastSlot = newest;
+        _newFrame = true;
+    }
+    _frameCondition.notify_all();
 }
 
 /*************/
@@ -243,7 +411,7 @@ void Sink::registerAttributes()
         },
         [&]() -> Values { return {_pboCount}; },
         {'i'});
-    setAttributeDescription("bufferCount", "Number of GPU buffers to use for data download to CPU memory");
+    setAttributeDescription("bufferCount", "Number of GPU buffers to use for data download to CPU memory. Frames are skipped while all of them are in use");
 
     addAttribute(
         "framerate",
@@ -297,6 +465,9 @@ void Sink::registerAttributes()
         [&]() -> Values { return {_keepRatio}; },
         {'b'});
     setAttributeDescription("keepRatio", "If true, keeps the ratio of the input image");
+
+    addAttribute("skippedGrabs", [&]() -> Values { return {static_cast<int64_t>(_skippedGrabs.load())}; });
+    setAttributeDescription("skippedGrabs", "Number of frames skipped because all the GPU buffers were in use");
 }
 
 } // namespace Splash
@@ -25,22 +25,37 @@
 #ifndef SPLASH_SINK_H
 #define SPLASH_SINK_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "./core/constants.h"
 
 #include "./core/attribute.h"
 #include "./core/graph_object.h"
 #include "./graphics/filter.h"
-#include "./utils/resizable_array.h"
 
 namespace Splash
 {
 
 class Sink : public GraphObject
 {
+  public:
+    /**
+     * Frame downloaded from the GPU. The pixels are read in place from the buffer they were downloaded to,
+     * which the Sink does not reuse as long as the frame is held
+     */
+    struct Frame
+    {
+        const uint8_t* pixels{nullptr};
+        ImageBufferSpec spec{};
+        uint64_t timestamp{0}; //!< Time at which the frame was grabbed, in us
+    };
+
   public:
     /**
      * Constructor
@@ -61,10 +76,19 @@ class Sink : public GraphObject
     Sink& operator=(Sink&&) = delete;
 
     /**
-     * Get the current buffer as a resizable array
-     * \return Return the buffer
+     * Get the last downloaded frame. Holding it prevents its buffer from being reused, so it should
+     * be released as soon as possible: downloads are skipped while all buffers are held
+     * \return Return the frame, or nullptr if none has been downloaded yet
+     */
+    std::shared_ptr<const Frame> getFrame() const;
+
+    /**
+     * Wait for a frame newer than the given timestamp
+     * \param timestamp Timestamp of the last frame received, in us
+     * \param timeout Maximum waiting time
+     * \return Return the last downloaded frame, or nullptr if no newer frame came in time
      */
-    ResizableArray<uint8_t> getBuffer() const { return _buffer; };
+    std::shared_ptr<const Frame> waitForFrame(uint64_t timestamp, std::chrono::microseconds timeout) const;
 
     /**
      * Generate a caps from the input texture spec
@@ -112,32 +136,81 @@ class Sink : public GraphObject
     void registerAttributes();
 
   private:
+    // Persistently mapped buffer the input texture is downloaded to
+    struct ReadbackSlot
+    {
+        GLuint buffer{0};
+        const uint8_t* mapping{nullptr};
+        size_t capacity{0};
+        GLsync fence{nullptr}; //!< Set while the download is in flight
+        ImageBufferSpec spec{};
+        uint64_t timestamp{0};
+        std::atomic_int users{0}; //!< Frames referencing the buffer, including the last frame kept by the Sink
+    };
+
     std::shared_ptr<Filter> _inputFilter{nullptr};
     ImageBufferSpec _spec{};
-    ImageBuffer _image{};
-    std::mutex _lockPixels{};
-    ResizableArray<uint8_t> _buffer{};
+    mutable std::mutex _lockPixels{};
+    mutable std::condition_variable _frameCondition{}; //!< Notified when a frame has been downloaded
 
     bool _opened{false}; //!< If true, the sink lets frames through
 
     uint64_t _lastFrameTiming{0};
     uint32_t _pboCount{3};
-    std::vector<GLuint> _pbos{};
-    int _pboWriteIndex{0};
-    GLubyte* _mappedPixels{nullptr};
+    std::vector<std::shared_ptr<ReadbackSlot>> _readbackSlots{};
+    std::shared_ptr<ReadbackSlot> _lastSlot{nullptr}; //!< Slot of the last downloaded frame, protected by _lockPixels
+    bool _newFrame{false};                            //!< True if a frame has been downloaded since the last render
+    std::atomic_uint64_t _skippedGrabs{0};            //!< Number of grabs skipped because no buffer was free
+
+    // Slots still held by frames when their Sink was destroyed. Frames can be dropped from any thread,
+    // so these are released on the GL thread by the other Sinks of the same root object
+    struct OrphanSlot
+    {
+        RootObject* root{nullptr};
+        std::shared_ptr<ReadbackSlot> slot{nullptr};
+    };
+    static std::mutex _orphanSlotsMutex;
+    static std::vector<OrphanSlot> _orphanSlots;
+
+    /**
+     * Create a frame referencing the last downloaded slot. _lockPixels has to be held
+     * \return Return the frame, or nullptr if none has been downloaded yet
+     */
+    std::shared_ptr<const Frame> makeFrame() const;
+
+    /**
+     * Class to be implemented to send the frames somewhere. It is called once per downloaded frame
+     * \param frame Downloaded frame
+     */
+    virtual void handleFrame(const std::shared_ptr<const Frame>& frame);
+
+    /**
+     * Add or remove readback slots to match the buffer count. Slots in use are removed once released
+     */
+    void updateReadbackSlots();
+
+    /**
+     * Release the GL objects held by a readback slot
+     * \param slot Readback slot
+     */
+    static void releaseReadbackSlot(ReadbackSlot& slot);
+
+    /**
+     * Release the orphan slots of this root object which are not held by any frame anymore
+     */
+    void releaseOrphanSlots();
 
     /**
-     * Class to be implemented to copy the _mappedPixels somewhere
+     * Get a slot which is neither in flight nor held by a frame, with room for the given size
+     * \param size Size of the frame to download
+     * \return Return the slot, or nullptr if all slots are in use
      */
-    virtual void handlePixels(const char* pixels, const ImageBufferSpec& spec);
+    ReadbackSlot* acquireFreeSlot(size_t size);
 
     /**
-     * Update the pbos according to the parameters
-     * \param width Width
-     * \param height Height
-     * \param bytes Bytes per pixel
+     * Check for the downloads the GPU is done with, and keep the newest one as the last frame
      */
-    void updatePbos(int width, int height, int bytes);
+    void collectReadbacks();
 };
 
 } // namespace Splash
@@ -12,10 +12,11 @@ Sink_Shmdata::Sink_Shmdata(RootObject* root)
 }
 
 /*************/
-void Sink_Shmdata::handlePixels(const char* pixels, const ImageBufferSpec& spec)
+void Sink_Shmdata::handleFrame(const std::shared_ptr<const Frame>& frame)
 {
+    const auto& spec = frame->spec;
     auto size = spec.rawSize();
-    if (!pixels || size == 0)
+    if (!frame->pixels || size == 0)
         return;
 
     if (!_writer || spec != _previousSpec || _framerate != _previousFramerate)
@@ -28,7 +29,7 @@ void Sink_Shmdata::handlePixels(const char* pixels, const ImageBufferSpec& spec)
     }
 
     if (_writer)
-        _writer->copy_to_shm(pixels, size);
+        _writer->copy_to_shm(frame->pixels, size);
 }
 
 /*************/
@@ -48,6 +49,7 @@ void Sink_Shmdata::registerAttributes()
 
     addAttribute("caps", [&](const Values&) { return true; }, [&]() -> Values { return {_caps}; }, {'s'});
     setAttributeDescription("caps", "Caps of the sent data");
+    setAttributeVolatile("caps", true);
 }
 
 } // end of namespace
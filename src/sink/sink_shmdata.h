@@ -50,9 +50,11 @@ class Sink_Shmdata final : public Sink
     uint32_t _previousFramerate{0};
 
     /**
-     * Class to be implemented to copy the _mappedPixels somewhere
+     * Class to be implemented to send the frames somewhere.
+     * Here the pixels are copied to the shared memory, straight from the download buffer
+     * \param frame Downloaded frame
      */
-    void handlePixels(const char* pixels, const ImageBufferSpec& spec) final;
+    void handleFrame(const std::shared_ptr<const Frame>& frame) final;
 
     /**
      * Register new functors to modify attributes
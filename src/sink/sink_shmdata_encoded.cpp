@@ -14,11 +14,25 @@ Sink_Shmdata_Encoded::Sink_Shmdata_Encoded(RootObject* root)
 {
     _type = "sink_shmdata_encoded";
     registerAttributes();
+
+    if (!_root)
+        return;
+
+    _encoderThread = std::thread([&]() { encoderLoop(); });
 }
 
 /*************/
 Sink_Shmdata_Encoded::~Sink_Shmdata_Encoded()
 {
+    {
+        std::lock_guard<std::mutex> lockQueue(_queueMutex);
+        _runEncoder = false;
+    }
+    _queueCondition.notify_all();
+
+    if (_encoderThread.joinable())
+        _encoderThread.join();
+
     freeFFmpegObjects();
 }
 
@@ -108,20 +122,17 @@ bool Sink_Shmdata_Encoded::initFFmpegObjects(const ImageBufferSpec& spec)
 
     _frame = av_frame_alloc();
     _yuvFrame = av_frame_alloc();
-    if (!_frame || !_yuvFrame)
+    _packet = av_packet_alloc();
+    if (!_frame || !_yuvFrame || !_packet)
     {
         Log::get() << Log::WARNING << "Sink_Shmdata_Encoded::" << __FUNCTION__ << " - Unable to allocate frame" << Log::endl;
         return false;
     }
 
+    // The RGBA frame points to the queued frames, it does not hold any buffer
     _frame->format = AV_PIX_FMT_RGB32;
     _frame->width = spec.width;
     _frame->height = spec.height;
-    if (av_image_alloc(_frame->data, _frame->linesize, _context->width, _context->height, AV_PIX_FMT_RGB32, 32) < 0)
-    {
-        Log::get() << Log::WARNING << "Sink_Shmdata_Encoded::" << __FUNCTION__ << " - Unable to allocate raw RGBA picture buffer" << Log::endl;
-        return false;
-    }
 
     _yuvFrame->format = AV_PIX_FMT_YUV420P;
     _yuvFrame->width = spec.width;
@@ -149,10 +160,18 @@ void Sink_Shmdata_Encoded::freeFFmpegObjects()
     if (_frame)
         av_frame_free(&_frame);
     if (_yuvFrame)
+    {
+        av_freep(&_yuvFrame->data[0]);
         av_frame_free(&_yuvFrame);
+    }
+    if (_packet)
+        av_packet_free(&_packet);
 
     if (_swsContext)
+    {
         sws_freeContext(_swsContext);
+        _swsContext = nullptr;
+    }
 }
 
 /*************/
@@ -187,14 +206,62 @@ std::string Sink_Shmdata_Encoded::generateCaps(const ImageBufferSpec& spec, uint
 }
 
 /*************/
-void Sink_Shmdata_Encoded::handlePixels(const char* pixels, const ImageBufferSpec& spec)
+void Sink_Shmdata_Encoded::handleFrame(const std::shared_ptr<const Frame>& frame)
 {
-    auto size = spec.rawSize();
-    if (!pixels || size == 0)
+    if (!frame->pixels || frame->spec.rawSize() == 0)
         return;
 
+    // Queued frames keep their download buffers from being reused, so frames are dropped
+    // by the Sink if the encoder is late and the queue is longer than the buffer count
+    std::unique_lock<std::mutex> lockQueue(_queueMutex);
+    if (_dropOldest)
+    {
+        while (!_queue.empty() && _queue.size() >= _queueSize)
+        {
+            _queue.pop_front();
+            ++_droppedFrames;
+        }
+    }
+    else
+    {
+        _queueCondition.wait(lockQueue, [&]() { return _queue.size() < _queueSize || _dropOldest || !_runEncoder; });
+    }
+
+    _queue.push_back(frame);
+    lockQueue.unlock();
+    _queueCondition.notify_all();
+}
+
+/*************/
+void Sink_Shmdata_Encoded::encoderLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<const Frame> frame;
+        {
+            std::unique_lock<std::mutex> lockQueue(_queueMutex);
+            _queueCondition.wait(lockQueue, [&]() { return !_queue.empty() || !_runEncoder; });
+            if (!_runEncoder)
+                break;
+
+            frame = std::move(_queue.front());
+            _queue.pop_front();
+        }
+        // Wake up the render thread if it waits for some room in the queue
+        _queueCondition.notify_all();
+
+        encodeFrame(*frame);
+    }
+}
+
+/*************/
+void Sink_Shmdata_Encoded::encodeFrame(const Frame& frame)
+{
+    const auto& spec = frame.spec;
+
     if (_resetEncoding || !_context || !_writer || spec != _previousSpec || _previousFramerate != _framerate)
     {
+        std::lock_guard<std::mutex> lockParameters(_parametersMutex);
         _resetEncoding = false;
 
         // Reset FFmpeg context and stuff
@@ -205,26 +272,17 @@ void Sink_Shmdata_Encoded::handlePixels(const char* pixels, const ImageBufferSpe
         // Reset shmdata writer
         _caps = generateCaps(spec, _framerate, _options, _codecName, _context);
         _writer.reset(nullptr);
-        _writer.reset(new shmdata::Writer(_path, size, _caps, &_logger));
+        _writer.reset(new shmdata::Writer(_path, spec.rawSize(), _caps, &_logger));
 
         _previousSpec = spec;
         _previousFramerate = _framerate;
     }
 
     // Encoding
-    AVPacket* packet = av_packet_alloc();
-    if (!packet)
-    {
-        Log::get() << Log::ERROR << "Sink_Shmdata_Encoded::" << __FUNCTION__ << " - Can not allocate memory for encoding frame" << Log::endl;
-    }
-
-    packet->data = nullptr;
-    packet->size = 0;
-
-    av_image_fill_arrays(_frame->data, _frame->linesize, reinterpret_cast<const uint8_t*>(pixels), AV_PIX_FMT_RGB32, spec.width, spec.height, 1);
+    av_image_fill_arrays(_frame->data, _frame->linesize, frame.pixels, AV_PIX_FMT_RGB32, spec.width, spec.height, 1);
     sws_scale(_swsContext, _frame->data, _frame->linesize, 0, spec.height, _yuvFrame->data, _yuvFrame->linesize);
 
-    _yuvFrame->pts = (static_cast<double>((Timer::get().getTime() - _startTime)) / 1e3) / _framerate;
+    _yuvFrame->pts = (static_cast<double>(static_cast<int64_t>(frame.timestamp) - _startTime) / 1e3) / _framerate;
     _yuvFrame->quality = _context->global_quality;
     _yuvFrame->pict_type = AV_PICTURE_TYPE_NONE;
 
@@ -235,20 +293,19 @@ void Sink_Shmdata_Encoded::handlePixels(const char* pixels, const ImageBufferSpe
         return;
     }
 
-    while (1)
+    while (true)
     {
-        ret = avcodec_receive_packet(_context, packet);
-        if (ret == AVERROR(EAGAIN))
+        ret = avcodec_receive_packet(_context, _packet);
+        if (ret < 0)
             break;
-        else if (ret < 0)
-            return;
 
         // Sending through shmdata
-        if (_writer && packet->size != 0)
-            _writer->copy_to_shm(packet->data, packet->size);
+        if (_writer && _packet->size != 0)
+            _writer->copy_to_shm(_packet->data, _packet->size);
+        av_packet_unref(_packet);
     }
 
-    av_packet_unref(packet);
+    _encoderLatency = static_cast<float>(Timer::getTime() - frame.timestamp) / 1000.f;
 }
 
 /*************/
@@ -258,6 +315,7 @@ void Sink_Shmdata_Encoded::registerAttributes()
 
     addAttribute("bitrate",
         [&](const Values& args) {
+            std::lock_guard<std::mutex> lockParameters(_parametersMutex);
             _bitRate = std::max(1000000, args[0].as<int>());
             _resetEncoding = true;
             return true;
@@ -266,11 +324,15 @@ void Sink_Shmdata_Encoded::registerAttributes()
         {'i'});
     setAttributeDescription("bitrate", "Output encoded video target bitrate");
 
-    addAttribute("caps", [&]() -> Values { return {_caps}; });
+    addAttribute("caps", [&]() -> Values {
+        std::lock_guard<std::mutex> lockParameters(_parametersMutex);
+        return {_caps};
+    });
     setAttributeDescription("caps", "Generated caps");
 
     addAttribute("codec",
         [&](const Values& args) {
+            std::lock_guard<std::mutex> lockParameters(_parametersMutex);
             _codecName = args[0].as<std::string>();
             transform(_codecName.begin(), _codecName.end(), _codecName.begin(), ::tolower);
             _resetEncoding = true;
@@ -282,6 +344,7 @@ void Sink_Shmdata_Encoded::registerAttributes()
 
     addAttribute("codecOptions",
         [&](const Values& args) {
+            std::lock_guard<std::mutex> lockParameters(_parametersMutex);
             _options = args[0].as<std::string>();
             _resetEncoding = true;
             return true;
@@ -295,16 +358,79 @@ void Sink_Shmdata_Encoded::registerAttributes()
 
     addAttribute("socket",
         [&](const Values& args) {
+            std::lock_guard<std::mutex> lockParameters(_parametersMutex);
             _path = args[0].as<std::string>();
-            _previousSpec = ImageBufferSpec();
+            _resetEncoding = true;
             return true;
         },
-        [&]() -> Values { return {_path}; },
+        [&]() -> Values {
+            std::lock_guard<std::mutex> lockParameters(_parametersMutex);
+            return {_path};
+        },
         {'s'});
     setAttributeDescription("socket", "Socket path to which data is sent");
 
-    addAttribute("caps", [&](const Values&) { return true; }, [&]() -> Values { return {_caps}; }, {'s'});
+    addAttribute(
+        "caps",
+        [&](const Values&) { return true; },
+        [&]() -> Values {
+            std::lock_guard<std::mutex> lockParameters(_parametersMutex);
+            return {_caps};
+        },
+        {'s'});
     setAttributeDescription("caps", "Caps of the sent data");
+    setAttributeVolatile("caps", true);
+
+    addAttribute(
+        "dropPolicy",
+        [&](const Values& args) {
+            const auto policy = args[0].as<std::string>();
+            if (policy != "drop_oldest" && policy != "block")
+                return false;
+
+            {
+                std::lock_guard<std::mutex> lockQueue(_queueMutex);
+                _dropOldest = (policy == "drop_oldest");
+            }
+            _queueCondition.notify_all();
+            return true;
+        },
+        [&]() -> Values {
+            std::lock_guard<std::mutex> lockQueue(_queueMutex);
+            return {_dropOldest ? "drop_oldest" : "block"};
+        },
+        {'s'});
+    setAttributeDescription("dropPolicy",
+        "Behavior when the encoding queue is full: \"drop_oldest\" drops the oldest queued frame, \"block\" waits for the encoder, slowing down rendering");
+
+    addAttribute(
+        "queueSize",
+        [&](const Values& args) {
+            {
+                std::lock_guard<std::mutex> lockQueue(_queueMutex);
+                _queueSize = std::max(1, args[0].as<int>());
+            }
+            _queueCondition.notify_all();
+            return true;
+        },
+        [&]() -> Values {
+            std::lock_guard<std::mutex> lockQueue(_queueMutex);
+            return {_queueSize};
+        },
+        {'i'});
+    setAttributeDescription("queueSize", "Maximum number of frames waiting to be encoded");
+
+    addAttribute("queueDepth", [&]() -> Values {
+        std::lock_guard<std::mutex> lockQueue(_queueMutex);
+        return {static_cast<int>(_queue.size())};
+    });
+    setAttributeDescription("queueDepth", "Number of frames currently waiting to be encoded");
+
+    addAttribute("droppedFrames", [&]() -> Values { return {static_cast<int64_t>(_droppedFrames.load())}; });
+    setAttributeDescription("droppedFrames", "Number of frames dropped because the encoding queue was full");
+
+    addAttribute("encoderLatency", [&]() -> Values { return {_encoderLatency.load()}; });
+    setAttributeDescription("encoderLatency", "Time between the capture of the last encoded frame and the end of its encoding, in ms");
 }
 
 } // end of namespace
@@ -25,6 +25,11 @@
 #ifndef SPLASH_SINK_SHMDATA_ENCODED_H
 #define SPLASH_SINK_SHMDATA_ENCODED_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 #include <shmdata/writer.hpp>
@@ -71,12 +76,25 @@ class Sink_Shmdata_Encoded final : public Sink
     std::unique_ptr<shmdata::Writer> _writer{nullptr};
     ImageBufferSpec _previousSpec{};
     uint32_t _previousFramerate{0};
-    bool _resetEncoding{false};
+    std::atomic_bool _resetEncoding{false};
+    std::mutex _parametersMutex{}; //!< Protects the parameters read by the encoder thread
+
+    // Encoding queue and thread
+    std::thread _encoderThread{};
+    std::atomic_bool _runEncoder{true};
+    std::mutex _queueMutex{};
+    std::condition_variable _queueCondition{};
+    std::deque<std::shared_ptr<const Frame>> _queue{}; //!< Frames waiting to be encoded, which hold their download buffers
+    uint32_t _queueSize{3};                            //!< Maximum number of frames waiting to be encoded
+    bool _dropOldest{true};                            //!< If true, drop the oldest frame when the queue is full, otherwise wait for the encoder
+    std::atomic_uint64_t _droppedFrames{0};            //!< Number of frames dropped because the queue was full
+    std::atomic<float> _encoderLatency{0.f};           //!< Time from capture to the end of encoding for the last frame, in ms
 
     // FFmpeg objects
     AVCodec* _codec{nullptr};
     AVCodecContext* _context{nullptr};
     AVFrame *_frame{nullptr}, *_yuvFrame{nullptr};
+    AVPacket* _packet{nullptr};
     SwsContext* _swsContext{nullptr};
 
     // Codec parameters
@@ -117,11 +135,22 @@ class Sink_Shmdata_Encoded final : public Sink
     std::string generateCaps(const ImageBufferSpec& spec, uint32_t framerate, const std::string& optionString, const std::string& codecName, AVCodecContext* ctx);
 
     /**
-     * Class to be implemented to copy the _mappedPixels somewhere
-     * \param pixels Input image
-     * \param spec Input image specifications
+     * Class to be implemented to send the frames somewhere.
+     * Here the frames are queued for encoding, without copying their pixels
+     * \param frame Downloaded frame
+     */
+    void handleFrame(const std::shared_ptr<const Frame>& frame) final;
+
+    /**
+     * Encoder thread loop, encoding the queued frames and sending them through shmdata
+     */
+    void encoderLoop();
+
+    /**
+     * Encode a single frame and send the resulting packets
+     * \param frame Frame to encode
      */
-    void handlePixels(const char* pixels, const ImageBufferSpec& spec) final;
+    void encodeFrame(const Frame& frame);
 
     /**
      * Parse the options from the given string, formatted as:
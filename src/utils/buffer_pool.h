@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @buffer_pool.h
+ * The BufferPool class, which recycles large memory buffers
+ */
+
+#ifndef SPLASH_BUFFER_POOL_H
+#define SPLASH_BUFFER_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Splash
+{
+
+/*************/
+class BufferPool
+{
+  public:
+    static constexpr size_t MIN_POOLED_SIZE = 1 << 16;        //!< Smaller buffers are not worth pooling
+    static constexpr size_t BUCKET_GRANULARITY = 1 << 12;     //!< Buffer sizes are rounded up to this, to group close sizes in the same bucket
+    static constexpr size_t DEFAULT_MAX_RETAINED = 128 << 20; //!< Default maximum size of the released buffers kept for reuse
+    static constexpr std::chrono::seconds DEFAULT_MAX_IDLE{5};  //!< Default duration after which the buffers of a bucket which has not been used are freed
+
+  public:
+    /**
+     * Get the singleton
+     * \return Return the BufferPool singleton
+     */
+    static BufferPool& get()
+    {
+        static auto instance = new BufferPool;
+        return *instance;
+    }
+
+    /**
+     * Allocate a buffer, reusing a released one of the same bucket if possible. The memory is not initialized.
+     * \param size Buffer size in bytes
+     * \return Return a pointer to the buffer
+     */
+    void* allocate(size_t size)
+    {
+        if (size < MIN_POOLED_SIZE)
+            return ::operator new(size);
+
+        const auto bucketSize = getBucketSize(size);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto bucketIt = _buckets.find(bucketSize);
+            if (bucketIt != _buckets.end() && !bucketIt->second.buffers.empty())
+            {
+                auto& bucket = bucketIt->second;
+                auto buffer = bucket.buffers.back();
+                bucket.buffers.pop_back();
+                bucket.lastUse = std::chrono::steady_clock::now();
+                _retainedSize -= bucketSize;
+                ++_reuseCount;
+                return buffer;
+            }
+        }
+
+        ++_systemAllocationCount;
+        return ::operator new(bucketSize);
+    }
+
+    /**
+     * Release a buffer allocated by this pool, keeping it for later reuse if the pool is not full.
+     * Buckets which have not been used for a while are trimmed along the way
+     * \param buffer Pointer to the buffer
+     * \param size Buffer size in bytes, as given to allocate()
+     */
+    void deallocate(void* buffer, size_t size)
+    {
+        if (!buffer)
+            return;
+
+        if (size < MIN_POOLED_SIZE)
+        {
+            ::operator delete(buffer);
+            return;
+        }
+
+        const auto bucketSize = getBucketSize(size);
+        const auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (now - _lastTrim >= _maxIdle)
+            {
+                _lastTrim = now;
+                trimLocked(now - _maxIdle);
+            }
+
+            if (_retainedSize + bucketSize <= _maxRetainedSize)
+            {
+                auto& bucket = _buckets[bucketSize];
+                bucket.buffers.push_back(buffer);
+                bucket.lastUse = now;
+                _retainedSize += bucketSize;
+                return;
+            }
+        }
+
+        ::operator delete(buffer);
+    }
+
+    /**
+     * Free all the buffers kept for reuse
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        trimLocked(std::chrono::steady_clock::time_point::max());
+    }
+
+    /**
+     * Free the buffers of the buckets which have not been used for the given duration
+     * \param maxIdle Maximum idle duration
+     */
+    void trim(std::chrono::steady_clock::duration maxIdle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        trimLocked(std::chrono::steady_clock::now() - maxIdle);
+    }
+
+    /**
+     * Set the maximum size of the released buffers kept for reuse
+     * \param size Size in bytes
+     */
+    void setMaxRetainedSize(size_t size)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxRetainedSize = size;
+    }
+
+    /**
+     * Set the duration after which the buffers of a bucket which has not been used are freed
+     * \param maxIdle Maximum idle duration
+     */
+    void setMaxIdle(std::chrono::steady_clock::duration maxIdle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxIdle = maxIdle;
+    }
+
+    /**
+     * Get the size of the released buffers currently kept for reuse
+     * \return Return the size in bytes
+     */
+    size_t getRetainedSize()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _retainedSize;
+    }
+
+    /**
+     * Get the number of pooled-size buffers which had to be allocated from the system
+     * \return Return the allocation count
+     */
+    uint64_t getSystemAllocationCount() const { return _systemAllocationCount; }
+
+    /**
+     * Get the number of allocations served by reusing a released buffer
+     * \return Return the reuse count
+     */
+    uint64_t getReuseCount() const { return _reuseCount; }
+
+  private:
+    struct Bucket
+    {
+        std::vector<void*> buffers{};
+        std::chrono::steady_clock::time_point lastUse{};
+    };
+
+    std::mutex _mutex{};
+    std::unordered_map<size_t, Bucket> _buckets{};
+    size_t _retainedSize{0};
+    size_t _maxRetainedSize{DEFAULT_MAX_RETAINED};
+    std::chrono::steady_clock::duration _maxIdle{DEFAULT_MAX_IDLE};
+    std::chrono::steady_clock::time_point _lastTrim{std::chrono::steady_clock::now()};
+    std::atomic_uint64_t _systemAllocationCount{0};
+    std::atomic_uint64_t _reuseCount{0};
+
+    BufferPool() = default;
+
+    /**
+     * Free the buffers of the buckets which have not been used after the given time. The mutex must be held
+     * \param threshold Time before which a bucket is considered idle
+     */
+    void trimLocked(std::chrono::steady_clock::time_point threshold)
+    {
+        for (auto bucketIt = _buckets.begin(); bucketIt != _buckets.end();)
+        {
+            if (bucketIt->second.lastUse > threshold)
+            {
+                ++bucketIt;
+                continue;
+            }
+
+            for (auto buffer : bucketIt->second.buffers)
+                ::operator delete(buffer);
+            _retainedSize -= bucketIt->first * bucketIt->second.buffers.size();
+            bucketIt = _buckets.erase(bucketIt);
+        }
+    }
+
+    static size_t getBucketSize(size_t size) { return (size + BUCKET_GRANULARITY - 1) / BUCKET_GRANULARITY * BUCKET_GRANULARITY; }
+};
+
+/*************/
+/**
+ * Allocator drawing its memory from the BufferPool. Elements are default-initialized,
+ * which means that arithmetic types are left uninitialized instead of being zeroed.
+ */
+template <typename T>
+class PooledAllocator
+{
+  public:
+    using value_type = T;
+
+    PooledAllocator() noexcept = default;
+    template <typename U>
+    PooledAllocator(const PooledAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(size_t n) { return static_cast<T*>(BufferPool::get().allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { BufferPool::get().deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value)
+    {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const PooledAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PooledAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+} // namespace Splash
+
+#endif // SPLASH_BUFFER_POOL_H
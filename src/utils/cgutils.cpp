@@ -1,6 +1,6 @@
 #include "./utils/cgutils.h"
 
-#include <future>
+#include "./utils/thread_pool.h"
 
 namespace Splash
 {
@@ -8,9 +8,8 @@ namespace Splash
 /*************/
 void hapDecodeCallback(HapDecodeWorkFunction func, void* p, unsigned int count, void* /*info*/)
 {
-    std::vector<std::future<void>> threads;
-    for (unsigned int i = 0; i < count; ++i)
-        threads.push_back(std::async(std::launch::async, [=]() { func(p, i); }));
+    // The chunks are decoded by the shared thread pool, the calling thread taking part in it
+    ThreadPool::get().parallelFor(count, [&](size_t index) { func(p, static_cast<unsigned int>(index)); });
 }
 
 /*************/
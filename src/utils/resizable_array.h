@@ -28,21 +28,28 @@
 #include <memory>
 #include <vector>
 
+#include "./utils/buffer_pool.h"
+
 namespace Splash
 {
 
 /*************/
-template <typename T>
+/**
+ * Array which can be shifted to get rid of a header without copying. By default the storage comes
+ * from the BufferPool and is left uninitialized on resize, as it is meant to be overwritten right away.
+ */
+template <typename T, typename Allocator = PooledAllocator<T>>
 class ResizableArray
 {
   public:
     using value_type = T;
-    using iterator = typename std::vector<T>::iterator;
-    using const_iterator = typename std::vector<T>::const_iterator;
+    using allocator_type = Allocator;
+    using iterator = T*;
+    using const_iterator = const T*;
 
   public:
     /**
-     * Constructor with an initial size
+     * Constructor with an initial size. Content is uninitialized unless the allocator value-initializes it
      * \param size Initial array size
      */
     ResizableArray(size_t size = 0) { resize(size); }
@@ -90,16 +97,6 @@ class ResizableArray
     {
     }
 
-    /**
-     * Constructor from a std::vector<<T>
-     * \param data Vector to use, grabbed as a r-value
-     */
-    ResizableArray(std::vector<T>&& data)
-    {
-        _shift = 0;
-        std::swap(_buffer, data);
-    }
-
     /**
      * Copy operator
      * \param a ResizableArray to copy from
@@ -143,10 +140,10 @@ class ResizableArray
     /**
      * Iterators
      */
-    iterator begin() { return _buffer.begin() + _shift; }
-    iterator end() { return _buffer.end(); }
-    const_iterator cbegin() const { return _buffer.cbegin() + _shift; }
-    const_iterator cend() const { return _buffer.cend(); }
+    iterator begin() { return data(); }
+    iterator end() { return _buffer.data() + _buffer.size(); }
+    const_iterator cbegin() const { return data(); }
+    const_iterator cend() const { return _buffer.data() + _buffer.size(); }
 
     /**
      * Get a pointer to the data
@@ -189,7 +186,7 @@ class ResizableArray
         else
         {
             const auto currentSize = _buffer.size();
-            std::vector<T> newBuffer(size);
+            std::vector<T, Allocator> newBuffer(size);
             if (currentSize != 0)
                 std::copy(_buffer.data(), _buffer.data() + std::min(size, currentSize), newBuffer.data());
             std::swap(_buffer, newBuffer);
@@ -198,8 +195,8 @@ class ResizableArray
     }
 
   private:
-    size_t _shift{0};         //!< Buffer shift
-    std::vector<T> _buffer{}; //!< Pointer to the buffer data
+    size_t _shift{0};                    //!< Buffer shift
+    std::vector<T, Allocator> _buffer{}; //!< Pointer to the buffer data
 };
 
 } // namespace Splash
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @span.h
+ * The Span class, a non-owning view over contiguous elements
+ */
+
+#ifndef SPLASH_SPAN_H
+#define SPLASH_SPAN_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Non-owning view over contiguous elements, similar to C++20's std::span.
+ * The viewed memory must outlive the span.
+ */
+template <typename T>
+class Span
+{
+  public:
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+  public:
+    /**
+     * Constructors
+     */
+    Span() = default;
+    Span(T* data, size_t size)
+        : _data(data)
+        , _size(size)
+    {
+    }
+
+    /**
+     * Constructor from a contiguous container, like std::vector, ResizableArray or SerializedObject
+     * \param container Container to view
+     */
+    template <class Container, typename = std::enable_if_t<std::is_convertible<decltype(std::declval<Container&>().data()), T*>::value>>
+    Span(Container& container)
+        : _data(container.data())
+        , _size(container.size())
+    {
+    }
+
+    /**
+     * Implicit conversion to a span of const elements
+     */
+    operator Span<const T>() const { return Span<const T>(_data, _size); }
+
+    /**
+     * Access operator
+     * \param i Index
+     * \return Return value at i
+     */
+    T& operator[](size_t i) const { return _data[i]; }
+
+    /**
+     * Iterators
+     */
+    iterator begin() const { return _data; }
+    iterator end() const { return _data + _size; }
+    const_iterator cbegin() const { return _data; }
+    const_iterator cend() const { return _data + _size; }
+
+    /**
+     * Get a pointer to the data
+     * \return Return a pointer to the data
+     */
+    T* data() const { return _data; }
+
+    /**
+     * Get the number of elements
+     * \return Return the size
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * Check whether the span is empty
+     * \return Return true if empty
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     * Get a view over part of this span
+     * \param offset First element of the sub-span, clamped to the span size
+     * \param count Element count, clamped to the remaining size
+     * \return Return the sub-span
+     */
+    Span subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const
+    {
+        offset = offset < _size ? offset : _size;
+        count = count < _size - offset ? count : _size - offset;
+        return Span(_data + offset, count);
+    }
+
+  private:
+    T* _data{nullptr};
+    size_t _size{0};
+};
+
+} // namespace Splash
+
+#endif // SPLASH_SPAN_H
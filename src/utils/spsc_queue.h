@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @spsc_queue.h
+ * The SpscQueue class, a bounded lock-free queue between one producer and one consumer
+ */
+
+#ifndef SPLASH_SPSC_QUEUE_H
+#define SPLASH_SPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Bounded queue between a single producer thread and a single consumer thread.
+ * Pushing and popping do not lock, a mutex being only used by a thread which has
+ * to wait for the queue not to be full or empty.
+ *
+ * The depth of the queue can be limited in elements and in weight, the weight of each
+ * element being given when pushing it (typically its size in bytes). This limit is only
+ * enforced by waitNotFull, so that the producer can push a few elements beyond it.
+ *
+ * Producer side: tryPush, waitNotFull, waitEmpty. Consumer side: front, pop, waitNotEmpty.
+ * clear can be called from any thread.
+ */
+template <typename T>
+class SpscQueue
+{
+  public:
+    /**
+     * Constructor
+     * \param slotCount Maximum number of elements held by the queue
+     */
+    explicit SpscQueue(size_t slotCount)
+        : _slots(std::max<size_t>(slotCount, 1))
+        , _maxDepth(_slots.size())
+    {
+    }
+
+    /**
+     * Other constructors and operators
+     */
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * Set the depth over which the queue is considered full
+     * \param depth Maximum number of elements, capped to the slot count
+     * \param weight Maximum total weight of the elements
+     */
+    void setMaxDepth(size_t depth, size_t weight = std::numeric_limits<size_t>::max())
+    {
+        _maxDepth = std::min(std::max<size_t>(depth, 1), _slots.size());
+        _maxWeight = weight;
+        notify(_producerWaiting, _notFullCondition);
+    }
+
+    /**
+     * Push an element, without waiting. To be called by the producer
+     * \param value Element to push
+     * \param weight Element weight
+     * \return Return false if all slots are used, in which case value is left untouched
+     */
+    bool tryPush(T&& value, size_t weight = 1)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) >= _slots.size())
+            return false;
+
+        auto& slot = _slots[tail % _slots.size()];
+        slot.value = std::move(value);
+        slot.weight = weight;
+        _weight.fetch_add(weight, std::memory_order_relaxed);
+        _tail.store(tail + 1, std::memory_order_seq_cst);
+
+        notify(_consumerWaiting, _notEmptyCondition);
+        return true;
+    }
+
+    /**
+     * Wait for the queue not to be full. To be called by the producer
+     * \param timeout Maximum wait duration
+     * \return Return true if the queue is not full
+     */
+    template <typename Rep, typename Period>
+    bool waitNotFull(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return wait(_producerWaiting, _notFullCondition, timeout, [&]() { return !isFull(); });
+    }
+
+    /**
+     * Wait for the queue to be empty, the consumer having popped all the elements. To be called by the producer
+     * \param timeout Maximum wait duration
+     * \return Return true if the queue is empty
+     */
+    template <typename Rep, typename Period>
+    bool waitEmpty(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return wait(_producerWaiting, _notFullCondition, timeout, [&]() { return size() == 0; });
+    }
+
+    /**
+     * Get the element at the front of the queue, which stays in the queue. To be called by the consumer
+     * \return Return a pointer to the element, or nullptr if the queue is empty
+     */
+    T* front()
+    {
+        applyClear();
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return nullptr;
+        return &_slots[head % _slots.size()].value;
+    }
+
+    /**
+     * Remove the element at the front of the queue. To be called by the consumer
+     */
+    void pop()
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return;
+        release(head);
+        _head.store(head + 1, std::memory_order_seq_cst);
+        notify(_producerWaiting, _notFullCondition);
+    }
+
+    /**
+     * Wait for the queue not to be empty. To be called by the consumer
+     * \param timeout Maximum wait duration
+     * \return Return true if the queue is not empty
+     */
+    template <typename Rep, typename Period>
+    bool waitNotEmpty(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        // Wake up on any element, cleared or not, so that the cleared ones are released and the producer is not left waiting for free slots
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true)
+        {
+            applyClear();
+            if (hasElements())
+                return true;
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::steady_clock::duration::zero())
+                return false;
+            if (!wait(_consumerWaiting, _notEmptyCondition, remaining, [&]() { return _tail.load(std::memory_order_seq_cst) > _head.load(std::memory_order_relaxed); }))
+                return false;
+        }
+    }
+
+    /**
+     * Drop all the elements pushed so far. The elements are released by the consumer on its next access or wait
+     */
+    void clear()
+    {
+        const auto tail = _tail.load(std::memory_order_acquire);
+        auto clearUpTo = _clearUpTo.load(std::memory_order_relaxed);
+        while (clearUpTo < tail && !_clearUpTo.compare_exchange_weak(clearUpTo, tail, std::memory_order_seq_cst))
+            ;
+        notify(_consumerWaiting, _notEmptyCondition);
+    }
+
+    /**
+     * Get the number of elements in the queue, not counting the cleared ones
+     * \return Return the element count
+     */
+    size_t size() const
+    {
+        const auto first = std::max(_head.load(std::memory_order_acquire), _clearUpTo.load(std::memory_order_acquire));
+        const auto tail = _tail.load(std::memory_order_acquire);
+        return tail > first ? tail - first : 0;
+    }
+
+    /**
+     * Get the total weight of the elements in the queue
+     * \return Return the weight
+     */
+    size_t weight() const { return _weight.load(std::memory_order_relaxed); }
+
+    /**
+     * Check whether the queue is deeper than its maximum depth
+     * \return Return true if the queue is full
+     */
+    bool isFull() const { return size() >= _maxDepth || (size() > 0 && weight() >= _maxWeight); }
+
+  private:
+    struct Slot
+    {
+        T value{};
+        size_t weight{0};
+    };
+
+    std::vector<Slot> _slots;
+    std::atomic<size_t> _maxDepth;
+    std::atomic<size_t> _maxWeight{std::numeric_limits<size_t>::max()};
+
+    // Indices only grow, the slot being the index modulo the slot count
+    alignas(64) std::atomic_uint64_t _head{0}; //!< Next element to pop, written by the consumer
+    alignas(64) std::atomic_uint64_t _tail{0}; //!< Next slot to push to, written by the producer
+    alignas(64) std::atomic_uint64_t _clearUpTo{0};
+    std::atomic<size_t> _weight{0};
+
+    std::mutex _waitMutex{};
+    std::condition_variable _notEmptyCondition{};
+    std::condition_variable _notFullCondition{};
+    std::atomic_bool _consumerWaiting{false};
+    std::atomic_bool _producerWaiting{false};
+
+    // Release the element in the given slot, so that its resources are not held until the slot is reused
+    void release(uint64_t index)
+    {
+        auto& slot = _slots[index % _slots.size()];
+        slot.value = T();
+        _weight.fetch_sub(slot.weight, std::memory_order_relaxed);
+    }
+
+    // Check whether some elements are left once the cleared ones are dropped
+    bool hasElements() const
+    {
+        const auto first = std::max(_head.load(std::memory_order_relaxed), _clearUpTo.load(std::memory_order_acquire));
+        return _tail.load(std::memory_order_seq_cst) > first;
+    }
+
+    // Drop the elements up to the index set by clear. Only called by the consumer
+    void applyClear()
+    {
+        const auto clearUpTo = _clearUpTo.load(std::memory_order_acquire);
+        auto head = _head.load(std::memory_order_relaxed);
+        if (head >= clearUpTo)
+            return;
+
+        for (; head < clearUpTo; ++head)
+            release(head);
+        _head.store(head, std::memory_order_seq_cst);
+        notify(_producerWaiting, _notFullCondition);
+    }
+
+    // The waiting flag is set before checking the predicate, and the indices are stored before checking
+    // the flag, both sequentially consistent: either the waiter sees the new state or the notifier sees the flag
+    template <typename Rep, typename Period, typename Predicate>
+    bool wait(std::atomic_bool& waiting, std::condition_variable& condition, const std::chrono::duration<Rep, Period>& timeout, Predicate predicate)
+    {
+        if (predicate())
+            return true;
+
+        std::unique_lock<std::mutex> lock(_waitMutex);
+        waiting.store(true, std::memory_order_seq_cst);
+        const auto result = condition.wait_for(lock, timeout, predicate);
+        waiting.store(false, std::memory_order_relaxed);
+        return result;
+    }
+
+    void notify(std::atomic_bool& waiting, std::condition_variable& condition)
+    {
+        if (!waiting.load(std::memory_order_seq_cst))
+            return;
+        std::lock_guard<std::mutex> lock(_waitMutex);
+        condition.notify_all();
+    }
+};
+
+} // namespace Splash
+
+#endif // SPLASH_SPSC_QUEUE_H
@@ -0,0 +1,288 @@
+#include "./utils/thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "./utils/log.h"
+#include "./utils/osutils.h"
+#include "./utils/timer.h"
+
+namespace chrono = std::chrono;
+
+namespace Splash
+{
+
+thread_local const ThreadPool* ThreadPool::_currentPool{nullptr};
+thread_local size_t ThreadPool::_currentWorker{0};
+
+/*************/
+ThreadPool::ThreadPool(int workerCount)
+{
+    if (workerCount <= 0)
+        workerCount = std::max(Utils::getCoreCount(), MIN_WORKER_COUNT);
+
+    for (int i = 0; i < workerCount; ++i)
+        _workers.emplace_back(std::make_unique<Worker>());
+    for (size_t i = 0; i < _workers.size(); ++i)
+        _workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+}
+
+/*************/
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto& worker : _workers)
+        worker->thread.join();
+}
+
+/*************/
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& function, Priority priority)
+{
+    if (count == 0)
+        return;
+
+    if (count == 1 || _workers.empty())
+    {
+        for (size_t index = 0; index < count; ++index)
+            function(index);
+        return;
+    }
+
+    struct Loop
+    {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        size_t count{0};
+        const std::function<void(size_t)>* function{nullptr};
+        std::exception_ptr exception{nullptr}; //!< First exception thrown by the function, protected by the mutex
+        std::mutex mutex{};
+        std::condition_variable condition{};
+    };
+
+    // The function is only called for unclaimed indices, which means that this call did not return yet.
+    // An index is counted as done even if the function throws, for this call not to return before the others are
+    auto loop = std::make_shared<Loop>();
+    loop->count = count;
+    loop->function = &function;
+    const auto run = [loop]() {
+        for (auto index = loop->next++; index < loop->count; index = loop->next++)
+        {
+            try
+            {
+                (*loop->function)(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(loop->mutex);
+                if (!loop->exception)
+                    loop->exception = std::current_exception();
+            }
+
+            if (++loop->done == loop->count)
+            {
+                std::lock_guard<std::mutex> lock(loop->mutex);
+                loop->condition.notify_all();
+            }
+        }
+    };
+
+    const auto helperCount = std::min(count - 1, _workers.size());
+    for (size_t i = 0; i < helperCount; ++i)
+        push(run, priority);
+    run();
+
+    // All indices are claimed at this point, the remaining ones being run by the workers
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->condition.wait(lock, [&]() { return loop->done == count; });
+
+    if (loop->exception)
+        std::rethrow_exception(loop->exception);
+}
+
+/*************/
+bool ThreadPool::runPendingTask()
+{
+    if (_pendingTasks == 0)
+        return false;
+
+    const auto workerIndex = _currentPool == this ? _currentWorker : _nextWorker.load(std::memory_order_relaxed) % _workers.size();
+    Task task;
+    if (!popTask(workerIndex, task))
+        return false;
+
+    execute(task);
+    return true;
+}
+
+/*************/
+void ThreadPool::setAffinity(const std::vector<int>& cores)
+{
+    {
+        std::lock_guard<std::mutex> lock(_affinityMutex);
+        _affinity = cores;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        ++_affinityVersion;
+    }
+    _sleepCondition.notify_all();
+}
+
+/*************/
+ThreadPool::Stats ThreadPool::getStats()
+{
+    std::lock_guard<std::mutex> lock(_statsMutex);
+
+    const auto now = chrono::steady_clock::now();
+    Stats stats;
+    stats.busyTime = _busyTime.exchange(0);
+    stats.elapsedTime = chrono::duration_cast<chrono::microseconds>(now - _lastStatsTime).count();
+    stats.executedTasks = _executedTasks.exchange(0);
+    stats.stolenTasks = _stolenTasks.exchange(0);
+    stats.pendingTasks = _pendingTasks;
+    stats.workerCount = _workers.size();
+    _lastStatsTime = now;
+
+    return stats;
+}
+
+/*************/
+void ThreadPool::updateStats()
+{
+    const auto stats = getStats();
+    {
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _lastStats = stats;
+    }
+
+    Timer::get().setDuration("thread_pool_busy", stats.busyTime);
+}
+
+/*************/
+ThreadPool::Stats ThreadPool::getLastStats()
+{
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    return _lastStats;
+}
+
+/*************/
+void ThreadPool::push(Task&& task, Priority priority)
+{
+    const auto workerIndex = _currentPool == this ? _currentWorker : _nextWorker++ % _workers.size();
+    auto& worker = *_workers[workerIndex];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues[static_cast<size_t>(priority)].push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        ++_pendingTasks;
+    }
+    _sleepCondition.notify_one();
+}
+
+/*************/
+bool ThreadPool::popTask(size_t workerIndex, Task& task)
+{
+    for (size_t priority = 0; priority < PRIORITY_COUNT; ++priority)
+    {
+        // The most recent task of the worker's own queue is the most likely to have its data in cache
+        {
+            auto& worker = *_workers[workerIndex];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            auto& queue = worker.queues[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.back());
+                queue.pop_back();
+                --_pendingTasks;
+                return true;
+            }
+        }
+
+        // Otherwise the oldest task of another worker is stolen
+        for (size_t offset = 1; offset < _workers.size(); ++offset)
+        {
+            auto& worker = *_workers[(workerIndex + offset) % _workers.size()];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            auto& queue = worker.queues[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.front());
+                queue.pop_front();
+                --_pendingTasks;
+                ++_stolenTasks;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/*************/
+void ThreadPool::execute(Task& task)
+{
+    // Counted before running it, for the count to be up to date once its future is ready
+    ++_executedTasks;
+    const auto start = chrono::steady_clock::now();
+
+    try
+    {
+        task();
+    }
+    catch (const std::exception& e)
+    {
+        Log::get() << Log::WARNING << "ThreadPool::" << __FUNCTION__ << " - Exception thrown by a task: " << e.what() << Log::endl;
+    }
+
+    task = nullptr;
+    _busyTime += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+
+/*************/
+void ThreadPool::workerLoop(size_t index)
+{
+    _currentPool = this;
+    _currentWorker = index;
+
+    uint64_t affinityVersion = 0;
+    Task task;
+    while (true)
+    {
+        if (const auto version = _affinityVersion.load(); version != affinityVersion)
+        {
+            std::vector<int> cores;
+            {
+                std::lock_guard<std::mutex> lock(_affinityMutex);
+                cores = _affinity;
+            }
+
+            if (cores.empty())
+                for (int core = 0; core < Utils::getCoreCount(); ++core)
+                    cores.push_back(core);
+            Utils::setAffinity(cores);
+            affinityVersion = version;
+        }
+
+        if (popTask(index, task))
+        {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [&]() { return _stop || _pendingTasks != 0 || _affinityVersion != affinityVersion; });
+        if (_stop)
+            return;
+    }
+}
+
+} // namespace Splash
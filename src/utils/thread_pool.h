@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @thread_pool.h
+ * The ThreadPool class, a process-wide work-stealing thread pool
+ */
+
+#ifndef SPLASH_THREAD_POOL_H
+#define SPLASH_THREAD_POOL_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Splash
+{
+
+/*************/
+/**
+ * Work-stealing thread pool, running the asynchronous tasks of the whole process.
+ *
+ * Each worker has its own queues, one per priority. Tasks submitted by a worker go to its own queues
+ * and are run last in first out, while tasks submitted by other threads are spread over the workers.
+ * An idle worker steals the oldest tasks of the others, higher priorities first.
+ *
+ * A worker waiting for a task through wait runs pending tasks meanwhile, so that tasks waiting
+ * for other tasks do not deadlock the pool.
+ */
+class ThreadPool
+{
+  public:
+    enum class Priority : uint8_t
+    {
+        High = 0,
+        Normal,
+        Low
+    };
+
+    static constexpr size_t PRIORITY_COUNT = 3;
+    static constexpr int MIN_WORKER_COUNT = 4; //!< Some tasks run for long, like calibrations, so a few workers are always created
+
+    struct Stats
+    {
+        uint64_t busyTime{0};      //!< Time spent running tasks since the last call, in us
+        uint64_t elapsedTime{0};   //!< Time elapsed since the last call, in us
+        uint64_t executedTasks{0}; //!< Tasks started since the last call
+        uint64_t stolenTasks{0};   //!< Tasks stolen from another worker since the last call
+        size_t pendingTasks{0};    //!< Tasks waiting to be run
+        size_t workerCount{0};
+    };
+
+  public:
+    /**
+     * Get the process-wide pool
+     * \return Return the ThreadPool singleton
+     */
+    static ThreadPool& get()
+    {
+        static auto instance = new ThreadPool;
+        return *instance;
+    }
+
+    /**
+     * Constructor
+     * \param workerCount Worker count, defaults to the core count
+     */
+    explicit ThreadPool(int workerCount = 0);
+
+    /**
+     * Destructor, waiting for the running tasks. Pending tasks are dropped
+     */
+    ~ThreadPool();
+
+    /**
+     * Other constructors and operators
+     */
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Submit a task
+     * \param function Function to run
+     * \param priority Task priority
+     * \return Return a future holding the function result. Contrary to the ones returned by std::async, it does not wait for the task when destroyed
+     */
+    template <typename Function>
+    auto submit(Function&& function, Priority priority = Priority::Normal) -> std::future<std::invoke_result_t<std::decay_t<Function>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Function>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        auto future = task->get_future();
+        push([task]() { (*task)(); }, priority);
+        return future;
+    }
+
+    /**
+     * Run a function for each index in [0, count), in parallel. The calling thread takes part in it.
+     * If the function throws, the first exception is rethrown once all indices have been run
+     * \param count Index count
+     * \param function Function to run, given the index
+     * \param priority Priority of the tasks run by the workers
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& function, Priority priority = Priority::High);
+
+    /**
+     * Wait for a future. If called from a worker, pending tasks are run meanwhile
+     * \param future Future to wait for
+     */
+    template <typename T>
+    void wait(const std::future<T>& future)
+    {
+        if (!future.valid())
+            return;
+
+        // Other threads do not run the tasks, which could take long compared to the one waited for
+        if (_currentPool != this)
+        {
+            future.wait();
+            return;
+        }
+
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            if (!runPendingTask())
+                future.wait_for(std::chrono::milliseconds(1));
+    }
+
+    /**
+     * Run one pending task, if any
+     * \return Return true if a task was run
+     */
+    bool runPendingTask();
+
+    /**
+     * Set the cores the workers run on
+     * \param cores Cores to run on, all of them if empty
+     */
+    void setAffinity(const std::vector<int>& cores);
+
+    /**
+     * Get the worker count
+     * \return Return the worker count
+     */
+    size_t getWorkerCount() const { return _workers.size(); }
+
+    /**
+     * Get the pool statistics since the previous call
+     * \return Return the statistics
+     */
+    Stats getStats();
+
+    /**
+     * Update the statistics returned by getLastStats, and expose the busy time in the Timer durations
+     */
+    void updateStats();
+
+    /**
+     * Get the statistics gathered by the last call to updateStats
+     * \return Return the statistics
+     */
+    Stats getLastStats();
+
+  private:
+    using Task = std::function<void()>;
+
+    struct Worker
+    {
+        std::mutex mutex{};
+        std::array<std::deque<Task>, PRIORITY_COUNT> queues{};
+        std::thread thread{};
+    };
+
+    // The current thread index among the workers of a pool, to push the tasks it submits to its own queues
+    static thread_local const ThreadPool* _currentPool;
+    static thread_local size_t _currentWorker;
+
+    std::vector<std::unique_ptr<Worker>> _workers{};
+    std::atomic<size_t> _pendingTasks{0};
+    std::atomic<size_t> _nextWorker{0}; //!< Worker receiving the next task submitted from outside of the pool
+    std::atomic_bool _stop{false};
+
+    std::mutex _sleepMutex{};
+    std::condition_variable _sleepCondition{};
+
+    std::mutex _affinityMutex{};
+    std::vector<int> _affinity{};
+    std::atomic<uint64_t> _affinityVersion{0};
+
+    std::atomic<uint64_t> _busyTime{0};
+    std::atomic<uint64_t> _executedTasks{0};
+    std::atomic<uint64_t> _stolenTasks{0};
+    std::mutex _statsMutex{};
+    std::chrono::steady_clock::time_point _lastStatsTime{std::chrono::steady_clock::now()};
+    Stats _lastStats{}; //!< Statistics gathered by updateStats, protected by _statsMutex
+
+    /**
+     * Push a task to the queues
+     * \param task Task
+     * \param priority Task priority
+     */
+    void push(Task&& task, Priority priority);
+
+    /**
+     * Get the next task to run, from the given worker queues first then from the other workers
+     * \param workerIndex Index of the worker to look into first
+     * \param task Task to run
+     * \return Return true if a task was found
+     */
+    bool popTask(size_t workerIndex, Task& task);
+
+    /**
+     * Run a task, measuring its duration
+     * \param task Task
+     */
+    void execute(Task& task);
+
+    /**
+     * Worker loop
+     * \param index Worker index
+     */
+    void workerLoop(size_t index);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_THREAD_POOL_H
@@ -23,7 +23,7 @@ class TestWrappedSink(SplashTestCase):
             sink.link_to("image")
             sink.open()
             image = sink.grab()
-            print("Sink re-linked, grabbed image size:", len(image))
+            print("Sink re-linked, grabbed image size:", image.nbytes)
             sink.close()
             sink.unlink()
 
@@ -31,6 +31,10 @@ class TestWrappedSink(SplashTestCase):
         other_sink.set_framerate(15)
         other_sink.open()
         image = other_sink.grab()
-        print("Another sink, grabbed image size:", len(image))
+        print("Another sink, grabbed image size:", image.nbytes, "shape:", image.shape)
+        image.release()
+
+        image = other_sink.grab_next(timeout=1.0)
+        print("Another sink, next image size:", image.nbytes)
 
         other_sink = splash.Sink(some_unknown_arg="oupsy")
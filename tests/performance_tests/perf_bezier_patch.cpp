@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "./mesh/bezier_evaluator.h"
+
+using namespace Splash;
+
+/*************/
+// Evaluation as Mesh_BezierPatch used to do it, computing the Bernstein polynomials for each point
+std::vector<glm::vec2> evaluateNaive(const glm::ivec2& size, const std::vector<glm::vec2>& controlPoints, int resolution)
+{
+    const auto binomialCoeff = [](int n, int i) {
+        double coeff = 1.0;
+        for (int k = 1; k <= i; ++k)
+            coeff = coeff * (n - k + 1) / k;
+        return static_cast<float>(coeff);
+    };
+
+    std::vector<glm::vec2> vertices;
+    for (int v = 0; v < resolution; ++v)
+    {
+        const auto t = static_cast<float>(v) / static_cast<float>(resolution - 1);
+        for (int u = 0; u < resolution; ++u)
+        {
+            const auto s = static_cast<float>(u) / static_cast<float>(resolution - 1);
+            glm::vec2 vertex{0.f, 0.f};
+            for (int j = 0; j < size.y; ++j)
+            {
+                for (int i = 0; i < size.x; ++i)
+                {
+                    const auto factor = binomialCoeff(size.y - 1, j) * std::pow(t, static_cast<float>(j)) * std::pow(1.f - t, static_cast<float>(size.y - 1 - j)) *
+                                        binomialCoeff(size.x - 1, i) * std::pow(s, static_cast<float>(i)) * std::pow(1.f - s, static_cast<float>(size.x - 1 - i));
+                    vertex += factor * controlPoints[i + j * size.x];
+                }
+            }
+            vertices.push_back(vertex);
+        }
+    }
+    return vertices;
+}
+
+/*************/
+template <typename Function>
+double measure(size_t iterations, Function function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        function(i);
+    const auto end = std::chrono::steady_clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()) / static_cast<double>(iterations);
+}
+
+/*************/
+int main()
+{
+    const glm::ivec2 size(4, 4);
+    std::vector<glm::vec2> controlPoints;
+    for (int j = 0; j < size.y; ++j)
+        for (int i = 0; i < size.x; ++i)
+            controlPoints.emplace_back(static_cast<float>(i) / static_cast<float>(size.x - 1) * 2.f - 1.f, static_cast<float>(j) / static_cast<float>(size.y - 1) * 2.f - 1.f);
+
+    std::cout << "----> Bezier patch evaluation performance test\n";
+    std::cout << "Control points: " << size.x << "x" << size.y << "\n";
+
+    for (int resolution = 16; resolution <= 256; resolution *= 2)
+    {
+        const size_t iterations = (1 << 20) / static_cast<size_t>(resolution * resolution) + 8;
+        std::cout << "Resolution " << resolution << "x" << resolution << "\n";
+
+        const auto naive = measure(iterations, [&](size_t) { evaluateNaive(size, controlPoints, resolution); });
+        std::cout << "    Per point basis evaluation -> " << naive << "µs\n";
+
+        // Moving all points forces a full evaluation
+        BezierEvaluator evaluator;
+        auto points = controlPoints;
+        const auto full = measure(iterations, [&](size_t i) {
+            for (auto& point : points)
+                point.x += (i % 2) ? 0.01f : -0.01f;
+            evaluator.evaluate(size, points, resolution);
+        });
+        std::cout << "    Tabulated basis, full evaluation -> " << full << "µs\n";
+
+        const auto incremental = measure(iterations, [&](size_t i) {
+            points[5].x += (i % 2) ? 0.01f : -0.01f;
+            evaluator.evaluate(size, points, resolution);
+        });
+        std::cout << "    Tabulated basis, single control point moved -> " << incremental << "µs\n";
+    }
+
+    return 0;
+}
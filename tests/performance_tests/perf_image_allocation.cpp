@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+#include "./core/imagebuffer.h"
+#include "./utils/buffer_pool.h"
+#include "./utils/resizable_array.h"
+
+using namespace Splash;
+
+/*************/
+// Value-initializing allocator counting its allocations, which is how ResizableArray used to allocate
+static uint64_t systemAllocationCount = 0;
+
+template <typename T>
+struct CountingAllocator : public std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        using other = CountingAllocator<U>;
+    };
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        ++systemAllocationCount;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+/*************/
+int main()
+{
+    const size_t frameCount = 1 << 6;
+    const auto spec = ImageBufferSpec(3840, 2160, 4, 64, ImageBufferSpec::Type::UINT16, "RGBA");
+
+    std::cout << "----> Image allocation performance test\n";
+    std::cout << "Frame size: " << spec.rawSize() / (1 << 20) << "MB\n";
+
+    // Each frame is allocated, filled once as a decoder would, then released
+    {
+        std::cout << "Value-initialized, not pooled -> " << std::flush;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            ResizableArray<uint8_t, CountingAllocator<uint8_t>> buffer(spec.rawSize());
+            memset(buffer.data(), frame, buffer.size());
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << duration / frameCount << "µs per frame, " << static_cast<double>(systemAllocationCount) / frameCount << " allocations per frame\n";
+    }
+
+    {
+        std::cout << "Uninitialized, pooled -> " << std::flush;
+        const auto allocationCount = BufferPool::get().getSystemAllocationCount();
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            ImageBuffer image(spec);
+            memset(image.data(), frame, image.getSize());
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        const auto newAllocations = BufferPool::get().getSystemAllocationCount() - allocationCount;
+        std::cout << duration / frameCount << "µs per frame, " << static_cast<double>(newAllocations) / frameCount << " allocations per frame\n";
+    }
+
+    return 0;
+}
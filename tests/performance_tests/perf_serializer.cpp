@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "./core/imagebuffer.h"
+#include "./core/serialize/serialize_imagebuffer.h"
+#include "./core/serialize/serialize_mesh.h"
+#include "./core/serialize/serialize_value.h"
+#include "./core/serializer.h"
+#include "./core/value.h"
+#include "./mesh/mesh.h"
+
+using namespace Splash;
+
+/*************/
+// Serialize then deserialize the object, and print the duration of each step
+template <class T>
+void measure(const std::string& label, const T& obj, size_t loopCount)
+{
+    ResizableArray<uint8_t> buffer;
+    int64_t serializeDuration = 0;
+    int64_t deserializeDuration = 0;
+
+    for (size_t loop = 0; loop < loopCount; ++loop)
+    {
+        buffer.resize(0);
+        const auto start = std::chrono::steady_clock::now();
+        Serial::serialize(obj, buffer);
+        const auto middle = std::chrono::steady_clock::now();
+        const auto result = Serial::deserialize<T>(buffer);
+        const auto end = std::chrono::steady_clock::now();
+
+        serializeDuration += std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count();
+        deserializeDuration += std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count();
+    }
+
+    std::cout << label << " (" << buffer.size() / 1024 << "kB) -> serialize: " << serializeDuration / loopCount << "µs, deserialize: " << deserializeDuration / loopCount
+              << "µs\n";
+}
+
+/*************/
+int main()
+{
+    const size_t loopCount = 1 << 4;
+
+    std::cout << "----> Serializer performance test\n";
+
+    // Mesh with 2M vertices, the size of a finely tessellated projection surface
+    {
+        const size_t vertexCount = 1 << 21;
+        Mesh::MeshContainer mesh;
+        mesh.name = "mesh";
+        mesh.vertices.resize(vertexCount, glm::vec4(1.f, 2.f, 3.f, 1.f));
+        mesh.uvs.resize(vertexCount, glm::vec2(0.5f, 0.5f));
+        mesh.normals.resize(vertexCount, glm::vec4(0.f, 0.f, 1.f, 0.f));
+        mesh.annexe.resize(vertexCount, glm::vec4(0.f));
+        measure("Mesh, 2M vertices", mesh, loopCount);
+
+        // Containers which are not contiguous are still serialized element by element
+        const auto vertices = std::deque<glm::vec4>(mesh.vertices.cbegin(), mesh.vertices.cend());
+        measure("Vertices as a deque, element by element", vertices, loopCount);
+        measure("Vertices as a vector", mesh.vertices, loopCount);
+    }
+
+    // Values, as sent with each attribute update
+    {
+        Values values;
+        for (int i = 0; i < 1 << 10; ++i)
+            values.push_back(Values({i, static_cast<float>(i) / 2.f, std::to_string(i)}));
+        measure("Values, 1024 nested Values", values, loopCount);
+
+        Values buffer{Value::Buffer(1 << 20)};
+        measure("Values, 1MB buffer", buffer, loopCount);
+    }
+
+    // 4K image
+    {
+        ImageBuffer image(ImageBufferSpec(3840, 2160, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA"));
+        image.zero();
+        measure("ImageBuffer, 3840x2160 RGBA", image, loopCount);
+    }
+
+    return 0;
+}
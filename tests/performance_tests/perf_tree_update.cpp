@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2021 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "./core/root_object.h"
+
+using namespace Splash;
+
+/*************/
+class RootObjectMock : public RootObject
+{
+  public:
+    RootObjectMock()
+        : RootObject()
+    {
+        _name = "world";
+        _tree.setName(_name);
+        runTasks();
+    }
+
+    void updateTree(bool forceFullSync)
+    {
+        if (forceFullSync)
+            _lastFullTreeSync = 0;
+        updateTreeFromObjects();
+    }
+};
+
+/*************/
+int64_t measureLoop(RootObjectMock& root, const std::vector<std::shared_ptr<GraphObject>>& objects, size_t loopCount, bool forceFullSync, bool setAttribute)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loopCount; ++loop)
+    {
+        if (setAttribute)
+            for (auto& object : objects)
+                object->setAttribute("alias", {std::to_string(loop)});
+        root.updateTree(forceFullSync);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / loopCount;
+}
+
+/*************/
+int main()
+{
+    const size_t loopCount = 1 << 6;
+    const std::vector<size_t> objectCounts{10, 50, 150, 300, 600};
+
+    std::cout << "----> Tree update performance test\n";
+    Log::get().setVerbosity(Log::NONE);
+
+    for (const auto objectCount : objectCounts)
+    {
+        RootObjectMock root;
+        std::vector<std::shared_ptr<GraphObject>> objects;
+        for (size_t i = 0; i < objectCount; ++i)
+            objects.push_back(root.createObject("image", "image_" + std::to_string(i)).lock());
+        root.updateTree(true);
+
+        std::cout << objectCount << " objects:\n";
+        std::cout << "    full sync -> " << measureLoop(root, objects, loopCount, true, false) << "µs per loop\n";
+        std::cout << "    no change -> " << measureLoop(root, objects, loopCount, false, false) << "µs per loop\n";
+        std::cout << "    one attribute set per object -> " << measureLoop(root, objects, loopCount, false, true) << "µs per loop\n";
+    }
+
+    return 0;
+}
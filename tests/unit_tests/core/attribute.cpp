@@ -58,3 +58,38 @@ TEST_CASE("Testing Attribute usage")
     CHECK(attr({"A girl has no name"}));
     CHECK(attr().empty());
 }
+
+/*************/
+TEST_CASE("Testing Attribute versioning")
+{
+    int value = 0;
+    auto attr = Attribute("attribute",
+        [&](const Values& args) {
+            value = args[0].as<int>();
+            return true;
+        },
+        [&]() -> Values { return {value}; },
+        {'i'});
+
+    auto version = attr.getVersion();
+    CHECK(version <= Attribute::getLatestVersion());
+    CHECK_EQ(attr()[0].as<int>(), 0);
+    CHECK_EQ(attr.getVersion(), version);
+
+    CHECK(attr({42}));
+    CHECK(attr.getVersion() > version);
+    CHECK_EQ(attr.getVersion(), Attribute::getLatestVersion());
+
+    version = attr.getVersion();
+    attr.lock();
+    CHECK_FALSE(attr({512}));
+    CHECK_EQ(attr.getVersion(), version);
+    attr.unlock();
+
+    CHECK_FALSE(attr.isVolatile());
+    attr.setVolatile(true);
+    CHECK(attr.isVolatile());
+
+    auto getterOnly = Attribute("getterOnly", [&]() -> Values { return {value}; });
+    CHECK(getterOnly.isVolatile());
+}
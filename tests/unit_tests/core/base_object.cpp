@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <string>
@@ -21,6 +22,7 @@ class BaseObjectMock : public BaseObject
     }
 
     void removeAttributeProxy(const std::string& name) { removeAttribute(name); }
+    void setAttributeVolatileProxy(const std::string& name, bool isVolatile) { setAttributeVolatile(name, isVolatile); }
 
     void setupTasks()
     {
@@ -214,3 +216,51 @@ TEST_CASE("Testing BaseObject task and periodic task")
     object->runTasks();
     CHECK_EQ(object->getAttribute("string").value()[0].as<std::string>(), "Async task finished!");
 }
+
+/*************/
+TEST_CASE("Testing BaseObject modified attributes")
+{
+    auto object = std::make_shared<BaseObjectMock>();
+
+    auto findAttribute = [](const auto& attributes, const std::string& name) {
+        return std::find_if(attributes.cbegin(), attributes.cend(), [&](const auto& attribute) { return attribute.first == name; });
+    };
+
+    // First call returns all attributes with a getter
+    auto attributes = object->getModifiedAttributes();
+    CHECK(findAttribute(attributes, "integer") != attributes.cend());
+    CHECK(findAttribute(attributes, "float") != attributes.cend());
+    CHECK(findAttribute(attributes, "string") != attributes.cend());
+    CHECK(findAttribute(attributes, "noSetterAttrib") != attributes.cend());
+    CHECK(findAttribute(attributes, "noGetterAttrib") == attributes.cend());
+
+    // Only getter-only attributes are considered volatile by default
+    attributes = object->getModifiedAttributes();
+    CHECK_EQ(attributes.size(), 1);
+    CHECK(findAttribute(attributes, "noSetterAttrib") != attributes.cend());
+
+    object->setAttribute("integer", {42});
+    attributes = object->getModifiedAttributes();
+    CHECK_EQ(attributes.size(), 2);
+    auto integerIt = findAttribute(attributes, "integer");
+    CHECK(integerIt != attributes.cend());
+    CHECK_EQ(integerIt->second.value()[0].as<int>(), 42);
+
+    object->setAttributeVolatileProxy("string", true);
+    attributes = object->getModifiedAttributes();
+    CHECK_EQ(attributes.size(), 2);
+    CHECK(findAttribute(attributes, "string") != attributes.cend());
+
+    attributes = object->getModifiedAttributes(true);
+    CHECK(findAttribute(attributes, "integer") != attributes.cend());
+    CHECK(findAttribute(attributes, "float") != attributes.cend());
+
+    object->removeAttributeProxy("float");
+    attributes = object->getModifiedAttributes();
+    auto floatIt = findAttribute(attributes, "float");
+    CHECK(floatIt != attributes.cend());
+    CHECK_FALSE(floatIt->second.has_value());
+
+    attributes = object->getModifiedAttributes();
+    CHECK(findAttribute(attributes, "float") == attributes.cend());
+}
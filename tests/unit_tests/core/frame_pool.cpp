@@ -0,0 +1,118 @@
+#include <doctest.h>
+
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "./core/frame_pool.h"
+#include "./core/imagebuffer.h"
+
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing FramePool frame acquisition and mapping")
+{
+    const auto poolName = "splash_test_" + std::to_string(getpid()) + "_pool";
+    FramePool producer(poolName, 2);
+    FramePool consumer;
+
+    // A pool without name can only map frames
+    CHECK_EQ(consumer.acquire(16), nullptr);
+
+    auto frame = producer.acquire(1024);
+    REQUIRE(frame != nullptr);
+    CHECK_EQ(frame->size(), 1024);
+    memset(frame->data(), 42, frame->size());
+
+    auto mappedFrame = consumer.map(frame->getHandle());
+    REQUIRE(mappedFrame != nullptr);
+    CHECK_EQ(mappedFrame->size(), 1024);
+    CHECK_EQ(mappedFrame->data()[0], 42);
+    CHECK_EQ(mappedFrame->data()[1023], 42);
+
+    // The slot is still referenced by the consumer, so a new slot is used
+    const auto handle = frame->getHandle();
+    frame.reset();
+    auto otherFrame = producer.acquire(2048);
+    REQUIRE(otherFrame != nullptr);
+    CHECK_NE(std::get<0>(otherFrame->getHandle()), std::get<0>(handle));
+
+    // All slots are in use
+    CHECK_EQ(producer.acquire(16), nullptr);
+
+    // Once released, the first slot is claimed again and the old handle becomes invalid
+    mappedFrame.reset();
+    otherFrame.reset();
+    frame = producer.acquire(4096);
+    REQUIRE(frame != nullptr);
+    CHECK_EQ(consumer.map(handle), nullptr);
+
+    auto newMappedFrame = consumer.map(frame->getHandle());
+    REQUIRE(newMappedFrame != nullptr);
+    CHECK_EQ(newMappedFrame->size(), 4096);
+}
+
+/*************/
+TEST_CASE("Testing FramePool slots held by a dead process")
+{
+    const auto poolName = "splash_test_" + std::to_string(getpid()) + "_dead";
+    FramePool producer(poolName, 1);
+
+    auto frame = producer.acquire(1024);
+    REQUIRE(frame != nullptr);
+    const auto handle = frame->getHandle();
+
+    // The child maps the frame and exits without releasing it
+    const auto pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0)
+    {
+        FramePool consumer;
+        auto mappedFrame = consumer.map(handle);
+        _exit(mappedFrame != nullptr ? 0 : 1);
+    }
+
+    int status = 0;
+    REQUIRE_EQ(waitpid(pid, &status, 0), pid);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE_EQ(WEXITSTATUS(status), 0);
+
+    // The slot is claimed again once the local frame is released
+    frame.reset();
+    frame = producer.acquire(1024);
+    REQUIRE(frame != nullptr);
+    CHECK_EQ(std::get<0>(frame->getHandle()), std::get<0>(handle));
+    CHECK_NE(std::get<1>(frame->getHandle()), std::get<1>(handle));
+}
+
+/*************/
+TEST_CASE("Testing ImageBuffer held by a FramePool frame")
+{
+    const auto poolName = "splash_test_" + std::to_string(getpid()) + "_image";
+    FramePool pool(poolName, 1);
+
+    auto spec = ImageBufferSpec(64, 32, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+    auto frame = pool.acquire(spec.rawSize());
+    REQUIRE(frame != nullptr);
+
+    ImageBuffer image(spec, frame);
+    CHECK_EQ(image.getFrame(), frame);
+    CHECK_EQ(image.data(), frame->data());
+    CHECK_EQ(image.getSize(), static_cast<size_t>(spec.rawSize()));
+
+    image.zero();
+    CHECK_EQ(image.data()[0], 0);
+
+    // Copies do not alias the frame
+    image.data()[0] = 42;
+    ImageBuffer otherImage = image;
+    CHECK_EQ(otherImage.getFrame(), nullptr);
+    CHECK_NE(otherImage.data(), image.data());
+    CHECK_EQ(otherImage.getSize(), static_cast<size_t>(spec.rawSize()));
+    CHECK_EQ(otherImage.data()[0], 42);
+
+    // Setting a raw buffer releases the frame
+    otherImage.setRawBuffer(ResizableArray<uint8_t>(spec.rawSize()));
+    CHECK_EQ(otherImage.getFrame(), nullptr);
+    CHECK_NE(otherImage.data(), image.data());
+}
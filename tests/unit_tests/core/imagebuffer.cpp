@@ -36,6 +36,18 @@ TEST_CASE("Testing ImageBufferSpec comparison")
     CHECK_NE(spec, otherSpec);
 }
 
+/*************/
+TEST_CASE("Testing ImageBufferSpec raw size")
+{
+    auto spec = ImageBufferSpec(512, 256, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+    CHECK_EQ(spec.rawSize(), 512 * 256 * 4);
+    spec = ImageBufferSpec(512, 256, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
+    CHECK_EQ(spec.rawSize(), 512 * 256 * 2);
+    // Planar 4:2:0 formats take less than a byte per pixel
+    spec = ImageBufferSpec(512, 256, 3, 12, ImageBufferSpec::Type::UINT8, "YUV420P");
+    CHECK_EQ(spec.rawSize(), 512 * 256 * 3 / 2);
+}
+
 /*************/
 TEST_CASE("Testing ImageBufferSpec serialization")
 {
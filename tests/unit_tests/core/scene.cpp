@@ -3,6 +3,8 @@
 #include <thread>
 
 #include "./core/scene.h"
+#include "./graphics/gl_window.h"
+#include "./graphics/shader.h"
 
 using namespace Splash;
 using namespace std::chrono;
@@ -18,3 +20,56 @@ TEST_CASE("Testing creating a Scene")
     scene.setAttribute("quit", {});
     sceneThread.join();
 }
+
+/*************/
+TEST_CASE("Testing the disposal of objects rendered by a Scene")
+{
+    auto context = RootObject::Context();
+    context.unitTest = true;
+    Scene scene(context);
+    auto sceneThread = std::thread([&]() { scene.run(); });
+    scene.setAttribute("start", {});
+
+    // Let the object be part of the render lists for a few frames before disposing of it
+    CHECK_FALSE(scene.createObject("image", "image_to_dispose").expired());
+    std::this_thread::sleep_for(500ms);
+    CHECK(scene.getObject("image_to_dispose") != nullptr);
+
+    scene.disposeObject("image_to_dispose");
+    std::this_thread::sleep_for(500ms);
+    CHECK(scene.getObject("image_to_dispose") == nullptr);
+
+    scene.setAttribute("quit", {});
+    sceneThread.join();
+}
+
+/*************/
+TEST_CASE("Testing linking a shader with a uniform block")
+{
+    auto context = RootObject::Context();
+    context.unitTest = true;
+    Scene scene(context);
+    auto window = scene.getNewSharedWindow("shader_test");
+    REQUIRE(window != nullptr);
+    window->setAsCurrentContext();
+
+    {
+        // Uniform block bindings are set while linking, which must not lock up
+        Shader shader;
+        CHECK(shader.setSource({{Shader::fragment, R"(
+            #version 450 core
+            layout(std140) uniform _testUniforms
+            {
+                vec4 _testColor;
+            };
+            out vec4 fragColor;
+            void main()
+            {
+                fragColor = _testColor;
+            }
+        )"}}));
+        CHECK_EQ(shader.getUniforms().count("_testUniforms"), 1);
+    }
+
+    window->releaseContext();
+}
@@ -15,6 +15,7 @@
  * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <vector>
 
 #include <doctest.h>
@@ -54,4 +55,27 @@ TEST_CASE("Testing Mesh serialization")
     CHECK_EQ(container.uvs, deserializedMesh.uvs);
     CHECK_EQ(container.normals, deserializedMesh.normals);
     CHECK_EQ(container.annexe, deserializedMesh.annexe);
+    CHECK_EQ(container.indices, deserializedMesh.indices);
+}
+
+/*************/
+TEST_CASE("Testing Mesh vertex deduplication")
+{
+    MeshMockup mesh;
+    mesh.read(Utils::getCurrentWorkingDirectory() + "/data/cubes.obj");
+    auto container = mesh.getContainer();
+
+    // The file holds 72 quads, each one being split in two triangles
+    CHECK_EQ(container.indices.size(), 72 * 2 * 3);
+    CHECK(container.vertices.size() < container.indices.size());
+    CHECK_EQ(container.uvs.size(), container.vertices.size());
+    CHECK_EQ(container.normals.size(), container.vertices.size());
+
+    std::vector<bool> isUsed(container.vertices.size(), false);
+    for (const auto index : container.indices)
+    {
+        REQUIRE(index < container.vertices.size());
+        isUsed[index] = true;
+    }
+    CHECK(std::all_of(isUsed.cbegin(), isUsed.cend(), [](auto used) { return used; }));
 }
@@ -8,6 +8,7 @@
 
 #include "./core/serializer.h"
 #include "./utils/log.h"
+#include "./utils/resizable_array.h"
 
 namespace chrono = std::chrono;
 using namespace Splash;
@@ -120,6 +121,55 @@ TEST_CASE("Testing serialization of iterable containers")
     }
 }
 
+/*************/
+TEST_CASE("Testing bulk serialization of contiguous containers")
+{
+    static_assert(Serial::detail::isBulkSerializable<std::vector<float>>::value);
+    static_assert(Serial::detail::isBulkSerializable<ResizableArray<uint8_t>>::value);
+    static_assert(!Serial::detail::isBulkSerializable<std::deque<float>>::value);
+    static_assert(!Serial::detail::isBulkSerializable<std::vector<std::string>>::value);
+    static_assert(!Serial::detail::isBulkSerializable<std::string>::value);
+
+    {
+        std::vector<uint8_t> buffer;
+        std::vector<double> data(1024);
+        for (uint32_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<double>(i) / 3.0;
+        Serial::serialize(data, buffer);
+        CHECK_EQ(buffer.size(), Serial::getSize(data));
+        CHECK_EQ(buffer.size(), sizeof(uint32_t) + data.size() * sizeof(double));
+        CHECK(Serial::deserialize<std::vector<double>>(buffer) == data);
+    }
+
+    {
+        std::vector<uint8_t> buffer;
+        ResizableArray<uint16_t> data(512);
+        for (uint32_t i = 0; i < data.size(); ++i)
+            data[i] = i * 7;
+        Serial::serialize(data, buffer);
+        CHECK_EQ(buffer.size(), Serial::getSize(data));
+        const auto outData = Serial::deserialize<ResizableArray<uint16_t>>(buffer);
+        REQUIRE_EQ(outData.size(), data.size());
+        CHECK(std::equal(data.data(), data.data() + data.size(), outData.data()));
+    }
+
+    {
+        std::vector<uint8_t> buffer;
+        std::vector<int> data{};
+        Serial::serialize(data, buffer);
+        CHECK_EQ(buffer.size(), sizeof(uint32_t));
+        CHECK(Serial::deserialize<std::vector<int>>(buffer).empty());
+    }
+
+    {
+        std::vector<uint8_t> buffer;
+        std::vector<std::vector<int>> data{{1, 2, 3}, {}, {5, 8}};
+        Serial::serialize(data, buffer);
+        CHECK_EQ(buffer.size(), Serial::getSize(data));
+        CHECK(Serial::deserialize<std::vector<std::vector<int>>>(buffer) == data);
+    }
+}
+
 /*************/
 TEST_CASE("Testing serialization of tuples")
 {
@@ -193,3 +243,31 @@ TEST_CASE("Testing deserialization")
         CHECK(std::get<2>(data) == std::get<2>(outData));
     }
 }
+
+/*************/
+TEST_CASE("Testing serialization to and from spans")
+{
+    const std::string name{"Don't panic"};
+    const std::vector<float> payload{1.f, 2.f, 3.f, 4.f};
+    const auto size = Serial::getSize(name) + Serial::getSize(payload);
+
+    ResizableArray<uint8_t> buffer(size);
+    Span<uint8_t> output(buffer);
+    CHECK(Serial::serializeTo(name, output));
+    CHECK_EQ(output.size(), Serial::getSize(payload));
+    CHECK(Serial::serializeTo(payload, output));
+    CHECK(output.empty());
+
+    // Nothing is written if the span is too small
+    CHECK_FALSE(Serial::serializeTo(payload, output));
+
+    Span<const uint8_t> input(buffer);
+    CHECK_EQ(Serial::deserializeFrom<std::string>(input), name);
+    CHECK_EQ(Serial::deserializeFrom<std::vector<float>>(input), payload);
+    CHECK(input.empty());
+
+    // A span over raw data is serialized as the corresponding vector
+    std::vector<uint8_t> spanBuffer;
+    Serial::serialize(Span<const float>(payload.data(), payload.size()), spanBuffer);
+    CHECK_EQ(Serial::deserialize<std::vector<float>>(spanBuffer), payload);
+}
@@ -291,3 +291,45 @@ TEST_CASE("Testing RootHandle")
     }
     CHECK(main.hasBranchAt("/first_branch"));
 }
+
+/*************/
+TEST_CASE("Testing LeafHandle")
+{
+    Tree::Root tree;
+    tree.createLeafAt("/branch/leaf", {42});
+
+    Tree::LeafHandle handle("/branch/leaf");
+    Value value;
+    CHECK(tree.hasLeaf(handle));
+    CHECK(tree.getValueForLeaf(handle, value));
+    CHECK(value == Values({42}));
+
+    CHECK(tree.setValueForLeaf(handle, Values({"forty two"})));
+    CHECK(tree.getValueForLeafAt("/branch/leaf", value));
+    CHECK(value == Values({"forty two"}));
+
+    // Changes done through a handle are synchronized like any other
+    Tree::Root otherTree;
+    otherTree.createLeafAt("/branch/leaf");
+    otherTree.addSeedsToQueue(tree.getUpdateSeedList());
+    otherTree.processQueue();
+    CHECK(otherTree.getValueForLeafAt("/branch/leaf", value));
+    CHECK(value == Values({"forty two"}));
+
+    // The handle follows the changes of structure
+    CHECK(tree.renameLeafAt("/branch/leaf", "other_leaf"));
+    CHECK(!tree.hasLeaf(handle));
+    CHECK(!tree.getValueForLeaf(handle, value));
+    CHECK(!tree.setValueForLeaf(handle, Values({0})));
+
+    CHECK(tree.createLeafAt("/branch/leaf", {1}));
+    CHECK(tree.getValueForLeaf(handle, value));
+    CHECK(value == Values({1}));
+
+    CHECK(tree.removeBranchAt("/branch"));
+    CHECK(!tree.hasLeaf(handle));
+
+    // A handle can be used with multiple trees
+    CHECK(otherTree.getValueForLeaf(handle, value));
+    CHECK(value == Values({"forty two"}));
+}
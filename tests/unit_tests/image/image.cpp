@@ -96,3 +96,30 @@ TEST_CASE("Testing Image read/write")
         CHECK_EQ(otherImage.get().getSize(), imageSize);
     }
 }
+
+/*************/
+TEST_CASE("Testing Image serialization")
+{
+    auto root = RootObject();
+    auto image = Image(&root);
+    auto spec = ImageBufferSpec(16, 8, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+    auto buffer = ImageBuffer(spec);
+    for (size_t i = 0; i < buffer.getSize(); ++i)
+        buffer.data()[i] = static_cast<uint8_t>(i);
+    image.set(buffer);
+    image.update();
+
+    // The first image is sent as raw data, whatever its size
+    auto otherImage = Image(&root);
+    REQUIRE(otherImage.deserialize(image.serialize()));
+    otherImage.update();
+    const auto otherBuffer = otherImage.get();
+    REQUIRE_EQ(otherBuffer.getSize(), buffer.getSize());
+    CHECK_EQ(otherBuffer.getSpec().width, spec.width);
+    CHECK_EQ(otherBuffer.getSpec().height, spec.height);
+    CHECK(std::equal(buffer.data(), buffer.data() + buffer.getSize(), otherBuffer.data()));
+
+    // Invalid payloads are rejected
+    auto serializedImage = image.serialize();
+    CHECK_FALSE(otherImage.deserialize(SerializedObject(serializedImage.data(), serializedImage.data() + serializedImage.size() - 1)));
+}
@@ -0,0 +1,86 @@
+#include <doctest.h>
+
+#include <cmath>
+
+#include "./mesh/bezier_evaluator.h"
+
+using namespace Splash;
+
+namespace
+{
+// Direct evaluation of a Bezier patch point
+glm::vec2 evaluateBezier(const glm::ivec2& size, const std::vector<glm::vec2>& controlPoints, float s, float t)
+{
+    const auto bernstein = [](int n, int i, float x) {
+        double coeff = 1.0;
+        for (int k = 1; k <= i; ++k)
+            coeff = coeff * (n - k + 1) / k;
+        return static_cast<float>(coeff * std::pow(x, i) * std::pow(1.0 - x, n - i));
+    };
+
+    glm::vec2 point{0.f, 0.f};
+    for (int j = 0; j < size.y; ++j)
+        for (int i = 0; i < size.x; ++i)
+            point += bernstein(size.x - 1, i, s) * bernstein(size.y - 1, j, t) * controlPoints[i + j * size.x];
+    return point;
+}
+
+bool isClose(const glm::vec2& a, const glm::vec2& b)
+{
+    return std::abs(a.x - b.x) < 1e-5f && std::abs(a.y - b.y) < 1e-5f;
+}
+} // namespace
+
+/*************/
+TEST_CASE("Testing BezierEvaluator")
+{
+    const glm::ivec2 size(4, 3);
+    std::vector<glm::vec2> controlPoints;
+    for (int j = 0; j < size.y; ++j)
+        for (int i = 0; i < size.x; ++i)
+            controlPoints.emplace_back(static_cast<float>(i) / 3.f + 0.1f * static_cast<float>(j), static_cast<float>(j) / 2.f - 0.05f * static_cast<float>(i * i));
+
+    const int resolution = 13;
+    BezierEvaluator evaluator;
+    CHECK_FALSE(evaluator.evaluate(size, std::vector<glm::vec2>(3), resolution));
+    CHECK_FALSE(evaluator.evaluate(size, controlPoints, resolution));
+    CHECK_EQ(evaluator.getResolution(), resolution);
+
+    for (int v = 0; v < resolution; ++v)
+    {
+        for (int u = 0; u < resolution; ++u)
+        {
+            const auto s = static_cast<float>(u) / static_cast<float>(resolution - 1);
+            const auto t = static_cast<float>(v) / static_cast<float>(resolution - 1);
+            REQUIRE(isClose(evaluator.getVertex(u, v), evaluateBezier(size, controlPoints, s, t)));
+        }
+    }
+
+    // The corners are interpolated
+    CHECK(isClose(evaluator.getVertex(0, 0), controlPoints.front()));
+    CHECK(isClose(evaluator.getVertex(resolution - 1, resolution - 1), controlPoints.back()));
+
+    std::vector<glm::vec4> vertices;
+    evaluator.getVertices(vertices);
+    REQUIRE_EQ(vertices.size(), resolution * resolution);
+    CHECK_EQ(vertices[5 + 7 * resolution], glm::vec4(evaluator.getVertex(5, 7).x, evaluator.getVertex(5, 7).y, 0.f, 1.f));
+
+    // Moving a single control point updates the patch incrementally
+    controlPoints[5] += glm::vec2(0.3f, -0.2f);
+    CHECK(evaluator.evaluate(size, controlPoints, resolution));
+
+    BezierEvaluator reference;
+    reference.evaluate(size, controlPoints, resolution);
+    for (int v = 0; v < resolution; ++v)
+        for (int u = 0; u < resolution; ++u)
+            REQUIRE(isClose(evaluator.getVertex(u, v), reference.getVertex(u, v)));
+
+    // Moving all of them does not
+    for (auto& point : controlPoints)
+        point *= 2.f;
+    CHECK_FALSE(evaluator.evaluate(size, controlPoints, resolution));
+
+    // Neither does changing the resolution
+    CHECK_FALSE(evaluator.evaluate(size, controlPoints, 7));
+    CHECK_EQ(evaluator.getResolution(), 7);
+}
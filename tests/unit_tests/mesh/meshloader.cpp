@@ -0,0 +1,120 @@
+#include <doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+#include "./mesh/meshloader.h"
+#include "./utils/osutils.h"
+
+using namespace Splash;
+
+namespace
+{
+std::string writeFile(const std::string& name, const std::string& content)
+{
+    const auto path = std::filesystem::temp_directory_path() / ("splash_test_" + std::to_string(getpid()) + "_" + name);
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    file << content;
+    return path.string();
+}
+} // namespace
+
+/*************/
+TEST_CASE("Testing OBJ parsing")
+{
+    Loader::Obj loader(false);
+    CHECK_FALSE(loader.load("/nonexistent/file.obj"));
+
+    // All face vertex definitions, a quad, a relative index and a trailing slash
+    const auto path = writeFile("parsing.obj",
+        "# comment\n"
+        "o object\n"
+        "v 0.0 0.0 0.0\n"
+        "v 1.0 0.0 0.0\n"
+        "v  1.0 1.0 0.0 \r\n"
+        "v 0.0 1.0 0.0 2.0\n"
+        "vt 0.0 0.0\n"
+        "vt 1.0 1.0\n"
+        "vn 0.0 0.0 1.0\n"
+        "f 1/1/1 2/2/1 3/1/1 4/2/1\n"
+        "f 1//1 2//1 3//1\n"
+        "f 1/1 2/2 3/1/\n"
+        "f -4 -3 -2\n");
+    REQUIRE(loader.load(path));
+    CHECK_FALSE(loader.isLoadedFromCache());
+
+    const auto vertices = loader.getVertices();
+    const auto indices = loader.getIndices();
+    CHECK_EQ(indices.size(), 5 * 3);
+    CHECK_EQ(loader.getUVs().size(), vertices.size());
+    CHECK_EQ(loader.getNormals().size(), vertices.size());
+    for (const auto index : indices)
+        REQUIRE(index < vertices.size());
+
+    // The quad vertices are shared by its two triangles
+    CHECK_EQ(indices[0], indices[5]);
+    CHECK_EQ(indices[2], indices[3]);
+    CHECK_EQ(vertices[indices[2]], glm::vec4(1.f, 1.f, 0.f, 1.f));
+    CHECK_EQ(vertices[indices[4]], glm::vec4(0.f, 1.f, 0.f, 2.f));
+
+    // The relative indices refer to the same vertices as the first face
+    CHECK_EQ(vertices[indices[12]], vertices[indices[0]]);
+    CHECK_EQ(vertices[indices[14]], vertices[indices[2]]);
+
+    // A face refering to an undefined vertex makes the load fail
+    const auto invalidPath = writeFile("invalid.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n");
+    CHECK_FALSE(loader.load(invalidPath));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(invalidPath);
+}
+
+/*************/
+TEST_CASE("Testing OBJ binary cache")
+{
+    // Generate a grid large enough to be cached
+    const int size = 200;
+    std::string content;
+    for (int v = 0; v < size; ++v)
+        for (int u = 0; u < size; ++u)
+            content += "v " + std::to_string(u) + " " + std::to_string(v) + " 0.0\nvt " + std::to_string(u / float(size)) + " " + std::to_string(v / float(size)) + "\n";
+    for (int v = 0; v < size - 1; ++v)
+    {
+        for (int u = 0; u < size - 1; ++u)
+        {
+            const auto index = std::to_string(u + v * size + 1);
+            const auto next = std::to_string(u + v * size + 2);
+            const auto below = std::to_string(u + (v + 1) * size + 1);
+            const auto belowNext = std::to_string(u + (v + 1) * size + 2);
+            content += "f " + index + "/" + index + " " + next + "/" + next + " " + belowNext + "/" + belowNext + " " + below + "/" + below + "\n";
+        }
+    }
+    REQUIRE(content.size() >= Loader::Obj::CACHE_MIN_FILE_SIZE);
+
+    const auto path = writeFile("cache.obj", content);
+    const auto cachePath = path + Loader::Obj::CACHE_EXTENSION;
+    std::filesystem::remove(cachePath);
+
+    Loader::Obj loader;
+    REQUIRE(loader.load(path));
+    CHECK_FALSE(loader.isLoadedFromCache());
+    CHECK(std::filesystem::exists(cachePath));
+
+    Loader::Obj cachedLoader;
+    REQUIRE(cachedLoader.load(path));
+    CHECK(cachedLoader.isLoadedFromCache());
+    CHECK_EQ(cachedLoader.getVertices(), loader.getVertices());
+    CHECK_EQ(cachedLoader.getUVs(), loader.getUVs());
+    CHECK_EQ(cachedLoader.getNormals(), loader.getNormals());
+    CHECK_EQ(cachedLoader.getIndices(), loader.getIndices());
+
+    // Modifying the source invalidates the cache
+    writeFile("cache.obj", content + "v 0 0 0\n");
+    REQUIRE(cachedLoader.load(path));
+    CHECK_FALSE(cachedLoader.isLoadedFromCache());
+    CHECK_EQ(cachedLoader.getIndices(), loader.getIndices());
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(cachePath);
+}
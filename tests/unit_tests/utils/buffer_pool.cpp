@@ -0,0 +1,118 @@
+#include <doctest.h>
+
+#include <cstring>
+
+#include "./utils/buffer_pool.h"
+#include "./utils/resizable_array.h"
+
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing BufferPool reuse")
+{
+    auto& pool = BufferPool::get();
+    const size_t size = 1 << 20;
+
+    auto buffer = pool.allocate(size);
+    REQUIRE(buffer != nullptr);
+    memset(buffer, 42, size);
+    pool.deallocate(buffer, size);
+
+    // A buffer from the same bucket is reused
+    const auto allocationCount = pool.getSystemAllocationCount();
+    const auto reuseCount = pool.getReuseCount();
+    auto otherBuffer = pool.allocate(size - 16);
+    CHECK_EQ(otherBuffer, buffer);
+    CHECK_EQ(pool.getSystemAllocationCount(), allocationCount);
+    CHECK_EQ(pool.getReuseCount(), reuseCount + 1);
+    pool.deallocate(otherBuffer, size - 16);
+
+    // A different size leads to a new allocation
+    auto largerBuffer = pool.allocate(size * 2);
+    CHECK_EQ(pool.getSystemAllocationCount(), allocationCount + 1);
+    pool.deallocate(largerBuffer, size * 2);
+
+    // Small buffers are not pooled
+    auto smallBuffer = pool.allocate(16);
+    CHECK_EQ(pool.getSystemAllocationCount(), allocationCount + 1);
+    pool.deallocate(smallBuffer, 16);
+
+    pool.clear();
+}
+
+/*************/
+TEST_CASE("Testing BufferPool retained size limit")
+{
+    auto& pool = BufferPool::get();
+    const size_t size = 1 << 20;
+
+    pool.clear();
+    pool.setMaxRetainedSize(size);
+    auto buffer = pool.allocate(size);
+    auto otherBuffer = pool.allocate(size);
+    pool.deallocate(buffer, size);
+    pool.deallocate(otherBuffer, size);
+
+    // Only one of the two buffers has been kept
+    const auto allocationCount = pool.getSystemAllocationCount();
+    auto firstBuffer = pool.allocate(size);
+    auto secondBuffer = pool.allocate(size);
+    CHECK_EQ(pool.getSystemAllocationCount(), allocationCount + 1);
+    pool.deallocate(firstBuffer, size);
+    pool.deallocate(secondBuffer, size);
+
+    pool.setMaxRetainedSize(BufferPool::DEFAULT_MAX_RETAINED);
+    pool.clear();
+}
+
+/*************/
+TEST_CASE("Testing BufferPool idle buckets trimming")
+{
+    auto& pool = BufferPool::get();
+    const size_t size = 1 << 20;
+
+    pool.clear();
+    auto buffer = pool.allocate(size);
+    pool.deallocate(buffer, size);
+    CHECK_EQ(pool.getRetainedSize(), size);
+
+    // The bucket has just been used
+    pool.trim(std::chrono::seconds(1));
+    CHECK_EQ(pool.getRetainedSize(), size);
+
+    pool.trim(std::chrono::seconds(0));
+    CHECK_EQ(pool.getRetainedSize(), 0);
+
+    // Trimming happens when releasing buffers, once the idle duration has elapsed
+    pool.setMaxIdle(std::chrono::seconds(0));
+    buffer = pool.allocate(size);
+    auto otherBuffer = pool.allocate(size * 2);
+    pool.deallocate(buffer, size);
+    pool.deallocate(otherBuffer, size * 2);
+    CHECK_EQ(pool.getRetainedSize(), size * 2);
+
+    pool.setMaxIdle(BufferPool::DEFAULT_MAX_IDLE);
+    pool.clear();
+    CHECK_EQ(pool.getRetainedSize(), 0);
+}
+
+/*************/
+TEST_CASE("Testing ResizableArray with the pooled allocator")
+{
+    const size_t size = 1 << 20;
+    const auto allocationCount = BufferPool::get().getSystemAllocationCount();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ResizableArray<uint8_t> array(size);
+        CHECK_EQ(array.size(), size);
+        memset(array.data(), i, array.size());
+    }
+    CHECK_EQ(BufferPool::get().getSystemAllocationCount(), allocationCount + 1);
+
+    // The standard allocator can still be used, and value-initializes the content
+    ResizableArray<uint8_t, std::allocator<uint8_t>> zeroedArray(size);
+    CHECK_EQ(zeroedArray[size / 2], 0);
+
+    BufferPool::get().clear();
+}
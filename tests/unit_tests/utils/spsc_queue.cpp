@@ -0,0 +1,130 @@
+#include <doctest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "./utils/spsc_queue.h"
+
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing SpscQueue push and pop")
+{
+    SpscQueue<std::unique_ptr<int>> queue(4);
+    CHECK_EQ(queue.front(), nullptr);
+    CHECK_FALSE(queue.waitNotEmpty(std::chrono::milliseconds(1)));
+
+    for (int i = 0; i < 4; ++i)
+        CHECK(queue.tryPush(std::make_unique<int>(i)));
+    auto value = std::make_unique<int>(4);
+    CHECK_FALSE(queue.tryPush(std::move(value)));
+    CHECK(value != nullptr);
+    CHECK_EQ(queue.size(), 4);
+    CHECK(queue.isFull());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        auto front = queue.front();
+        REQUIRE(front != nullptr);
+        CHECK_EQ(**front, i);
+        queue.pop();
+    }
+    CHECK_EQ(queue.front(), nullptr);
+    CHECK_EQ(queue.size(), 0);
+    CHECK(queue.waitEmpty(std::chrono::milliseconds(1)));
+}
+
+/*************/
+TEST_CASE("Testing SpscQueue depth and weight")
+{
+    SpscQueue<int> queue(8);
+    queue.setMaxDepth(2);
+    CHECK(queue.tryPush(0));
+    CHECK_FALSE(queue.isFull());
+    CHECK(queue.tryPush(1));
+    CHECK(queue.isFull());
+    CHECK_FALSE(queue.waitNotFull(std::chrono::milliseconds(1)));
+
+    // The depth limit does not prevent pushing
+    CHECK(queue.tryPush(2));
+    queue.pop();
+    queue.pop();
+    queue.pop();
+
+    queue.setMaxDepth(8, 100);
+    CHECK(queue.tryPush(0, 60));
+    CHECK_FALSE(queue.isFull());
+    CHECK(queue.tryPush(1, 60));
+    CHECK_EQ(queue.weight(), 120);
+    CHECK(queue.isFull());
+    queue.pop();
+    CHECK_EQ(queue.weight(), 60);
+    CHECK_FALSE(queue.isFull());
+}
+
+/*************/
+TEST_CASE("Testing SpscQueue clear")
+{
+    SpscQueue<int> queue(8);
+    for (int i = 0; i < 3; ++i)
+        queue.tryPush(std::move(i));
+    queue.clear();
+    queue.tryPush(42);
+
+    auto front = queue.front();
+    REQUIRE(front != nullptr);
+    CHECK_EQ(*front, 42);
+    CHECK_EQ(queue.size(), 1);
+
+    // Clearing a full queue must let the producer push again once the consumer waits
+    SpscQueue<int> fullQueue(4);
+    for (int i = 0; i < 4; ++i)
+        fullQueue.tryPush(std::move(i));
+    CHECK(fullQueue.isFull());
+    CHECK_FALSE(fullQueue.tryPush(4));
+
+    fullQueue.clear();
+    CHECK_EQ(fullQueue.size(), 0);
+    CHECK_FALSE(fullQueue.isFull());
+    CHECK(fullQueue.waitNotFull(std::chrono::milliseconds(1)));
+    CHECK_FALSE(fullQueue.waitNotEmpty(std::chrono::milliseconds(1)));
+    CHECK_EQ(fullQueue.weight(), 0);
+
+    for (int i = 0; i < 4; ++i)
+        CHECK(fullQueue.tryPush(10 + i));
+    CHECK(fullQueue.waitNotEmpty(std::chrono::milliseconds(1)));
+    REQUIRE(fullQueue.front() != nullptr);
+    CHECK_EQ(*fullQueue.front(), 10);
+}
+
+/*************/
+TEST_CASE("Testing SpscQueue between two threads")
+{
+    const int count = 100000;
+    SpscQueue<int> queue(16);
+    queue.setMaxDepth(8);
+
+    std::thread producer([&]() {
+        for (int i = 0; i < count; ++i)
+        {
+            while (!queue.waitNotFull(std::chrono::milliseconds(100)))
+                ;
+            queue.tryPush(std::move(i));
+        }
+    });
+
+    bool inOrder = true;
+    for (int i = 0; i < count; ++i)
+    {
+        while (!queue.waitNotEmpty(std::chrono::milliseconds(100)))
+            ;
+        inOrder = inOrder && *queue.front() == i;
+        queue.pop();
+    }
+    producer.join();
+
+    CHECK(inOrder);
+    CHECK(queue.waitEmpty(std::chrono::milliseconds(1)));
+    CHECK_EQ(queue.size(), 0);
+}
@@ -0,0 +1,128 @@
+#include <doctest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "./utils/thread_pool.h"
+
+using namespace Splash;
+using namespace std::chrono_literals;
+
+/*************/
+TEST_CASE("Testing ThreadPool tasks")
+{
+    ThreadPool pool(2);
+    CHECK_EQ(pool.getWorkerCount(), 2);
+
+    auto result = pool.submit([]() { return 42; });
+    CHECK_EQ(result.get(), 42);
+
+    // Tasks submitted by other tasks, waited for from within the pool
+    auto nested = pool.submit([&]() {
+        std::vector<std::future<int>> futures;
+        for (int i = 0; i < 16; ++i)
+            futures.push_back(pool.submit([i]() { return i; }, ThreadPool::Priority::High));
+
+        int sum = 0;
+        for (auto& future : futures)
+        {
+            pool.wait(future);
+            sum += future.get();
+        }
+        return sum;
+    });
+    CHECK_EQ(nested.get(), 120);
+
+    // Tasks waiting for each other do not deadlock the pool, even with more tasks than workers
+    std::atomic_int counter{0};
+    std::vector<std::future<void>> waiters;
+    for (int i = 0; i < 8; ++i)
+    {
+        waiters.push_back(pool.submit([&]() {
+            auto inner = pool.submit([&]() { ++counter; });
+            pool.wait(inner);
+        }));
+    }
+    for (auto& waiter : waiters)
+        pool.wait(waiter);
+    CHECK_EQ(counter.load(), 8);
+
+    // Exceptions are forwarded to the future
+    auto throwing = pool.submit([]() -> int { throw std::runtime_error("error"); });
+    CHECK_THROWS(throwing.get());
+
+    const auto stats = pool.getStats();
+    CHECK_GE(stats.executedTasks, 1 + 1 + 16 + 16 + 1);
+    CHECK_EQ(stats.workerCount, 2);
+    CHECK_EQ(pool.getStats().executedTasks, 0);
+}
+
+/*************/
+TEST_CASE("Testing ThreadPool priorities")
+{
+    ThreadPool pool(1);
+
+    // Keep the only worker busy while the tasks are queued
+    std::atomic_bool release{false};
+    auto blocker = pool.submit([&]() {
+        while (!release)
+            std::this_thread::sleep_for(1ms);
+    });
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    std::vector<std::future<void>> futures;
+    const auto record = [&](int value) {
+        return [&, value]() {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(value);
+        };
+    };
+    futures.push_back(pool.submit(record(2), ThreadPool::Priority::Low));
+    futures.push_back(pool.submit(record(1), ThreadPool::Priority::Normal));
+    futures.push_back(pool.submit(record(0), ThreadPool::Priority::High));
+
+    release = true;
+    for (auto& future : futures)
+        future.wait();
+    blocker.wait();
+
+    CHECK_EQ(order, std::vector<int>({0, 1, 2}));
+}
+
+/*************/
+TEST_CASE("Testing ThreadPool parallelFor")
+{
+    ThreadPool pool(3);
+
+    std::vector<std::atomic_int> values(1000);
+    pool.parallelFor(values.size(), [&](size_t index) { values[index] += static_cast<int>(index); });
+    for (size_t i = 0; i < values.size(); ++i)
+        REQUIRE_EQ(values[i].load(), static_cast<int>(i));
+
+    // From within the pool
+    std::atomic_int sum{0};
+    auto task = pool.submit([&]() { pool.parallelFor(100, [&](size_t index) { sum += static_cast<int>(index); }); });
+    pool.wait(task);
+    CHECK_EQ(sum.load(), 4950);
+
+    int calls = 0;
+    pool.parallelFor(0, [&](size_t) { ++calls; });
+    CHECK_EQ(calls, 0);
+
+    // Exceptions are rethrown in the calling thread, once all indices have been run
+    std::atomic_int runCount{0};
+    const auto throwing = [&](size_t index) {
+        ++runCount;
+        if (index % 10 == 0)
+            throw std::runtime_error("error");
+    };
+    CHECK_THROWS(pool.parallelFor(100, throwing));
+    CHECK_EQ(runCount.load(), 100);
+
+    // The pool is still usable afterwards
+    std::atomic_int afterCount{0};
+    pool.parallelFor(100, [&](size_t) { ++afterCount; });
+    CHECK_EQ(afterCount.load(), 100);
+}